@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "jni.h"
+
+#include "base/logging.h"
+#include "gc/space/large_object_space.h"
+#include "thread.h"
+
+namespace art {
+namespace {
+
+static constexpr size_t kNumLiveObjects = 64;
+static constexpr size_t kMinAllocationSize = 12 * KB;
+static constexpr size_t kMaxAllocationSize = 1 * MB;
+static constexpr size_t kFreeListSpaceCapacity = 128 * MB;
+
+// A large object space private to the benchmark, with a fixed number of live objects that get
+// replaced by objects of a random size. The space is kept across calls, so that its free blocks
+// are fragmented like those of a long running app. It is never deleted, as the runtime may be
+// gone by the time static destructors run.
+class LargeObjectChurn {
+ public:
+  explicit LargeObjectChurn(gc::space::LargeObjectSpace* space)
+      : space_(space), objects_(kNumLiveObjects, nullptr), rand_seed_(0) {
+    CHECK(space_ != nullptr);
+  }
+
+  void Replace(size_t reps) {
+    Thread* self = Thread::Current();
+    for (size_t i = 0; i < reps; ++i) {
+      mirror::Object*& obj = objects_[NextRandom() % kNumLiveObjects];
+      if (obj != nullptr) {
+        space_->Free(self, obj);
+      }
+      size_t request_size =
+          kMinAllocationSize + NextRandom() % (kMaxAllocationSize - kMinAllocationSize);
+      size_t allocation_size;
+      size_t bytes_tl_bulk_allocated;
+      obj = space_->Alloc(self, request_size, &allocation_size, nullptr, &bytes_tl_bulk_allocated);
+      CHECK(obj != nullptr);
+    }
+  }
+
+ private:
+  size_t NextRandom() {
+    rand_seed_ = rand_seed_ * 1103515245 + 12345;
+    return rand_seed_;
+  }
+
+  gc::space::LargeObjectSpace* const space_;
+  std::vector<mirror::Object*> objects_;
+  size_t rand_seed_;
+};
+
+extern "C" JNIEXPORT void JNICALL Java_LargeObjectSpaceBenchmark_timeFreeListSpaceChurn(
+    JNIEnv*, jobject, jint reps) {
+  static LargeObjectChurn* churn = new LargeObjectChurn(
+      gc::space::FreeListSpace::Create("free list space churn", nullptr, kFreeListSpaceCapacity));
+  churn->Replace(reps);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_LargeObjectSpaceBenchmark_timeLargeObjectMapSpaceChurn(
+    JNIEnv*, jobject, jint reps) {
+  static LargeObjectChurn* churn = new LargeObjectChurn(
+      gc::space::LargeObjectMapSpace::Create("large object map space churn"));
+  churn->Replace(reps);
+}
+
+}  // namespace
+}  // namespace art
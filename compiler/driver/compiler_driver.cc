@@ -1864,6 +1864,7 @@ class ParallelCompilationManager {
                              const std::vector<const DexFile*>& dex_files,
                              ThreadPool* thread_pool)
     : index_(0),
+      order_(),
       class_linker_(class_linker),
       class_loader_(class_loader),
       compiler_(compiler),
@@ -1896,25 +1897,31 @@ class ParallelCompilationManager {
 
   void ForAll(size_t begin, size_t end, CompilationVisitor* visitor, size_t work_units)
       REQUIRES(!*Locks::mutator_lock_) {
-    Thread* self = Thread::Current();
-    self->AssertNoPendingException();
-    CHECK_GT(work_units, 0U);
+    order_.clear();
+    DoForAll(begin, end, visitor, work_units);
+  }
 
-    index_.StoreRelaxed(begin);
-    for (size_t i = 0; i < work_units; ++i) {
-      thread_pool_->AddTask(self, new ForAllClosure(this, end, visitor));
+  // Visit all the class defs of the dex file. When using several workers, the classes with
+  // the most code are visited first: the cost of a class varies by orders of magnitude, and
+  // starting a large class last leaves the other workers idle until it is done.
+  void ForAllClassDefs(CompilationVisitor* visitor, size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    const DexFile& dex_file = *GetDexFile();
+    const size_t num_class_defs = dex_file.NumClassDefs();
+    order_.clear();
+    if (work_units > 1u) {
+      std::vector<uint32_t> costs(num_class_defs);
+      order_.reserve(num_class_defs);
+      for (size_t i = 0; i != num_class_defs; ++i) {
+        costs[i] = EstimateClassDefCost(dex_file, i);
+        order_.push_back(i);
+      }
+      // Use a stable sort so that the order only depends on the dex file.
+      std::stable_sort(order_.begin(),
+                       order_.end(),
+                       [&costs](uint32_t lhs, uint32_t rhs) { return costs[lhs] > costs[rhs]; });
     }
-    thread_pool_->StartWorkers(self);
-
-    // Ensure we're suspended while we're blocked waiting for the other threads to finish (worker
-    // thread destructor's called below perform join).
-    CHECK_NE(self->GetState(), kRunnable);
-
-    // Wait for all the worker threads to finish.
-    thread_pool_->Wait(self, true, false);
-
-    // And stop the workers accepting jobs.
-    thread_pool_->StopWorkers(self);
+    DoForAll(0, num_class_defs, visitor, work_units);
   }
 
   size_t NextIndex() {
@@ -1922,22 +1929,40 @@ class ParallelCompilationManager {
   }
 
  private:
+  // Statistics of one worker during a ForAll, to find load imbalance.
+  struct WorkerStats {
+    size_t visited = 0u;
+    uint64_t busy_ns = 0u;
+    uint64_t end_ns = 0u;
+  };
+
   class ForAllClosure : public Task {
    public:
-    ForAllClosure(ParallelCompilationManager* manager, size_t end, CompilationVisitor* visitor)
+    ForAllClosure(ParallelCompilationManager* manager,
+                  size_t end,
+                  CompilationVisitor* visitor,
+                  WorkerStats* stats)
         : manager_(manager),
           end_(end),
-          visitor_(visitor) {}
+          visitor_(visitor),
+          stats_(stats) {}
 
     virtual void Run(Thread* self) {
+      const uint64_t start_ns = NanoTime();
+      const std::vector<uint32_t>& order = manager_->order_;
+      size_t visited = 0u;
       while (true) {
         const size_t index = manager_->NextIndex();
         if (UNLIKELY(index >= end_)) {
           break;
         }
-        visitor_->Visit(index);
+        visitor_->Visit(order.empty() ? index : order[index]);
         self->AssertNoPendingException();
+        ++visited;
       }
+      stats_->end_ns = NanoTime();
+      stats_->busy_ns = stats_->end_ns - start_ns;
+      stats_->visited = visited;
     }
 
     virtual void Finalize() {
@@ -1948,9 +1973,77 @@ class ParallelCompilationManager {
     ParallelCompilationManager* const manager_;
     const size_t end_;
     CompilationVisitor* const visitor_;
+    WorkerStats* const stats_;
   };
 
+  void DoForAll(size_t begin, size_t end, CompilationVisitor* visitor, size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    self->AssertNoPendingException();
+    CHECK_GT(work_units, 0U);
+    DCHECK(order_.empty() || order_.size() == end - begin);
+
+    std::vector<WorkerStats> stats(work_units);
+    index_.StoreRelaxed(begin);
+    for (size_t i = 0; i < work_units; ++i) {
+      thread_pool_->AddTask(self, new ForAllClosure(this, end, visitor, &stats[i]));
+    }
+    thread_pool_->StartWorkers(self);
+
+    // Ensure we're suspended while we're blocked waiting for the other threads to finish (worker
+    // thread destructor's called below perform join).
+    CHECK_NE(self->GetState(), kRunnable);
+
+    // Wait for all the worker threads to finish.
+    thread_pool_->Wait(self, true, false);
+
+    // And stop the workers accepting jobs.
+    thread_pool_->StopWorkers(self);
+
+    if (VLOG_IS_ON(compiler) && work_units > 1u) {
+      DumpWorkerStats(stats);
+    }
+  }
+
+  // Log the time each worker spent, and how long the other workers waited for the last one.
+  static void DumpWorkerStats(const std::vector<WorkerStats>& stats) {
+    uint64_t first_end_ns = stats[0].end_ns;
+    uint64_t last_end_ns = stats[0].end_ns;
+    std::ostringstream oss;
+    for (size_t i = 0; i != stats.size(); ++i) {
+      first_end_ns = std::min(first_end_ns, stats[i].end_ns);
+      last_end_ns = std::max(last_end_ns, stats[i].end_ns);
+      oss << " " << i << ":" << stats[i].visited << "/" << PrettyDuration(stats[i].busy_ns);
+    }
+    VLOG(compiler) << "ParallelCompilationManager workers (items/busy time):" << oss.str()
+                   << ", tail " << PrettyDuration(last_end_ns - first_end_ns);
+  }
+
+  // Estimate the cost of processing a class def by the size of the code of its methods.
+  static uint32_t EstimateClassDefCost(const DexFile& dex_file, size_t class_def_index) {
+    const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+    const uint8_t* class_data = dex_file.GetClassData(class_def);
+    if (class_data == nullptr) {
+      // Empty class such as a marker interface.
+      return 0u;
+    }
+    ClassDataItemIterator it(dex_file, class_data);
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    uint32_t cost = 0u;
+    while (it.HasNextDirectMethod() || it.HasNextVirtualMethod()) {
+      const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+      // Count each method, as even methods without code need to be processed.
+      cost += 1u + ((code_item != nullptr) ? code_item->insns_size_in_code_units_ : 0u);
+      it.Next();
+    }
+    return cost;
+  }
+
   AtomicInteger index_;
+  // The order in which the indexes are visited, or empty to visit them in increasing order.
+  std::vector<uint32_t> order_;
   ClassLinker* const class_linker_;
   const jobject class_loader_;
   CompilerDriver* const compiler_;
@@ -2197,7 +2290,7 @@ void CompilerDriver::ResolveDexFile(jobject class_loader,
 
   TimingLogger::ScopedTiming t("Resolve MethodsAndFields", timings);
   ResolveClassFieldsAndMethodsVisitor visitor(&context);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  context.ForAllClassDefs(&visitor, thread_count);
 }
 
 void CompilerDriver::SetVerified(jobject class_loader,
@@ -2230,6 +2323,24 @@ void CompilerDriver::Verify(jobject class_loader,
                   parallel_thread_count_,
                   timings);
   }
+  if (VLOG_IS_ON(compiler)) {
+    // The workers are idle once verification is done, so their statistics are stable.
+    std::pair<uint64_t, uint64_t> hits_and_misses(0u, 0u);
+    MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
+    Runtime::Current()->GetThreadList()->ForEach(
+        [](Thread* thread, void* arg) {
+          verifier::ResolvedClassCache* cache =
+              thread->GetVerifierClassCache(/* create_if_needed */ false);
+          if (cache != nullptr) {
+            auto* totals = reinterpret_cast<std::pair<uint64_t, uint64_t>*>(arg);
+            totals->first += cache->GetHits();
+            totals->second += cache->GetMisses();
+          }
+        },
+        &hits_and_misses);
+    VLOG(compiler) << "Verifier resolved class cache: " << hits_and_misses.first << " hits, "
+                   << hits_and_misses.second << " misses";
+  }
 }
 
 class VerifyClassVisitor : public CompilationVisitor {
@@ -2272,6 +2383,7 @@ class VerifyClassVisitor : public CompilationVisitor {
                                                 class_loader,
                                                 &class_def,
                                                 Runtime::Current()->GetCompilerCallbacks(),
+                                                true /* can load classes */,
                                                 true /* allow soft failures */,
                                                 log_level_,
                                                 &error_msg) ==
@@ -2322,7 +2434,7 @@ void CompilerDriver::VerifyDexFile(jobject class_loader,
                               ? LogSeverity::INTERNAL_FATAL
                               : LogSeverity::WARNING;
   VerifyClassVisitor visitor(&context, log_level);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  context.ForAllClassDefs(&visitor, thread_count);
 }
 
 class SetVerifiedClassVisitor : public CompilationVisitor {
@@ -2383,7 +2495,7 @@ void CompilerDriver::SetVerifiedDexFile(jobject class_loader,
   ParallelCompilationManager context(class_linker, class_loader, this, &dex_file, dex_files,
                                      thread_pool);
   SetVerifiedClassVisitor visitor(&context);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  context.ForAllClassDefs(&visitor, thread_count);
 }
 
 class InitializeClassVisitor : public CompilationVisitor {
@@ -2505,7 +2617,7 @@ void CompilerDriver::InitializeClasses(jobject jni_class_loader,
     init_thread_count = 1U;
   }
   InitializeClassVisitor visitor(&context);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, init_thread_count);
+  context.ForAllClassDefs(&visitor, init_thread_count);
 }
 
 class InitializeArrayClassesAndCreateConflictTablesVisitor : public ClassVisitor {
@@ -2728,7 +2840,7 @@ void CompilerDriver::CompileDexFile(jobject class_loader,
   ParallelCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
                                      &dex_file, dex_files, thread_pool);
   CompileClassVisitor visitor(&context);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  context.ForAllClassDefs(&visitor, thread_count);
 }
 
 void CompilerDriver::AddCompiledMethod(const MethodReference& method_ref,
@@ -153,6 +153,11 @@ class CompilerDriver {
     return compiler_.get();
   }
 
+  // Profile used for profile guided compilation, or null.
+  const ProfileCompilationInfo* GetProfileCompilationInfo() const {
+    return profile_compilation_info_;
+  }
+
   // Are we compiling and creating an image file?
   bool IsBootImage() const {
     return boot_image_;
@@ -450,6 +450,10 @@ TEST_F(ImageTest, WriteReadLZ4HC) {
   TestWriteRead(ImageHeader::kStorageModeLZ4HC);
 }
 
+TEST_F(ImageTest, WriteReadLZ4Blocks) {
+  TestWriteRead(ImageHeader::kStorageModeLZ4Blocks);
+}
+
 TEST_F(ImageTest, TestImageLayout) {
   std::vector<size_t> image_sizes;
   std::vector<size_t> image_sizes_extra;
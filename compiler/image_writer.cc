@@ -61,7 +61,9 @@
 #include "oat_file_manager.h"
 #include "runtime.h"
 #include "scoped_thread_state_change.h"
+#include "thread_pool.h"
 #include "handle_scope-inl.h"
+#include "utils/array_ref.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 
 using ::art::mirror::Class;
@@ -181,12 +183,7 @@ bool ImageWriter::Write(int image_fd,
     }
   }
 
-  {
-    // TODO: heap validation can't handle these fix up passes.
-    ScopedObjectAccess soa(Thread::Current());
-    Runtime::Current()->GetHeap()->DisableObjectValidation();
-    CopyAndFixupObjects();
-  }
+  CopyAndFixupObjects();
 
   for (size_t i = 0; i < image_filenames.size(); ++i) {
     const char* image_filename = image_filenames[i];
@@ -253,6 +250,35 @@ bool ImageWriter::Write(int image_fd,
         break;
       }
       */
+      case ImageHeader::kStorageModeLZ4Blocks: {
+        // Compress each block independently so that the runtime can decompress them in parallel.
+        // The block index goes first, right after the header.
+        const size_t blocks_count = RoundUp(image_data_size, ImageHeader::kBlockSize) /
+            ImageHeader::kBlockSize;
+        const size_t blocks_size = blocks_count * sizeof(ImageBlock);
+        const size_t compressed_max_size =
+            blocks_size + blocks_count * LZ4_compressBound(ImageHeader::kBlockSize);
+        compressed_data.reset(new char[compressed_max_size]);
+        ImageBlock* const blocks = reinterpret_cast<ImageBlock*>(&compressed_data[0]);
+        data_size = blocks_size;
+        for (size_t i = 0; i < blocks_count; ++i) {
+          const size_t block_offset = i * ImageHeader::kBlockSize;
+          const size_t block_size =
+              std::min(ImageHeader::kBlockSize, image_data_size - block_offset);
+          const size_t block_data_size = LZ4_compress(image_data + block_offset,
+                                                      &compressed_data[data_size],
+                                                      block_size);
+          CHECK_NE(block_data_size, 0u);
+          blocks[i] = ImageBlock(sizeof(ImageHeader) + data_size,
+                                 block_data_size,
+                                 sizeof(ImageHeader) + block_offset,
+                                 block_size);
+          data_size += block_data_size;
+        }
+        image_header->blocks_offset_ = sizeof(ImageHeader);
+        image_header->blocks_count_ = blocks_count;
+        break;
+      }
       case ImageHeader::kStorageModeUncompressed: {
         data_size = image_data_size;
         image_data_to_write = image_data;
@@ -269,14 +295,26 @@ bool ImageWriter::Write(int image_fd,
       VLOG(compiler) << "Compressed from " << image_data_size << " to " << data_size << " in "
                      << PrettyDuration(NanoTime() - compress_start_time);
       if (kIsDebugBuild) {
-        std::unique_ptr<uint8_t[]> temp(new uint8_t[image_data_size]);
-        const size_t decompressed_size = LZ4_decompress_safe(
-            reinterpret_cast<char*>(&compressed_data[0]),
-            reinterpret_cast<char*>(&temp[0]),
-            data_size,
-            image_data_size);
-        CHECK_EQ(decompressed_size, image_data_size);
-        CHECK_EQ(memcmp(image_data, &temp[0], image_data_size), 0) << image_storage_mode_;
+        // Decompress as the runtime does, with the header at the start of the file and the image.
+        std::unique_ptr<uint8_t[]> temp_file(new uint8_t[sizeof(ImageHeader) + data_size]);
+        memcpy(&temp_file[sizeof(ImageHeader)], &compressed_data[0], data_size);
+        std::unique_ptr<uint8_t[]> temp(new uint8_t[sizeof(ImageHeader) + image_data_size]);
+        if (image_storage_mode_ == ImageHeader::kStorageModeLZ4Blocks) {
+          const ImageBlock* blocks = image_header->GetBlocks(&temp_file[0]);
+          for (size_t i = 0; i < image_header->GetBlocksCount(); ++i) {
+            std::string error_msg;
+            CHECK(blocks[i].Decompress(&temp[0], &temp_file[0], &error_msg)) << error_msg;
+          }
+        } else {
+          const size_t decompressed_size = LZ4_decompress_safe(
+              reinterpret_cast<char*>(&temp_file[sizeof(ImageHeader)]),
+              reinterpret_cast<char*>(&temp[sizeof(ImageHeader)]),
+              data_size,
+              image_data_size);
+          CHECK_EQ(decompressed_size, image_data_size);
+        }
+        CHECK_EQ(memcmp(image_data, &temp[sizeof(ImageHeader)], image_data_size), 0)
+            << image_storage_mode_;
       }
     }
 
@@ -1833,9 +1871,66 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
   }
 }
 
+// Copies and fixes up a range of the objects to write to the image. The objects are copied
+// to distinct locations, and the state of the writer is only read, so ranges can be processed
+// in parallel.
+class ImageWriter::CopyAndFixupObjectsTask : public Task {
+ public:
+  CopyAndFixupObjectsTask(ImageWriter* image_writer, ArrayRef<mirror::Object* const> objects)
+      : image_writer_(image_writer),
+        objects_(objects) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+    for (mirror::Object* obj : objects_) {
+      image_writer_->CopyAndFixupObject(obj);
+    }
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  ImageWriter* const image_writer_;
+  const ArrayRef<mirror::Object* const> objects_;
+
+  DISALLOW_COPY_AND_ASSIGN(CopyAndFixupObjectsTask);
+};
+
 void ImageWriter::CopyAndFixupObjects() {
-  gc::Heap* heap = Runtime::Current()->GetHeap();
-  heap->VisitObjects(CopyAndFixupObjectsCallback, this);
+  Thread* self = Thread::Current();
+  std::vector<mirror::Object*> objects;
+  {
+    // TODO: heap validation can't handle these fix up passes.
+    ScopedObjectAccess soa(self);
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->DisableObjectValidation();
+    heap->VisitObjects(CollectObjectsToCopyCallback, &objects);
+  }
+
+  // Nothing allocates from here on, so the objects do not move while we do not hold the
+  // mutator lock.
+  static constexpr size_t kObjectsPerTask = 4 * KB;
+  const size_t thread_count = compiler_driver_.GetThreadCount();
+  if (thread_count > 1u && objects.size() > kObjectsPerTask) {
+    ThreadPool thread_pool("Image writer thread pool", thread_count - 1u);
+    ArrayRef<mirror::Object* const> remaining(objects);
+    while (!remaining.empty()) {
+      const size_t count = std::min(remaining.size(), kObjectsPerTask);
+      thread_pool.AddTask(self, new CopyAndFixupObjectsTask(this, remaining.SubArray(0u, count)));
+      remaining = remaining.SubArray(count);
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+    thread_pool.StopWorkers(self);
+  } else {
+    CopyAndFixupObjectsTask task(this, ArrayRef<mirror::Object* const>(objects));
+    task.Run(self);
+  }
+
+  ScopedObjectAccess soa(self);
   // Fix up the object previously had hash codes.
   for (const auto& hash_pair : saved_hashcode_map_) {
     Object* obj = hash_pair.first;
@@ -1843,12 +1938,13 @@ void ImageWriter::CopyAndFixupObjects() {
     obj->SetLockWord<kVerifyNone>(LockWord::FromHashCode(hash_pair.second, 0U), false);
   }
   saved_hashcode_map_.clear();
+  pointer_arrays_.clear();
 }
 
-void ImageWriter::CopyAndFixupObjectsCallback(Object* obj, void* arg) {
+void ImageWriter::CollectObjectsToCopyCallback(Object* obj, void* arg) {
   DCHECK(obj != nullptr);
   DCHECK(arg != nullptr);
-  reinterpret_cast<ImageWriter*>(arg)->CopyAndFixupObject(obj);
+  reinterpret_cast<std::vector<mirror::Object*>*>(arg)->push_back(obj);
 }
 
 void ImageWriter::FixupPointerArray(mirror::Object* dst, mirror::PointerArray* arr,
@@ -1897,7 +1993,8 @@ void ImageWriter::CopyAndFixupObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  image_info.image_bitmap_->Set(dst);  // Mark the obj as live.
+  // Mark the obj as live. Objects sharing a bitmap word may be copied by other threads.
+  image_info.image_bitmap_->AtomicTestAndSet(dst);
 
   const size_t n = obj->SizeOf();
   DCHECK_LE(offset + n, image_info.image_->Size());
@@ -2050,9 +2147,8 @@ void ImageWriter::FixupObject(Object* orig, Object* copy) {
     // Is this a native pointer array?
     auto it = pointer_arrays_.find(down_cast<mirror::PointerArray*>(orig));
     if (it != pointer_arrays_.end()) {
-      // Should only need to fixup every pointer array exactly once.
+      // Every object is fixed up exactly once, so each pointer array is only fixed up once.
       FixupPointerArray(copy, down_cast<mirror::PointerArray*>(orig), klass, it->second);
-      pointer_arrays_.erase(it);
       return;
     }
   }
@@ -402,8 +402,9 @@ class ImageWriter FINAL {
 
   // Creates the contiguous image in memory and adjusts pointers.
   void CopyAndFixupNativeData(size_t oat_index) SHARED_REQUIRES(Locks::mutator_lock_);
-  void CopyAndFixupObjects() SHARED_REQUIRES(Locks::mutator_lock_);
-  static void CopyAndFixupObjectsCallback(mirror::Object* obj, void* arg)
+  // Copies and fixes up the objects on the compiler driver's number of threads.
+  void CopyAndFixupObjects() REQUIRES(!Locks::mutator_lock_);
+  static void CollectObjectsToCopyCallback(mirror::Object* obj, void* arg)
       SHARED_REQUIRES(Locks::mutator_lock_);
   void CopyAndFixupObject(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_);
   void CopyAndFixupMethod(ArtMethod* orig, ArtMethod* copy, const ImageInfo& image_info)
@@ -581,6 +582,7 @@ class ImageWriter FINAL {
   const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map_;
 
   friend class ContainsBootClassLoaderNonImageClassVisitor;
+  class CopyAndFixupObjectsTask;
   friend class FixupClassVisitor;
   friend class FixupRootVisitor;
   friend class FixupVisitor;
@@ -56,11 +56,11 @@ extern "C" void jit_unload(void* handle) {
 }
 
 extern "C" bool jit_compile_method(
-    void* handle, ArtMethod* method, Thread* self, bool osr)
+    void* handle, ArtMethod* method, Thread* self, bool baseline, bool osr)
     SHARED_REQUIRES(Locks::mutator_lock_) {
   auto* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
   DCHECK(jit_compiler != nullptr);
-  return jit_compiler->CompileMethod(self, method, osr);
+  return jit_compiler->CompileMethod(self, method, baseline, osr);
 }
 
 extern "C" void jit_types_loaded(void* handle, mirror::Class** types, size_t count)
@@ -148,6 +148,10 @@ JitCompiler::JitCompiler() {
   }
   cumulative_logger_.reset(new CumulativeLogger("jit times"));
   method_inliner_map_.reset(new DexFileToMethodInlinerMap);
+  // Match the number of JIT pool workers, see Jit::Create.
+  size_t jit_thread_count = compiler_options_->GetGenerateDebugInfo()
+      ? 1u
+      : Runtime::Current()->GetJITOptions()->GetThreadPoolSize();
   compiler_driver_.reset(new CompilerDriver(
       compiler_options_.get(),
       /* verification_results */ nullptr,
@@ -160,7 +164,7 @@ JitCompiler::JitCompiler() {
       /* image_classes */ nullptr,
       /* compiled_classes */ nullptr,
       /* compiled_methods */ nullptr,
-      /* thread_count */ 1,
+      jit_thread_count,
       /* dump_stats */ false,
       /* dump_passes */ false,
       cumulative_logger_.get(),
@@ -199,7 +203,7 @@ JitCompiler::~JitCompiler() {
   }
 }
 
-bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method, bool osr) {
+bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method, bool baseline, bool osr) {
   DCHECK(!method->IsProxyMethod());
   TimingLogger logger("JIT compiler timing logger", true, VLOG_IS_ON(jit));
   StackHandleScope<2> hs(self);
@@ -218,7 +222,8 @@ bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method, bool osr) {
   {
     TimingLogger::ScopedTiming t2("Compiling", &logger);
     JitCodeCache* const code_cache = runtime->GetJit()->GetCodeCache();
-    success = compiler_driver_->GetCompiler()->JitCompile(self, code_cache, method, osr);
+    success = compiler_driver_->GetCompiler()->JitCompile(
+        self, code_cache, method, baseline, osr);
     if (success && (perf_file_ != nullptr)) {
       const void* ptr = method->GetEntryPointFromQuickCompiledCode();
       std::ostringstream stream;
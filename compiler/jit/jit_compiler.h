@@ -36,7 +36,7 @@ class JitCompiler {
   virtual ~JitCompiler();
 
   // Compilation entrypoint. Returns whether the compilation succeeded.
-  bool CompileMethod(Thread* self, ArtMethod* method, bool osr)
+  bool CompileMethod(Thread* self, ArtMethod* method, bool baseline, bool osr)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   CompilerOptions* GetCompilerOptions() const {
@@ -658,138 +658,248 @@ class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
   size_t num_non_null_compiled_methods_;
 };
 
-class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
+// The sections of the code in the oat file, in layout order.
+enum class OatWriter::CodeSection : uint8_t {
+  kHot,      // Methods in the profile.
+  kStartup,  // Other methods of the classes resolved at startup according to the profile.
+  kCold,     // Everything else. Without a profile, all methods are in this section.
+};
+
+struct OatWriter::OrderedMethodData {
+  CodeSection section;
+  CompiledMethod* compiled_method;
+  const DexFile* dex_file;
+  size_t class_def_index;
+  size_t oat_class_index;
+  size_t method_offsets_index;
+  uint32_t method_index;
+  uint32_t access_flags;
+  const DexFile::CodeItem* code_item;
+
+  MethodReference GetMethodReference() const {
+    return MethodReference(dex_file, method_index);
+  }
+};
+
+// Collect the compiled methods and sort them by code section. The definition order is kept
+// within each section, so that the layout does not change when there is no profile.
+class OatWriter::LayoutCodeMethodVisitor : public OatDexMethodVisitor {
  public:
-  InitCodeMethodVisitor(OatWriter* writer, size_t offset)
+  LayoutCodeMethodVisitor(OatWriter* writer, size_t offset)
     : OatDexMethodVisitor(writer, offset),
-      debuggable_(writer->GetCompilerDriver()->GetCompilerOptions().GetDebuggable()) {
-    writer_->absolute_patch_locations_.reserve(
-        writer_->compiler_driver_->GetNonRelativeLinkerPatchCount());
+      profile_compilation_info_(writer->GetCompilerDriver()->GetProfileCompilationInfo()),
+      is_startup_class_(false) {
+    writer_->ordered_methods_.clear();
+  }
+
+  bool StartClass(const DexFile* dex_file, size_t class_def_index) {
+    OatDexMethodVisitor::StartClass(dex_file, class_def_index);
+    is_startup_class_ = profile_compilation_info_ != nullptr &&
+        profile_compilation_info_->ContainsClass(*dex_file, class_def_index);
+    return true;
   }
 
   bool EndClass() {
     OatDexMethodVisitor::EndClass();
     if (oat_class_index_ == writer_->oat_classes_.size()) {
-      offset_ = writer_->relative_patcher_->ReserveSpaceEnd(offset_);
+      std::stable_sort(writer_->ordered_methods_.begin(),
+                       writer_->ordered_methods_.end(),
+                       [](const OrderedMethodData& lhs, const OrderedMethodData& rhs) {
+                         return lhs.section < rhs.section;
+                       });
     }
     return true;
   }
 
-  bool VisitMethod(size_t class_def_method_index, const ClassDataItemIterator& it)
-      SHARED_REQUIRES(Locks::mutator_lock_) {
+  bool VisitMethod(size_t class_def_method_index, const ClassDataItemIterator& it) {
     OatClass* oat_class = &writer_->oat_classes_[oat_class_index_];
     CompiledMethod* compiled_method = oat_class->GetCompiledMethod(class_def_method_index);
 
     if (compiled_method != nullptr) {
-      // Derived from CompiledMethod.
-      uint32_t quick_code_offset = 0;
-
-      ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
-      uint32_t code_size = quick_code.size() * sizeof(uint8_t);
-      uint32_t thumb_offset = compiled_method->CodeDelta();
-
-      // Deduplicate code arrays if we are not producing debuggable code.
-      bool deduped = true;
-      MethodReference method_ref(dex_file_, it.GetMemberIndex());
-      if (debuggable_) {
-        quick_code_offset = writer_->relative_patcher_->GetOffset(method_ref);
-        if (quick_code_offset != 0u) {
-          // Duplicate methods, we want the same code for both of them so that the oat writer puts
-          // the same code in both ArtMethods so that we do not get different oat code at runtime.
-        } else {
-          quick_code_offset = NewQuickCodeOffset(compiled_method, it, thumb_offset);
-          deduped = false;
+      CodeSection section = CodeSection::kCold;
+      if (profile_compilation_info_ != nullptr) {
+        if (profile_compilation_info_->ContainsMethod(
+                MethodReference(dex_file_, it.GetMemberIndex()))) {
+          section = CodeSection::kHot;
+        } else if (is_startup_class_) {
+          section = CodeSection::kStartup;
         }
-      } else {
-        quick_code_offset = dedupe_map_.GetOrCreate(
-            compiled_method,
-            [this, &deduped, compiled_method, &it, thumb_offset]() {
-              deduped = false;
-              return NewQuickCodeOffset(compiled_method, it, thumb_offset);
-            });
       }
+      writer_->ordered_methods_.push_back(OrderedMethodData {
+          section,
+          compiled_method,
+          dex_file_,
+          class_def_index_,
+          oat_class_index_,
+          method_offsets_index_,
+          it.GetMemberIndex(),
+          it.GetMethodAccessFlags(),
+          it.GetMethodCodeItem()
+      });
+      ++method_offsets_index_;
+    }
 
-      if (code_size != 0) {
-        if (writer_->relative_patcher_->GetOffset(method_ref) != 0u) {
-          // TODO: Should this be a hard failure?
-          LOG(WARNING) << "Multiple definitions of "
-              << PrettyMethod(method_ref.dex_method_index, *method_ref.dex_file)
-              << " offsets " << writer_->relative_patcher_->GetOffset(method_ref)
-              << " " << quick_code_offset;
-        } else {
-          writer_->relative_patcher_->SetOffset(method_ref, quick_code_offset);
-        }
+    return true;
+  }
+
+ private:
+  const ProfileCompilationInfo* const profile_compilation_info_;
+  bool is_startup_class_;
+};
+
+class OatWriter::OrderedMethodVisitor {
+ public:
+  OrderedMethodVisitor(OatWriter* writer, size_t offset)
+    : writer_(writer),
+      offset_(offset) {
+  }
+
+  virtual bool VisitMethod(const OrderedMethodData& method_data) = 0;
+
+  // Called once all the methods have been visited.
+  virtual bool VisitComplete() = 0;
+
+  size_t GetOffset() const {
+    return offset_;
+  }
+
+ protected:
+  virtual ~OrderedMethodVisitor() { }
+
+  OatWriter* const writer_;
+
+  // The offset is usually advanced for each visited method by the derived class.
+  size_t offset_;
+};
+
+class OatWriter::InitCodeMethodVisitor : public OrderedMethodVisitor {
+ public:
+  InitCodeMethodVisitor(OatWriter* writer, size_t offset)
+    : OrderedMethodVisitor(writer, offset),
+      debuggable_(writer->GetCompilerDriver()->GetCompilerOptions().GetDebuggable()) {
+    writer_->absolute_patch_locations_.reserve(
+        writer_->compiler_driver_->GetNonRelativeLinkerPatchCount());
+  }
+
+  bool VisitComplete() OVERRIDE {
+    offset_ = writer_->relative_patcher_->ReserveSpaceEnd(offset_);
+    return true;
+  }
+
+  bool VisitMethod(const OrderedMethodData& method_data) OVERRIDE
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    OatClass* oat_class = &writer_->oat_classes_[method_data.oat_class_index];
+    CompiledMethod* compiled_method = method_data.compiled_method;
+    DCHECK(compiled_method != nullptr);
+
+    // Derived from CompiledMethod.
+    uint32_t quick_code_offset = 0;
+
+    ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
+    uint32_t code_size = quick_code.size() * sizeof(uint8_t);
+    uint32_t thumb_offset = compiled_method->CodeDelta();
+
+    // Deduplicate code arrays if we are not producing debuggable code.
+    bool deduped = true;
+    MethodReference method_ref = method_data.GetMethodReference();
+    if (debuggable_) {
+      quick_code_offset = writer_->relative_patcher_->GetOffset(method_ref);
+      if (quick_code_offset != 0u) {
+        // Duplicate methods, we want the same code for both of them so that the oat writer puts
+        // the same code in both ArtMethods so that we do not get different oat code at runtime.
+      } else {
+        quick_code_offset = NewQuickCodeOffset(compiled_method, method_ref, thumb_offset);
+        deduped = false;
       }
+    } else {
+      quick_code_offset = dedupe_map_.GetOrCreate(
+          compiled_method,
+          [this, &deduped, compiled_method, &method_ref, thumb_offset]() {
+            deduped = false;
+            return NewQuickCodeOffset(compiled_method, method_ref, thumb_offset);
+          });
+    }
 
-      // Update quick method header.
-      DCHECK_LT(method_offsets_index_, oat_class->method_headers_.size());
-      OatQuickMethodHeader* method_header = &oat_class->method_headers_[method_offsets_index_];
-      uint32_t vmap_table_offset = method_header->vmap_table_offset_;
-      // If we don't have quick code, then we must have a vmap, as that is how the dex2dex
-      // compiler records its transformations.
-      DCHECK(!quick_code.empty() || vmap_table_offset != 0);
-      // The code offset was 0 when the mapping/vmap table offset was set, so it's set
-      // to 0-offset and we need to adjust it by code_offset.
-      uint32_t code_offset = quick_code_offset - thumb_offset;
-      if (vmap_table_offset != 0u && code_offset != 0u) {
-        vmap_table_offset += code_offset;
-        DCHECK_LT(vmap_table_offset, code_offset) << "Overflow in oat offsets";
+    if (code_size != 0) {
+      if (writer_->relative_patcher_->GetOffset(method_ref) != 0u) {
+        // TODO: Should this be a hard failure?
+        LOG(WARNING) << "Multiple definitions of "
+            << PrettyMethod(method_ref.dex_method_index, *method_ref.dex_file)
+            << " offsets " << writer_->relative_patcher_->GetOffset(method_ref)
+            << " " << quick_code_offset;
+      } else {
+        writer_->relative_patcher_->SetOffset(method_ref, quick_code_offset);
       }
-      uint32_t frame_size_in_bytes = compiled_method->GetFrameSizeInBytes();
-      uint32_t core_spill_mask = compiled_method->GetCoreSpillMask();
-      uint32_t fp_spill_mask = compiled_method->GetFpSpillMask();
-      *method_header = OatQuickMethodHeader(vmap_table_offset,
-                                            frame_size_in_bytes,
-                                            core_spill_mask,
-                                            fp_spill_mask,
-                                            code_size);
-
-      if (!deduped) {
-        // Update offsets. (Checksum is updated when writing.)
-        offset_ += sizeof(*method_header);  // Method header is prepended before code.
-        offset_ += code_size;
-        // Record absolute patch locations.
-        if (!compiled_method->GetPatches().empty()) {
-          uintptr_t base_loc = offset_ - code_size - writer_->oat_header_->GetExecutableOffset();
-          for (const LinkerPatch& patch : compiled_method->GetPatches()) {
-            if (!patch.IsPcRelative()) {
-              writer_->absolute_patch_locations_.push_back(base_loc + patch.LiteralOffset());
-            }
+    }
+
+    // Update quick method header.
+    const size_t method_offsets_index = method_data.method_offsets_index;
+    DCHECK_LT(method_offsets_index, oat_class->method_headers_.size());
+    OatQuickMethodHeader* method_header = &oat_class->method_headers_[method_offsets_index];
+    uint32_t vmap_table_offset = method_header->vmap_table_offset_;
+    // If we don't have quick code, then we must have a vmap, as that is how the dex2dex
+    // compiler records its transformations.
+    DCHECK(!quick_code.empty() || vmap_table_offset != 0);
+    // The code offset was 0 when the mapping/vmap table offset was set, so it's set
+    // to 0-offset and we need to adjust it by code_offset.
+    uint32_t code_offset = quick_code_offset - thumb_offset;
+    if (vmap_table_offset != 0u && code_offset != 0u) {
+      vmap_table_offset += code_offset;
+      DCHECK_LT(vmap_table_offset, code_offset) << "Overflow in oat offsets";
+    }
+    uint32_t frame_size_in_bytes = compiled_method->GetFrameSizeInBytes();
+    uint32_t core_spill_mask = compiled_method->GetCoreSpillMask();
+    uint32_t fp_spill_mask = compiled_method->GetFpSpillMask();
+    *method_header = OatQuickMethodHeader(vmap_table_offset,
+                                          frame_size_in_bytes,
+                                          core_spill_mask,
+                                          fp_spill_mask,
+                                          code_size);
+
+    if (!deduped) {
+      // Update offsets. (Checksum is updated when writing.)
+      offset_ += sizeof(*method_header);  // Method header is prepended before code.
+      offset_ += code_size;
+      // Record absolute patch locations.
+      if (!compiled_method->GetPatches().empty()) {
+        uintptr_t base_loc = offset_ - code_size - writer_->oat_header_->GetExecutableOffset();
+        for (const LinkerPatch& patch : compiled_method->GetPatches()) {
+          if (!patch.IsPcRelative()) {
+            writer_->absolute_patch_locations_.push_back(base_loc + patch.LiteralOffset());
           }
         }
       }
+    }
 
-      const CompilerOptions& compiler_options = writer_->compiler_driver_->GetCompilerOptions();
-      // Exclude quickened dex methods (code_size == 0) since they have no native code.
-      if (compiler_options.GenerateAnyDebugInfo() && code_size != 0) {
-        bool has_code_info = method_header->IsOptimized();
-        // Record debug information for this function if we are doing that.
-        debug::MethodDebugInfo info = debug::MethodDebugInfo();
-        info.trampoline_name = nullptr;
-        info.dex_file = dex_file_;
-        info.class_def_index = class_def_index_;
-        info.dex_method_index = it.GetMemberIndex();
-        info.access_flags = it.GetMethodAccessFlags();
-        info.code_item = it.GetMethodCodeItem();
-        info.isa = compiled_method->GetInstructionSet();
-        info.deduped = deduped;
-        info.is_native_debuggable = compiler_options.GetNativeDebuggable();
-        info.is_optimized = method_header->IsOptimized();
-        info.is_code_address_text_relative = true;
-        info.code_address = code_offset - writer_->oat_header_->GetExecutableOffset();
-        info.code_size = code_size;
-        info.frame_size_in_bytes = compiled_method->GetFrameSizeInBytes();
-        info.code_info = has_code_info ? compiled_method->GetVmapTable().data() : nullptr;
-        info.cfi = compiled_method->GetCFIInfo();
-        writer_->method_info_.push_back(info);
-      }
-
-      DCHECK_LT(method_offsets_index_, oat_class->method_offsets_.size());
-      OatMethodOffsets* offsets = &oat_class->method_offsets_[method_offsets_index_];
-      offsets->code_offset_ = quick_code_offset;
-      ++method_offsets_index_;
+    const CompilerOptions& compiler_options = writer_->compiler_driver_->GetCompilerOptions();
+    // Exclude quickened dex methods (code_size == 0) since they have no native code.
+    if (compiler_options.GenerateAnyDebugInfo() && code_size != 0) {
+      bool has_code_info = method_header->IsOptimized();
+      // Record debug information for this function if we are doing that.
+      debug::MethodDebugInfo info = debug::MethodDebugInfo();
+      info.trampoline_name = nullptr;
+      info.dex_file = method_data.dex_file;
+      info.class_def_index = method_data.class_def_index;
+      info.dex_method_index = method_data.method_index;
+      info.access_flags = method_data.access_flags;
+      info.code_item = method_data.code_item;
+      info.isa = compiled_method->GetInstructionSet();
+      info.deduped = deduped;
+      info.is_native_debuggable = compiler_options.GetNativeDebuggable();
+      info.is_optimized = method_header->IsOptimized();
+      info.is_code_address_text_relative = true;
+      info.code_address = code_offset - writer_->oat_header_->GetExecutableOffset();
+      info.code_size = code_size;
+      info.frame_size_in_bytes = compiled_method->GetFrameSizeInBytes();
+      info.code_info = has_code_info ? compiled_method->GetVmapTable().data() : nullptr;
+      info.cfi = compiled_method->GetCFIInfo();
+      writer_->method_info_.push_back(info);
     }
 
+    DCHECK_LT(method_offsets_index, oat_class->method_offsets_.size());
+    OatMethodOffsets* offsets = &oat_class->method_offsets_[method_offsets_index];
+    offsets->code_offset_ = quick_code_offset;
+
     return true;
   }
 
@@ -812,10 +922,9 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
   };
 
   uint32_t NewQuickCodeOffset(CompiledMethod* compiled_method,
-                              const ClassDataItemIterator& it,
+                              const MethodReference& method_ref,
                               uint32_t thumb_offset) {
-    offset_ = writer_->relative_patcher_->ReserveSpace(
-        offset_, compiled_method, MethodReference(dex_file_, it.GetMemberIndex()));
+    offset_ = writer_->relative_patcher_->ReserveSpace(offset_, compiled_method, method_ref);
     offset_ = compiled_method->AlignCode(offset_);
     DCHECK_ALIGNED_PARAM(offset_,
                          GetInstructionSetAlignment(compiled_method->GetInstructionSet()));
@@ -944,16 +1053,17 @@ class OatWriter::InitImageMethodVisitor : public OatDexMethodVisitor {
   const size_t pointer_size_;
 };
 
-class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
+class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
  public:
   WriteCodeMethodVisitor(OatWriter* writer, OutputStream* out, const size_t file_offset,
                          size_t relative_offset) SHARED_LOCK_FUNCTION(Locks::mutator_lock_)
-    : OatDexMethodVisitor(writer, relative_offset),
+    : OrderedMethodVisitor(writer, relative_offset),
       out_(out),
       file_offset_(file_offset),
       soa_(Thread::Current()),
       no_thread_suspension_(soa_.Self(), "OatWriter patching"),
       class_linker_(Runtime::Current()->GetClassLinker()),
+      dex_file_(nullptr),
       dex_cache_(nullptr) {
     patched_code_.reserve(16 * KB);
     if (writer_->HasBootImage()) {
@@ -965,145 +1075,138 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
   ~WriteCodeMethodVisitor() UNLOCK_FUNCTION(Locks::mutator_lock_) {
   }
 
-  bool StartClass(const DexFile* dex_file, size_t class_def_index)
-      SHARED_REQUIRES(Locks::mutator_lock_) {
-    OatDexMethodVisitor::StartClass(dex_file, class_def_index);
-    if (dex_cache_ == nullptr || dex_cache_->GetDexFile() != dex_file) {
-      dex_cache_ = class_linker_->FindDexCache(Thread::Current(), *dex_file);
-      DCHECK(dex_cache_ != nullptr);
+  bool VisitComplete() OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    offset_ = writer_->relative_patcher_->WriteThunks(out_, offset_);
+    if (UNLIKELY(offset_ == 0u)) {
+      PLOG(ERROR) << "Failed to write final relative call thunks";
+      return false;
     }
     return true;
   }
 
-  bool EndClass() SHARED_REQUIRES(Locks::mutator_lock_) {
-    bool result = OatDexMethodVisitor::EndClass();
-    if (oat_class_index_ == writer_->oat_classes_.size()) {
-      DCHECK(result);  // OatDexMethodVisitor::EndClass() never fails.
-      offset_ = writer_->relative_patcher_->WriteThunks(out_, offset_);
-      if (UNLIKELY(offset_ == 0u)) {
-        PLOG(ERROR) << "Failed to write final relative call thunks";
-        result = false;
+  bool VisitMethod(const OrderedMethodData& method_data) OVERRIDE
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    OatClass* oat_class = &writer_->oat_classes_[method_data.oat_class_index];
+    const CompiledMethod* compiled_method = method_data.compiled_method;
+    DCHECK(compiled_method != nullptr);
+    const size_t method_offsets_index = method_data.method_offsets_index;
+    MethodReference method_ref = method_data.GetMethodReference();
+    if (dex_file_ != method_data.dex_file) {
+      dex_file_ = method_data.dex_file;
+      if (dex_cache_ == nullptr || dex_cache_->GetDexFile() != dex_file_) {
+        dex_cache_ = class_linker_->FindDexCache(Thread::Current(), *dex_file_);
+        DCHECK(dex_cache_ != nullptr);
       }
     }
-    return result;
-  }
-
-  bool VisitMethod(size_t class_def_method_index, const ClassDataItemIterator& it)
-      SHARED_REQUIRES(Locks::mutator_lock_) {
-    OatClass* oat_class = &writer_->oat_classes_[oat_class_index_];
-    const CompiledMethod* compiled_method = oat_class->GetCompiledMethod(class_def_method_index);
 
     // No thread suspension since dex_cache_ that may get invalidated if that occurs.
     ScopedAssertNoThreadSuspension tsc(Thread::Current(), __FUNCTION__);
-    if (compiled_method != nullptr) {  // ie. not an abstract method
-      size_t file_offset = file_offset_;
-      OutputStream* out = out_;
-
-      ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
-      uint32_t code_size = quick_code.size() * sizeof(uint8_t);
-
-      // Deduplicate code arrays.
-      const OatMethodOffsets& method_offsets = oat_class->method_offsets_[method_offsets_index_];
-      if (method_offsets.code_offset_ > offset_) {
-        offset_ = writer_->relative_patcher_->WriteThunks(out, offset_);
-        if (offset_ == 0u) {
-          ReportWriteFailure("relative call thunk", it);
-          return false;
-        }
-        uint32_t aligned_offset = compiled_method->AlignCode(offset_);
-        uint32_t aligned_code_delta = aligned_offset - offset_;
-        if (aligned_code_delta != 0) {
-          if (!writer_->WriteCodeAlignment(out, aligned_code_delta)) {
-            ReportWriteFailure("code alignment padding", it);
-            return false;
-          }
-          offset_ += aligned_code_delta;
-          DCHECK_OFFSET_();
-        }
-        DCHECK_ALIGNED_PARAM(offset_,
-                             GetInstructionSetAlignment(compiled_method->GetInstructionSet()));
-        DCHECK_EQ(method_offsets.code_offset_,
-                  offset_ + sizeof(OatQuickMethodHeader) + compiled_method->CodeDelta())
-            << PrettyMethod(it.GetMemberIndex(), *dex_file_);
-        const OatQuickMethodHeader& method_header =
-            oat_class->method_headers_[method_offsets_index_];
-        if (!out->WriteFully(&method_header, sizeof(method_header))) {
-          ReportWriteFailure("method header", it);
+    size_t file_offset = file_offset_;
+    OutputStream* out = out_;
+
+    ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
+    uint32_t code_size = quick_code.size() * sizeof(uint8_t);
+
+    // Deduplicate code arrays.
+    const OatMethodOffsets& method_offsets = oat_class->method_offsets_[method_offsets_index];
+    if (method_offsets.code_offset_ > offset_) {
+      offset_ = writer_->relative_patcher_->WriteThunks(out, offset_);
+      if (offset_ == 0u) {
+        ReportWriteFailure("relative call thunk", method_ref);
+        return false;
+      }
+      uint32_t aligned_offset = compiled_method->AlignCode(offset_);
+      uint32_t aligned_code_delta = aligned_offset - offset_;
+      if (aligned_code_delta != 0) {
+        if (!writer_->WriteCodeAlignment(out, aligned_code_delta)) {
+          ReportWriteFailure("code alignment padding", method_ref);
           return false;
         }
-        writer_->size_method_header_ += sizeof(method_header);
-        offset_ += sizeof(method_header);
+        offset_ += aligned_code_delta;
         DCHECK_OFFSET_();
+      }
+      DCHECK_ALIGNED_PARAM(offset_,
+                           GetInstructionSetAlignment(compiled_method->GetInstructionSet()));
+      DCHECK_EQ(method_offsets.code_offset_,
+                offset_ + sizeof(OatQuickMethodHeader) + compiled_method->CodeDelta())
+          << PrettyMethod(method_ref.dex_method_index, *dex_file_);
+      const OatQuickMethodHeader& method_header =
+          oat_class->method_headers_[method_offsets_index];
+      if (!out->WriteFully(&method_header, sizeof(method_header))) {
+        ReportWriteFailure("method header", method_ref);
+        return false;
+      }
+      writer_->size_method_header_ += sizeof(method_header);
+      offset_ += sizeof(method_header);
+      DCHECK_OFFSET_();
 
-        if (!compiled_method->GetPatches().empty()) {
-          patched_code_.assign(quick_code.begin(), quick_code.end());
-          quick_code = ArrayRef<const uint8_t>(patched_code_);
-          for (const LinkerPatch& patch : compiled_method->GetPatches()) {
-            uint32_t literal_offset = patch.LiteralOffset();
-            switch (patch.GetType()) {
-              case LinkerPatch::Type::kCallRelative: {
-                // NOTE: Relative calls across oat files are not supported.
-                uint32_t target_offset = GetTargetOffset(patch);
-                writer_->relative_patcher_->PatchCall(&patched_code_,
-                                                      literal_offset,
-                                                      offset_ + literal_offset,
-                                                      target_offset);
-                break;
-              }
-              case LinkerPatch::Type::kDexCacheArray: {
-                uint32_t target_offset = GetDexCacheOffset(patch);
-                writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                     patch,
-                                                                     offset_ + literal_offset,
-                                                                     target_offset);
-                break;
-              }
-              case LinkerPatch::Type::kStringRelative: {
-                uint32_t target_offset = GetTargetObjectOffset(GetTargetString(patch));
-                writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                     patch,
-                                                                     offset_ + literal_offset,
-                                                                     target_offset);
-                break;
-              }
-              case LinkerPatch::Type::kCall: {
-                uint32_t target_offset = GetTargetOffset(patch);
-                PatchCodeAddress(&patched_code_, literal_offset, target_offset);
-                break;
-              }
-              case LinkerPatch::Type::kMethod: {
-                ArtMethod* method = GetTargetMethod(patch);
-                PatchMethodAddress(&patched_code_, literal_offset, method);
-                break;
-              }
-              case LinkerPatch::Type::kString: {
-                mirror::String* string = GetTargetString(patch);
-                PatchObjectAddress(&patched_code_, literal_offset, string);
-                break;
-              }
-              case LinkerPatch::Type::kType: {
-                mirror::Class* type = GetTargetType(patch);
-                PatchObjectAddress(&patched_code_, literal_offset, type);
-                break;
-              }
-              default: {
-                DCHECK_EQ(patch.GetType(), LinkerPatch::Type::kRecordPosition);
-                break;
-              }
+      if (!compiled_method->GetPatches().empty()) {
+        patched_code_.assign(quick_code.begin(), quick_code.end());
+        quick_code = ArrayRef<const uint8_t>(patched_code_);
+        for (const LinkerPatch& patch : compiled_method->GetPatches()) {
+          uint32_t literal_offset = patch.LiteralOffset();
+          switch (patch.GetType()) {
+            case LinkerPatch::Type::kCallRelative: {
+              // NOTE: Relative calls across oat files are not supported.
+              uint32_t target_offset = GetTargetOffset(patch);
+              writer_->relative_patcher_->PatchCall(&patched_code_,
+                                                    literal_offset,
+                                                    offset_ + literal_offset,
+                                                    target_offset);
+              break;
+            }
+            case LinkerPatch::Type::kDexCacheArray: {
+              uint32_t target_offset = GetDexCacheOffset(patch);
+              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
+                                                                   patch,
+                                                                   offset_ + literal_offset,
+                                                                   target_offset);
+              break;
+            }
+            case LinkerPatch::Type::kStringRelative: {
+              uint32_t target_offset = GetTargetObjectOffset(GetTargetString(patch));
+              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
+                                                                   patch,
+                                                                   offset_ + literal_offset,
+                                                                   target_offset);
+              break;
+            }
+            case LinkerPatch::Type::kCall: {
+              uint32_t target_offset = GetTargetOffset(patch);
+              PatchCodeAddress(&patched_code_, literal_offset, target_offset);
+              break;
+            }
+            case LinkerPatch::Type::kMethod: {
+              ArtMethod* method = GetTargetMethod(patch);
+              PatchMethodAddress(&patched_code_, literal_offset, method);
+              break;
+            }
+            case LinkerPatch::Type::kString: {
+              mirror::String* string = GetTargetString(patch);
+              PatchObjectAddress(&patched_code_, literal_offset, string);
+              break;
+            }
+            case LinkerPatch::Type::kType: {
+              mirror::Class* type = GetTargetType(patch);
+              PatchObjectAddress(&patched_code_, literal_offset, type);
+              break;
+            }
+            default: {
+              DCHECK_EQ(patch.GetType(), LinkerPatch::Type::kRecordPosition);
+              break;
             }
           }
         }
+      }
 
-        if (!out->WriteFully(quick_code.data(), code_size)) {
-          ReportWriteFailure("method code", it);
-          return false;
-        }
-        writer_->size_code_ += code_size;
-        offset_ += code_size;
+      if (!out->WriteFully(quick_code.data(), code_size)) {
+        ReportWriteFailure("method code", method_ref);
+        return false;
       }
-      DCHECK_OFFSET_();
-      ++method_offsets_index_;
+      writer_->size_code_ += code_size;
+      offset_ += code_size;
     }
+    DCHECK_OFFSET_();
 
     return true;
   }
@@ -1114,12 +1217,15 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
   const ScopedObjectAccess soa_;
   const ScopedAssertNoThreadSuspension no_thread_suspension_;
   ClassLinker* const class_linker_;
+  // The dex file and dex cache of the method being written.
+  const DexFile* dex_file_;
   mirror::DexCache* dex_cache_;
   std::vector<uint8_t> patched_code_;
 
-  void ReportWriteFailure(const char* what, const ClassDataItemIterator& it) {
+  void ReportWriteFailure(const char* what, const MethodReference& method_ref) {
     PLOG(ERROR) << "Failed to write " << what << " for "
-        << PrettyMethod(it.GetMemberIndex(), *dex_file_) << " to " << out_->GetLocation();
+        << PrettyMethod(method_ref.dex_method_index, *method_ref.dex_file)
+        << " to " << out_->GetLocation();
   }
 
   ArtMethod* GetTargetMethod(const LinkerPatch& patch)
@@ -1369,6 +1475,15 @@ bool OatWriter::VisitDexMethods(DexMethodVisitor* visitor) {
   return true;
 }
 
+bool OatWriter::VisitOrderedMethods(OrderedMethodVisitor* visitor) {
+  for (const OrderedMethodData& method_data : ordered_methods_) {
+    if (UNLIKELY(!visitor->VisitMethod(method_data))) {
+      return false;
+    }
+  }
+  return visitor->VisitComplete();
+}
+
 size_t OatWriter::InitOatHeader(InstructionSet instruction_set,
                                 const InstructionSetFeatures* instruction_set_features,
                                 uint32_t num_dex_files,
@@ -1461,21 +1576,24 @@ size_t OatWriter::InitOatCode(size_t offset) {
 }
 
 size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
-  #define VISIT(VisitorType)                          \
-    do {                                              \
-      VisitorType visitor(this, offset);              \
-      bool success = VisitDexMethods(&visitor);       \
-      DCHECK(success);                                \
-      offset = visitor.GetOffset();                   \
-    } while (false)
-
-  VISIT(InitCodeMethodVisitor);
+  {
+    LayoutCodeMethodVisitor layout_visitor(this, offset);
+    bool success = VisitDexMethods(&layout_visitor);
+    DCHECK(success);
+  }
+  {
+    InitCodeMethodVisitor code_visitor(this, offset);
+    bool success = VisitOrderedMethods(&code_visitor);
+    DCHECK(success);
+    offset = code_visitor.GetOffset();
+  }
   if (HasImage()) {
-    VISIT(InitImageMethodVisitor);
+    InitImageMethodVisitor image_visitor(this, offset);
+    bool success = VisitDexMethods(&image_visitor);
+    DCHECK(success);
+    offset = image_visitor.GetOffset();
   }
 
-  #undef VISIT
-
   return offset;
 }
 
@@ -1738,18 +1856,13 @@ size_t OatWriter::WriteCode(OutputStream* out, const size_t file_offset, size_t
 size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
                                     const size_t file_offset,
                                     size_t relative_offset) {
-  #define VISIT(VisitorType)                                              \
-    do {                                                                  \
-      VisitorType visitor(this, out, file_offset, relative_offset);       \
-      if (UNLIKELY(!VisitDexMethods(&visitor))) {                         \
-        return 0;                                                         \
-      }                                                                   \
-      relative_offset = visitor.GetOffset();                              \
-    } while (false)
-
-  VISIT(WriteCodeMethodVisitor);
-
-  #undef VISIT
+  {
+    WriteCodeMethodVisitor visitor(this, out, file_offset, relative_offset);
+    if (UNLIKELY(!VisitOrderedMethods(&visitor))) {
+      return 0;
+    }
+    relative_offset = visitor.GetOffset();
+  }
 
   size_code_alignment_ += relative_patcher_->CodeAlignmentSize();
   size_relative_call_thunks_ += relative_patcher_->RelativeCallThunksSize();
@@ -227,16 +227,28 @@ class OatWriter {
   class DexMethodVisitor;
   class OatDexMethodVisitor;
   class InitOatClassesMethodVisitor;
-  class InitCodeMethodVisitor;
+  class LayoutCodeMethodVisitor;
   class InitMapMethodVisitor;
   class InitImageMethodVisitor;
-  class WriteCodeMethodVisitor;
   class WriteMapMethodVisitor;
 
+  // The code of the compiled methods is not laid out in definition order. When a profile is
+  // available, LayoutCodeMethodVisitor groups the methods into hot, startup and cold sections
+  // to reduce the number of pages touched by the code executed at startup and in steady state.
+  // The code passes visit the compiled methods in that order with an OrderedMethodVisitor.
+  enum class CodeSection : uint8_t;
+  struct OrderedMethodData;
+  class OrderedMethodVisitor;
+  class InitCodeMethodVisitor;
+  class WriteCodeMethodVisitor;
+
   // Visit all the methods in all the compiled dex files in their definition order
   // with a given DexMethodVisitor.
   bool VisitDexMethods(DexMethodVisitor* visitor);
 
+  // Visit the compiled methods in the order of their code with a given OrderedMethodVisitor.
+  bool VisitOrderedMethods(OrderedMethodVisitor* visitor);
+
   size_t InitOatHeader(InstructionSet instruction_set,
                        const InstructionSetFeatures* instruction_set_features,
                        uint32_t num_dex_files,
@@ -319,6 +331,8 @@ class OatWriter {
   std::unique_ptr<OatHeader> oat_header_;
   dchecked_vector<OatDexFile> oat_dex_files_;
   dchecked_vector<OatClass> oat_classes_;
+  // The compiled methods in the order of their code, see LayoutCodeMethodVisitor.
+  dchecked_vector<OrderedMethodData> ordered_methods_;
   std::unique_ptr<const std::vector<uint8_t>> jni_dlsym_lookup_;
   std::unique_ptr<const std::vector<uint8_t>> quick_generic_jni_trampoline_;
   std::unique_ptr<const std::vector<uint8_t>> quick_imt_conflict_trampoline_;
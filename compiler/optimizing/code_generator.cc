@@ -544,6 +544,10 @@ void CodeGenerator::AllocateLocations(HInstruction* instruction) {
     if (instruction->NeedsCurrentMethod()) {
       SetRequiresCurrentMethod();
     }
+  } else if (GetGraph()->IsCompilingBaseline()) {
+    // The entry suspend check of baseline code also counts method entries and
+    // calls into the runtime once the method gets hot.
+    MarkNotLeaf();
   }
 }
 
@@ -254,6 +254,9 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   virtual bool NeedsTwoRegisters(Primitive::Type type) const = 0;
   // Returns whether we should split long moves in parallel moves.
   virtual bool ShouldSplitLongMoves() const { return false; }
+  // Returns whether baseline JIT code can count method entries to trigger
+  // its optimized compilation.
+  virtual bool SupportsBaselineHotnessCounting() const { return false; }
 
   size_t GetNumberOfCoreCalleeSaveRegisters() const {
     return POPCOUNT(core_callee_save_mask_);
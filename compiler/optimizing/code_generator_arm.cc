@@ -151,6 +151,31 @@ class SuspendCheckSlowPathARM : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(SuspendCheckSlowPathARM);
 };
 
+// Requests an optimized compilation of a hot method compiled as baseline code.
+class CompileOptimizedSlowPathARM : public SlowPathCode {
+ public:
+  explicit CompileOptimizedSlowPathARM(HSuspendCheck* instruction) : SlowPathCode(instruction) {}
+
+  void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
+    CodeGeneratorARM* arm_codegen = down_cast<CodeGeneratorARM*>(codegen);
+    __ Bind(GetEntryLabel());
+    SaveLiveRegisters(codegen, instruction_->GetLocations());
+    InvokeRuntimeCallingConvention calling_convention;
+    __ LoadFromOffset(
+        kLoadWord, calling_convention.GetRegisterAt(0), SP, kCurrentMethodStackOffset);
+    arm_codegen->InvokeRuntime(
+        QUICK_ENTRY_POINT(pCompileOptimized), instruction_, instruction_->GetDexPc(), this);
+    CheckEntrypointTypes<kQuickCompileOptimized, void, ArtMethod*>();
+    RestoreLiveRegisters(codegen, instruction_->GetLocations());
+    __ b(GetExitLabel());
+  }
+
+  const char* GetDescription() const OVERRIDE { return "CompileOptimizedSlowPathARM"; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CompileOptimizedSlowPathARM);
+};
+
 class BoundsCheckSlowPathARM : public SlowPathCode {
  public:
   explicit BoundsCheckSlowPathARM(HBoundsCheck* instruction)
@@ -4819,8 +4844,29 @@ void InstructionCodeGeneratorARM::VisitSuspendCheck(HSuspendCheck* instruction)
   GenerateSuspendCheck(instruction, nullptr);
 }
 
+void InstructionCodeGeneratorARM::GenerateHotnessCheck(HSuspendCheck* instruction) {
+  SlowPathCode* slow_path = new (GetGraph()->GetArena()) CompileOptimizedSlowPathARM(instruction);
+  codegen_->AddSlowPath(slow_path);
+
+  // LR has been saved by the frame entry and is not allocated, use it as a second temp.
+  int32_t offset = ArtMethod::HotnessCountOffset().Int32Value();
+  __ LoadFromOffset(kLoadWord, IP, SP, kCurrentMethodStackOffset);
+  __ LoadFromOffset(kLoadUnsignedHalfword, LR, IP, offset);
+  __ AddConstant(LR, LR, 1);
+  __ StoreToOffset(kStoreHalfword, LR, IP, offset);
+  // The counter is 16 bits wide: it wrapped around to zero if the low half is clear.
+  __ Lsl(LR, LR, 16);
+  __ CompareAndBranchIfZero(LR, slow_path->GetEntryLabel());
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void InstructionCodeGeneratorARM::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                        HBasicBlock* successor) {
+  if (successor == nullptr &&
+      instruction->IsSuspendCheckEntry() &&
+      GetGraph()->IsCompilingBaseline()) {
+    GenerateHotnessCheck(instruction);
+  }
   SuspendCheckSlowPathARM* slow_path =
       down_cast<SuspendCheckSlowPathARM*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
@@ -214,6 +214,9 @@ class InstructionCodeGeneratorARM : public InstructionCodeGenerator {
   // is the block to branch to if the suspend check is not needed, and after
   // the suspend call.
   void GenerateSuspendCheck(HSuspendCheck* check, HBasicBlock* successor);
+  // Count the entries of a baseline compiled method, and request its optimized
+  // compilation when it gets hot.
+  void GenerateHotnessCheck(HSuspendCheck* check);
   void GenerateClassInitializationCheck(SlowPathCode* slow_path, Register class_reg);
   void GenerateAndConst(Register out, Register first, uint32_t value);
   void GenerateOrrConst(Register out, Register first, uint32_t value);
@@ -394,6 +397,8 @@ class CodeGeneratorARM : public CodeGenerator {
     return isa_features_;
   }
 
+  bool SupportsBaselineHotnessCounting() const OVERRIDE { return true; }
+
   bool NeedsTwoRegisters(Primitive::Type type) const OVERRIDE {
     return type == Primitive::kPrimDouble || type == Primitive::kPrimLong;
   }
@@ -62,6 +62,7 @@ using helpers::OperandFromMemOperand;
 using helpers::OutputCPURegister;
 using helpers::OutputFPRegister;
 using helpers::OutputRegister;
+using helpers::QRegisterFrom;
 using helpers::RegisterFrom;
 using helpers::StackOperandFrom;
 using helpers::VIXLRegCodeFromART;
@@ -428,6 +429,31 @@ class SuspendCheckSlowPathARM64 : public SlowPathCodeARM64 {
   DISALLOW_COPY_AND_ASSIGN(SuspendCheckSlowPathARM64);
 };
 
+// Requests an optimized compilation of a hot method compiled as baseline code.
+class CompileOptimizedSlowPathARM64 : public SlowPathCodeARM64 {
+ public:
+  explicit CompileOptimizedSlowPathARM64(HSuspendCheck* instruction)
+      : SlowPathCodeARM64(instruction) {}
+
+  void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
+    CodeGeneratorARM64* arm64_codegen = down_cast<CodeGeneratorARM64*>(codegen);
+    __ Bind(GetEntryLabel());
+    SaveLiveRegisters(codegen, instruction_->GetLocations());
+    InvokeRuntimeCallingConvention calling_convention;
+    __ Ldr(calling_convention.GetRegisterAt(0).X(), MemOperand(sp, kCurrentMethodStackOffset));
+    arm64_codegen->InvokeRuntime(
+        QUICK_ENTRY_POINT(pCompileOptimized), instruction_, instruction_->GetDexPc(), this);
+    CheckEntrypointTypes<kQuickCompileOptimized, void, ArtMethod*>();
+    RestoreLiveRegisters(codegen, instruction_->GetLocations());
+    __ B(GetExitLabel());
+  }
+
+  const char* GetDescription() const OVERRIDE { return "CompileOptimizedSlowPathARM64"; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CompileOptimizedSlowPathARM64);
+};
+
 class TypeCheckSlowPathARM64 : public SlowPathCodeARM64 {
  public:
   TypeCheckSlowPathARM64(HInstruction* instruction, bool is_fatal)
@@ -962,8 +988,12 @@ void ParallelMoveResolverARM64::FinishEmitNativeCode() {
 
 Location ParallelMoveResolverARM64::AllocateScratchLocationFor(Location::Kind kind) {
   DCHECK(kind == Location::kRegister || kind == Location::kFpuRegister ||
-         kind == Location::kStackSlot || kind == Location::kDoubleStackSlot);
-  kind = (kind == Location::kFpuRegister) ? Location::kFpuRegister : Location::kRegister;
+         kind == Location::kStackSlot || kind == Location::kDoubleStackSlot ||
+         kind == Location::kSIMDStackSlot);
+  // A SIMD stack slot can only go through a 128-bit FP register.
+  kind = (kind == Location::kFpuRegister || kind == Location::kSIMDStackSlot)
+      ? Location::kFpuRegister
+      : Location::kRegister;
   Location scratch = GetScratchLocation(kind);
   if (!scratch.Equals(Location::NoLocation())) {
     return scratch;
@@ -1213,7 +1243,9 @@ void CodeGeneratorARM64::MoveLocation(Location destination,
     DCHECK((destination.IsFpuRegister() && Primitive::IsFloatingPointType(dst_type)) ||
            (destination.IsRegister() && !Primitive::IsFloatingPointType(dst_type)));
     CPURegister dst = CPURegisterFrom(destination, dst_type);
-    if (source.IsStackSlot() || source.IsDoubleStackSlot()) {
+    if (source.IsSIMDStackSlot()) {
+      __ Ldr(QRegisterFrom(destination), StackOperandFrom(source));
+    } else if (source.IsStackSlot() || source.IsDoubleStackSlot()) {
       DCHECK(dst.Is64Bits() == source.IsDoubleStackSlot());
       __ Ldr(dst, StackOperandFrom(source));
     } else if (source.IsConstant()) {
@@ -1238,9 +1270,24 @@ void CodeGeneratorARM64::MoveLocation(Location destination,
         __ Fmov(RegisterFrom(destination, dst_type), FPRegisterFrom(source, source_type));
       } else {
         DCHECK(destination.IsFpuRegister());
-        __ Fmov(FPRegister(dst), FPRegisterFrom(source, dst_type));
+        if (GetGraph()->HasSIMD()) {
+          // The register may hold a vector value: move all 128 bits.
+          __ Mov(QRegisterFrom(destination).V16B(), QRegisterFrom(source).V16B());
+        } else {
+          __ Fmov(FPRegister(dst), FPRegisterFrom(source, dst_type));
+        }
       }
     }
+  } else if (destination.IsSIMDStackSlot()) {
+    if (source.IsFpuRegister()) {
+      __ Str(QRegisterFrom(source), StackOperandFrom(destination));
+    } else {
+      DCHECK(source.IsSIMDStackSlot());
+      UseScratchRegisterScope temps(GetVIXLAssembler());
+      FPRegister temp = temps.AcquireVRegisterOfSize(kQRegSize);
+      __ Ldr(temp, StackOperandFrom(source));
+      __ Str(temp, StackOperandFrom(destination));
+    }
   } else {  // The destination is not a register. It must be a stack slot.
     DCHECK(destination.IsStackSlot() || destination.IsDoubleStackSlot());
     if (source.IsRegister() || source.IsFpuRegister()) {
@@ -1510,8 +1557,32 @@ void CodeGeneratorARM64::GenerateMemoryBarrier(MemBarrierKind kind) {
   __ Dmb(InnerShareable, type);
 }
 
+void InstructionCodeGeneratorARM64::GenerateHotnessCheck(HSuspendCheck* instruction) {
+  SlowPathCodeARM64* slow_path =
+      new (GetGraph()->GetArena()) CompileOptimizedSlowPathARM64(instruction);
+  codegen_->AddSlowPath(slow_path);
+
+  UseScratchRegisterScope temps(codegen_->GetVIXLAssembler());
+  Register method = temps.AcquireX();
+  Register counter = temps.AcquireW();
+  uint32_t offset = ArtMethod::HotnessCountOffset().Uint32Value();
+  __ Ldr(method, MemOperand(sp, kCurrentMethodStackOffset));
+  __ Ldrh(counter, MemOperand(method, offset));
+  __ Add(counter, counter, 1);
+  __ Strh(counter, MemOperand(method, offset));
+  // The counter is 16 bits wide: it wrapped around to zero if the low half is clear.
+  __ Tst(counter, 0xffff);
+  __ B(eq, slow_path->GetEntryLabel());
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void InstructionCodeGeneratorARM64::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                          HBasicBlock* successor) {
+  if (successor == nullptr &&
+      instruction->IsSuspendCheckEntry() &&
+      GetGraph()->IsCompilingBaseline()) {
+    GenerateHotnessCheck(instruction);
+  }
   SuspendCheckSlowPathARM64* slow_path =
       down_cast<SuspendCheckSlowPathARM64*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
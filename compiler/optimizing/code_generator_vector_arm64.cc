@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_generator_arm64.h"
+
+#include "mirror/array-inl.h"
+
+using namespace vixl;  // NOLINT(build/namespaces)
+
+namespace art {
+namespace arm64 {
+
+using helpers::HeapOperand;
+using helpers::Int64ConstantFrom;
+using helpers::QRegisterFrom;
+using helpers::WRegisterFrom;
+using helpers::XRegisterFrom;
+
+// Vector operations work on the full 128 bits of the NEON registers, and the packed
+// type of an operation selects the arrangement of the lanes.
+
+#define __ GetVIXLAssembler()->
+
+void LocationsBuilderARM64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+    case Primitive::kPrimInt:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case Primitive::kPrimFloat:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorARM64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  FPRegister dst = QRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ Dup(dst.V16B(), WRegisterFrom(locations->InAt(0)));
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ Dup(dst.V8H(), WRegisterFrom(locations->InAt(0)));
+      break;
+    case Primitive::kPrimInt:
+      __ Dup(dst.V4S(), WRegisterFrom(locations->InAt(0)));
+      break;
+    case Primitive::kPrimFloat:
+      __ Dup(dst.V4S(), QRegisterFrom(locations->InAt(0)).V4S(), 0);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderARM64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimInt);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorARM64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Register accumulator = WRegisterFrom(locations->InAt(0));
+  FPRegister src = QRegisterFrom(locations->InAt(1));
+  FPRegister tmp = QRegisterFrom(locations->GetTemp(0));
+  Register out = WRegisterFrom(locations->Out());
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register lanes = temps.AcquireW();
+  switch (instruction->GetReductionKind()) {
+    case HVecReduce::kSum:
+      __ Addv(tmp.S(), src.V4S());
+      __ Fmov(lanes, tmp.S());
+      __ Add(out, accumulator, lanes);
+      break;
+    case HVecReduce::kMin:
+      __ Sminv(tmp.S(), src.V4S());
+      __ Fmov(lanes, tmp.S());
+      __ Cmp(accumulator, lanes);
+      __ Csel(out, accumulator, lanes, lt);
+      break;
+    case HVecReduce::kMax:
+      __ Smaxv(tmp.S(), src.V4S());
+      __ Fmov(lanes, tmp.S());
+      __ Cmp(accumulator, lanes);
+      __ Csel(out, accumulator, lanes, gt);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD reduction " << instruction->GetReductionKind();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector unary operations.
+static void CreateVecUnOpLocations(ArenaAllocator* arena, HVecUnaryOperation* instruction) {
+  LocationSummary* locations = new (arena) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+}
+
+void LocationsBuilderARM64::VisitVecNeg(HVecNeg* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecNeg(HVecNeg* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  FPRegister src = QRegisterFrom(locations->InAt(0));
+  FPRegister dst = QRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ Neg(dst.V16B(), src.V16B());
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ Neg(dst.V8H(), src.V8H());
+      break;
+    case Primitive::kPrimInt:
+      __ Neg(dst.V4S(), src.V4S());
+      break;
+    case Primitive::kPrimFloat:
+      __ Fneg(dst.V4S(), src.V4S());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderARM64::VisitVecNot(HVecNot* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecNot(HVecNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(Primitive::IsIntegralType(instruction->GetPackedType()));
+  __ Not(QRegisterFrom(locations->Out()).V16B(), QRegisterFrom(locations->InAt(0)).V16B());
+}
+
+// Helper to set up locations for vector binary operations, which are non-destructive in NEON.
+static void CreateVecBinOpLocations(ArenaAllocator* arena, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (arena) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+}
+
+void LocationsBuilderARM64::VisitVecAdd(HVecAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecAdd(HVecAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  FPRegister lhs = QRegisterFrom(locations->InAt(0));
+  FPRegister rhs = QRegisterFrom(locations->InAt(1));
+  FPRegister dst = QRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ Add(dst.V16B(), lhs.V16B(), rhs.V16B());
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ Add(dst.V8H(), lhs.V8H(), rhs.V8H());
+      break;
+    case Primitive::kPrimInt:
+      __ Add(dst.V4S(), lhs.V4S(), rhs.V4S());
+      break;
+    case Primitive::kPrimFloat:
+      __ Fadd(dst.V4S(), lhs.V4S(), rhs.V4S());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderARM64::VisitVecSub(HVecSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecSub(HVecSub* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  FPRegister lhs = QRegisterFrom(locations->InAt(0));
+  FPRegister rhs = QRegisterFrom(locations->InAt(1));
+  FPRegister dst = QRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ Sub(dst.V16B(), lhs.V16B(), rhs.V16B());
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ Sub(dst.V8H(), lhs.V8H(), rhs.V8H());
+      break;
+    case Primitive::kPrimInt:
+      __ Sub(dst.V4S(), lhs.V4S(), rhs.V4S());
+      break;
+    case Primitive::kPrimFloat:
+      __ Fsub(dst.V4S(), lhs.V4S(), rhs.V4S());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderARM64::VisitVecMul(HVecMul* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecMul(HVecMul* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  FPRegister lhs = QRegisterFrom(locations->InAt(0));
+  FPRegister rhs = QRegisterFrom(locations->InAt(1));
+  FPRegister dst = QRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ Mul(dst.V16B(), lhs.V16B(), rhs.V16B());
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ Mul(dst.V8H(), lhs.V8H(), rhs.V8H());
+      break;
+    case Primitive::kPrimInt:
+      __ Mul(dst.V4S(), lhs.V4S(), rhs.V4S());
+      break;
+    case Primitive::kPrimFloat:
+      __ Fmul(dst.V4S(), lhs.V4S(), rhs.V4S());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderARM64::VisitVecDiv(HVecDiv* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecDiv(HVecDiv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimFloat);
+  __ Fdiv(QRegisterFrom(locations->Out()).V4S(),
+          QRegisterFrom(locations->InAt(0)).V4S(),
+          QRegisterFrom(locations->InAt(1)).V4S());
+}
+
+void LocationsBuilderARM64::VisitVecMin(HVecMin* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecMin(HVecMin* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimInt);
+  __ Smin(QRegisterFrom(locations->Out()).V4S(),
+          QRegisterFrom(locations->InAt(0)).V4S(),
+          QRegisterFrom(locations->InAt(1)).V4S());
+}
+
+void LocationsBuilderARM64::VisitVecMax(HVecMax* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecMax(HVecMax* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimInt);
+  __ Smax(QRegisterFrom(locations->Out()).V4S(),
+          QRegisterFrom(locations->InAt(0)).V4S(),
+          QRegisterFrom(locations->InAt(1)).V4S());
+}
+
+void LocationsBuilderARM64::VisitVecAnd(HVecAnd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecAnd(HVecAnd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  __ And(QRegisterFrom(locations->Out()).V16B(),
+         QRegisterFrom(locations->InAt(0)).V16B(),
+         QRegisterFrom(locations->InAt(1)).V16B());
+}
+
+void LocationsBuilderARM64::VisitVecOr(HVecOr* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecOr(HVecOr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  __ Orr(QRegisterFrom(locations->Out()).V16B(),
+         QRegisterFrom(locations->InAt(0)).V16B(),
+         QRegisterFrom(locations->InAt(1)).V16B());
+}
+
+void LocationsBuilderARM64::VisitVecXor(HVecXor* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecXor(HVecXor* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  __ Eor(QRegisterFrom(locations->Out()).V16B(),
+         QRegisterFrom(locations->InAt(0)).V16B(),
+         QRegisterFrom(locations->InAt(1)).V16B());
+}
+
+// Helper to set up locations for vector memory operations.
+static void CreateVecMemLocations(ArenaAllocator* arena,
+                                  HVecMemoryOperation* instruction,
+                                  bool is_load) {
+  LocationSummary* locations = new (arena) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+  if (is_load) {
+    locations->SetOut(Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(2, Location::RequiresFpuRegister());
+  }
+}
+
+// The Q-register forms of LDR/STR only scale a register offset by 16, so the element
+// address is materialized in `temp` first.
+MemOperand InstructionCodeGeneratorARM64::VecAddress(HVecMemoryOperation* instruction,
+                                                     Register temp) {
+  LocationSummary* locations = instruction->GetLocations();
+  Register base = WRegisterFrom(locations->InAt(0));
+  Location index = locations->InAt(1);
+  size_t shift = Primitive::ComponentSizeShift(instruction->GetPackedType());
+  uint32_t offset = mirror::Array::DataOffset(1 << shift).Uint32Value();
+  if (index.IsConstant()) {
+    offset += Int64ConstantFrom(index) << shift;
+    return HeapOperand(base, offset);
+  }
+  __ Add(temp, base, offset);
+  __ Add(temp.X(), temp.X(), Operand(XRegisterFrom(index), LSL, shift));
+  return MemOperand(temp.X());
+}
+
+void LocationsBuilderARM64::VisitVecLoad(HVecLoad* instruction) {
+  CreateVecMemLocations(GetGraph()->GetArena(), instruction, /* is_load */ true);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecLoad(HVecLoad* instruction) {
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register temp = temps.AcquireW();
+  MemOperand source = VecAddress(instruction, temp);
+  __ Ldr(QRegisterFrom(instruction->GetLocations()->Out()), source);
+}
+
+void LocationsBuilderARM64::VisitVecStore(HVecStore* instruction) {
+  CreateVecMemLocations(GetGraph()->GetArena(), instruction, /* is_load */ false);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecStore(HVecStore* instruction) {
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register temp = temps.AcquireW();
+  MemOperand destination = VecAddress(instruction, temp);
+  __ Str(QRegisterFrom(instruction->GetLocations()->InAt(2)), destination);
+}
+
+#undef __
+
+}  // namespace arm64
+}  // namespace art
@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_generator_x86_64.h"
+
+#include "mirror/array-inl.h"
+
+namespace art {
+namespace x86_64 {
+
+// Vector operations work on the full 128 bits of the XMM registers, and the packed
+// type of an operation selects the SSE instruction.
+
+#define __ down_cast<X86_64Assembler*>(GetAssembler())->
+
+void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+    case Primitive::kPrimInt:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case Primitive::kPrimFloat:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /* is64bit */ false);
+      __ punpcklbw(dst, dst);
+      __ punpcklwd(dst, dst);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /* is64bit */ false);
+      __ punpcklwd(dst, dst);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimInt:
+      __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /* is64bit */ false);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimFloat:
+      DCHECK(locations->InAt(0).Equals(locations->Out()));
+      __ shufps(dst, dst, Immediate(0));
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimInt);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister accumulator = locations->InAt(0).AsRegister<CpuRegister>();
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister tmp1 = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister tmp2 = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  void (X86_64Assembler::*op)(XmmRegister, XmmRegister) = nullptr;
+  switch (instruction->GetReductionKind()) {
+    case HVecReduce::kSum: op = &X86_64Assembler::paddd; break;
+    case HVecReduce::kMin: op = &X86_64Assembler::pminsd; break;
+    case HVecReduce::kMax: op = &X86_64Assembler::pmaxsd; break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD reduction " << instruction->GetReductionKind();
+      UNREACHABLE();
+  }
+  X86_64Assembler* assembler = GetAssembler();
+  // Fold the upper half onto the lower half, and then the odd lane onto the
+  // even lane, which leaves the reduction of all four lanes in lane 0.
+  __ pshufd(tmp1, src, Immediate(0x4E));
+  (assembler->*op)(tmp1, src);
+  __ pshufd(tmp2, tmp1, Immediate(0xB1));
+  (assembler->*op)(tmp1, tmp2);
+  __ movd(tmp2, accumulator, /* is64bit */ false);
+  (assembler->*op)(tmp1, tmp2);
+  __ movd(out, tmp1, /* is64bit */ false);
+}
+
+// Helper to set up locations for vector unary operations.
+static void CreateVecUnOpLocations(ArenaAllocator* arena, HVecUnaryOperation* instruction) {
+  LocationSummary* locations = new (arena) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  // The output is cleared before the input is read.
+  locations->SetOut(Location::RequiresFpuRegister(), Location::kOutputOverlap);
+}
+
+void LocationsBuilderX86_64::VisitVecNeg(HVecNeg* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  __ xorps(dst, dst);
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ psubb(dst, src);
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ psubw(dst, src);
+      break;
+    case Primitive::kPrimInt:
+      __ psubd(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecNot(HVecNot* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(Primitive::IsIntegralType(instruction->GetPackedType()));
+  __ pcmpeqd(dst, dst);  // all ones
+  __ xorps(dst, src);
+}
+
+// Helper to set up locations for vector binary operations, which are destructive in SSE.
+static void CreateVecBinOpLocations(ArenaAllocator* arena, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (arena) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+void LocationsBuilderX86_64::VisitVecAdd(HVecAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ paddb(dst, src);
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ paddw(dst, src);
+      break;
+    case Primitive::kPrimInt:
+      __ paddd(dst, src);
+      break;
+    case Primitive::kPrimFloat:
+      __ addps(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecSub(HVecSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimByte:
+      __ psubb(dst, src);
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ psubw(dst, src);
+      break;
+    case Primitive::kPrimInt:
+      __ psubd(dst, src);
+      break;
+    case Primitive::kPrimFloat:
+      __ subps(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecMul(HVecMul* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  switch (instruction->GetPackedType()) {
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ pmullw(dst, src);
+      break;
+    case Primitive::kPrimInt:
+      __ pmulld(dst, src);
+      break;
+    case Primitive::kPrimFloat:
+      __ mulps(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecDiv(HVecDiv* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimFloat);
+  __ divps(locations->Out().AsFpuRegister<XmmRegister>(),
+           locations->InAt(1).AsFpuRegister<XmmRegister>());
+}
+
+void LocationsBuilderX86_64::VisitVecMin(HVecMin* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecMin(HVecMin* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimInt);
+  __ pminsd(locations->Out().AsFpuRegister<XmmRegister>(),
+            locations->InAt(1).AsFpuRegister<XmmRegister>());
+}
+
+void LocationsBuilderX86_64::VisitVecMax(HVecMax* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecMax(HVecMax* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  DCHECK_EQ(instruction->GetPackedType(), Primitive::kPrimInt);
+  __ pmaxsd(locations->Out().AsFpuRegister<XmmRegister>(),
+            locations->InAt(1).AsFpuRegister<XmmRegister>());
+}
+
+void LocationsBuilderX86_64::VisitVecAnd(HVecAnd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  __ andps(locations->Out().AsFpuRegister<XmmRegister>(),
+           locations->InAt(1).AsFpuRegister<XmmRegister>());
+}
+
+void LocationsBuilderX86_64::VisitVecOr(HVecOr* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  __ orps(locations->Out().AsFpuRegister<XmmRegister>(),
+          locations->InAt(1).AsFpuRegister<XmmRegister>());
+}
+
+void LocationsBuilderX86_64::VisitVecXor(HVecXor* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetArena(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  __ xorps(locations->Out().AsFpuRegister<XmmRegister>(),
+           locations->InAt(1).AsFpuRegister<XmmRegister>());
+}
+
+// Helper to set up locations for vector memory operations.
+static void CreateVecMemLocations(ArenaAllocator* arena,
+                                  HVecMemoryOperation* instruction,
+                                  bool is_load) {
+  LocationSummary* locations = new (arena) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+  if (is_load) {
+    locations->SetOut(Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(2, Location::RequiresFpuRegister());
+  }
+}
+
+// Helper to compute the address of the first element accessed by a vector memory operation.
+static Address VecAddress(LocationSummary* locations, size_t size) {
+  CpuRegister base = locations->InAt(0).AsRegister<CpuRegister>();
+  Location index = locations->InAt(1);
+  ScaleFactor scale = TIMES_1;
+  switch (size) {
+    case 2: scale = TIMES_2; break;
+    case 4: scale = TIMES_4; break;
+    case 8: scale = TIMES_8; break;
+    default: break;
+  }
+  uint32_t offset = mirror::Array::DataOffset(size).Uint32Value();
+  if (index.IsConstant()) {
+    return Address(base, (index.GetConstant()->AsIntConstant()->GetValue() << scale) + offset);
+  }
+  return Address(base, index.AsRegister<CpuRegister>(), scale, offset);
+}
+
+void LocationsBuilderX86_64::VisitVecLoad(HVecLoad* instruction) {
+  CreateVecMemLocations(GetGraph()->GetArena(), instruction, /* is_load */ true);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t size = Primitive::ComponentSize(instruction->GetPackedType());
+  __ movups(locations->Out().AsFpuRegister<XmmRegister>(), VecAddress(locations, size));
+}
+
+void LocationsBuilderX86_64::VisitVecStore(HVecStore* instruction) {
+  CreateVecMemLocations(GetGraph()->GetArena(), instruction, /* is_load */ false);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t size = Primitive::ComponentSize(instruction->GetPackedType());
+  __ movups(VecAddress(locations, size), locations->InAt(2).AsFpuRegister<XmmRegister>());
+}
+
+#undef __
+
+}  // namespace x86_64
+}  // namespace art
@@ -202,6 +202,32 @@ class SuspendCheckSlowPathX86 : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(SuspendCheckSlowPathX86);
 };
 
+// Requests an optimized compilation of a hot method compiled as baseline code.
+class CompileOptimizedSlowPathX86 : public SlowPathCode {
+ public:
+  explicit CompileOptimizedSlowPathX86(HSuspendCheck* instruction) : SlowPathCode(instruction) {}
+
+  void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
+    CodeGeneratorX86* x86_codegen = down_cast<CodeGeneratorX86*>(codegen);
+    __ Bind(GetEntryLabel());
+    SaveLiveRegisters(codegen, instruction_->GetLocations());
+    InvokeRuntimeCallingConvention calling_convention;
+    __ movl(calling_convention.GetRegisterAt(0), Address(ESP, kCurrentMethodStackOffset));
+    x86_codegen->InvokeRuntime(QUICK_ENTRY_POINT(pCompileOptimized),
+                               instruction_,
+                               instruction_->GetDexPc(),
+                               this);
+    CheckEntrypointTypes<kQuickCompileOptimized, void, ArtMethod*>();
+    RestoreLiveRegisters(codegen, instruction_->GetLocations());
+    __ jmp(GetExitLabel());
+  }
+
+  const char* GetDescription() const OVERRIDE { return "CompileOptimizedSlowPathX86"; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CompileOptimizedSlowPathX86);
+};
+
 class LoadStringSlowPathX86 : public SlowPathCode {
  public:
   explicit LoadStringSlowPathX86(HLoadString* instruction): SlowPathCode(instruction) {}
@@ -5583,8 +5609,28 @@ void InstructionCodeGeneratorX86::VisitSuspendCheck(HSuspendCheck* instruction)
   GenerateSuspendCheck(instruction, nullptr);
 }
 
+void InstructionCodeGeneratorX86::GenerateHotnessCheck(HSuspendCheck* instruction) {
+  SlowPathCode* slow_path = new (GetGraph()->GetArena()) CompileOptimizedSlowPathX86(instruction);
+  codegen_->AddSlowPath(slow_path);
+
+  // Baseline code is only compiled by the JIT, so the method address is known and
+  // the counter can be incremented in place without a temporary register.
+  ArtMethod* method = GetGraph()->GetArtMethod();
+  DCHECK(method != nullptr);
+  __ addw(Address::Absolute(reinterpret_cast<uintptr_t>(method) +
+                            ArtMethod::HotnessCountOffset().Uint32Value()),
+          Immediate(1));
+  __ j(kZero, slow_path->GetEntryLabel());
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void InstructionCodeGeneratorX86::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                        HBasicBlock* successor) {
+  if (successor == nullptr &&
+      instruction->IsSuspendCheckEntry() &&
+      GetGraph()->IsCompilingBaseline()) {
+    GenerateHotnessCheck(instruction);
+  }
   SuspendCheckSlowPathX86* slow_path =
       down_cast<SuspendCheckSlowPathX86*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
@@ -207,6 +207,9 @@ class InstructionCodeGeneratorX86 : public InstructionCodeGenerator {
   // is the block to branch to if the suspend check is not needed, and after
   // the suspend call.
   void GenerateSuspendCheck(HSuspendCheck* check, HBasicBlock* successor);
+  // Count the entries of a baseline compiled method, and request its optimized
+  // compilation when it gets hot.
+  void GenerateHotnessCheck(HSuspendCheck* check);
   void GenerateClassInitializationCheck(SlowPathCode* slow_path, Register class_reg);
   void HandleBitwiseOperation(HBinaryOperation* instruction);
   void GenerateDivRemIntegral(HBinaryOperation* instruction);
@@ -428,6 +431,8 @@ class CodeGeneratorX86 : public CodeGenerator {
     block_labels_ = CommonInitializeLabels<Label>();
   }
 
+  bool SupportsBaselineHotnessCounting() const OVERRIDE { return true; }
+
   bool NeedsTwoRegisters(Primitive::Type type) const OVERRIDE {
     return type == Primitive::kPrimLong;
   }
@@ -180,6 +180,34 @@ class SuspendCheckSlowPathX86_64 : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(SuspendCheckSlowPathX86_64);
 };
 
+// Requests an optimized compilation of a hot method compiled as baseline code.
+class CompileOptimizedSlowPathX86_64 : public SlowPathCode {
+ public:
+  explicit CompileOptimizedSlowPathX86_64(HSuspendCheck* instruction)
+      : SlowPathCode(instruction) {}
+
+  void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
+    CodeGeneratorX86_64* x86_64_codegen = down_cast<CodeGeneratorX86_64*>(codegen);
+    __ Bind(GetEntryLabel());
+    SaveLiveRegisters(codegen, instruction_->GetLocations());
+    InvokeRuntimeCallingConvention calling_convention;
+    __ movq(CpuRegister(calling_convention.GetRegisterAt(0)),
+            Address(CpuRegister(RSP), kCurrentMethodStackOffset));
+    x86_64_codegen->InvokeRuntime(QUICK_ENTRY_POINT(pCompileOptimized),
+                                  instruction_,
+                                  instruction_->GetDexPc(),
+                                  this);
+    CheckEntrypointTypes<kQuickCompileOptimized, void, ArtMethod*>();
+    RestoreLiveRegisters(codegen, instruction_->GetLocations());
+    __ jmp(GetExitLabel());
+  }
+
+  const char* GetDescription() const OVERRIDE { return "CompileOptimizedSlowPathX86_64"; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CompileOptimizedSlowPathX86_64);
+};
+
 class BoundsCheckSlowPathX86_64 : public SlowPathCode {
  public:
   explicit BoundsCheckSlowPathX86_64(HBoundsCheck* instruction)
@@ -1159,6 +1187,8 @@ void CodeGeneratorX86_64::Move(Location destination, Location source) {
       }
     } else if (source.IsStackSlot()) {
       __ movss(dest, Address(CpuRegister(RSP), source.GetStackIndex()));
+    } else if (source.IsSIMDStackSlot()) {
+      __ movups(dest, Address(CpuRegister(RSP), source.GetStackIndex()));
     } else {
       DCHECK(source.IsDoubleStackSlot());
       __ movsd(dest, Address(CpuRegister(RSP), source.GetStackIndex()));
@@ -1179,6 +1209,18 @@ void CodeGeneratorX86_64::Move(Location destination, Location source) {
       __ movl(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
       __ movl(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
     }
+  } else if (destination.IsSIMDStackSlot()) {
+    if (source.IsFpuRegister()) {
+      __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                source.AsFpuRegister<XmmRegister>());
+    } else {
+      DCHECK(source.IsSIMDStackSlot());
+      for (size_t offset = 0; offset < 2 * kX86_64WordSize; offset += kX86_64WordSize) {
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset),
+                CpuRegister(TMP));
+      }
+    }
   } else {
     DCHECK(destination.IsDoubleStackSlot());
     if (source.IsRegister()) {
@@ -5078,8 +5120,25 @@ void InstructionCodeGeneratorX86_64::VisitSuspendCheck(HSuspendCheck* instructio
   GenerateSuspendCheck(instruction, nullptr);
 }
 
+void InstructionCodeGeneratorX86_64::GenerateHotnessCheck(HSuspendCheck* instruction) {
+  SlowPathCode* slow_path =
+      new (GetGraph()->GetArena()) CompileOptimizedSlowPathX86_64(instruction);
+  codegen_->AddSlowPath(slow_path);
+
+  __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), kCurrentMethodStackOffset));
+  __ addw(Address(CpuRegister(TMP), ArtMethod::HotnessCountOffset().Int32Value()),
+          Immediate(1));
+  __ j(kZero, slow_path->GetEntryLabel());
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void InstructionCodeGeneratorX86_64::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                           HBasicBlock* successor) {
+  if (successor == nullptr &&
+      instruction->IsSuspendCheckEntry() &&
+      GetGraph()->IsCompilingBaseline()) {
+    GenerateHotnessCheck(instruction);
+  }
   SuspendCheckSlowPathX86_64* slow_path =
       down_cast<SuspendCheckSlowPathX86_64*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
@@ -5150,6 +5209,18 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
       __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
       __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
     }
+  } else if (source.IsSIMDStackSlot()) {
+    if (destination.IsFpuRegister()) {
+      __ movups(destination.AsFpuRegister<XmmRegister>(),
+                Address(CpuRegister(RSP), source.GetStackIndex()));
+    } else {
+      DCHECK(destination.IsSIMDStackSlot()) << destination;
+      for (size_t offset = 0; offset < 2 * kX86_64WordSize; offset += kX86_64WordSize) {
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset),
+                CpuRegister(TMP));
+      }
+    }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
     if (constant->IsIntConstant() || constant->IsNullConstant()) {
@@ -5200,6 +5271,9 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
+    } else if (destination.IsSIMDStackSlot()) {
+      __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                source.AsFpuRegister<XmmRegister>());
     } else {
       DCHECK(destination.IsDoubleStackSlot()) << destination;
       __ movsd(Address(CpuRegister(RSP), destination.GetStackIndex()),
@@ -5264,6 +5338,17 @@ void ParallelMoveResolverX86_64::Exchange64(XmmRegister reg, int mem) {
   __ movd(reg, CpuRegister(TMP));
 }
 
+void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
+  // Go through a temporary stack slot, as there is no 128-bit scratch register.
+  int extra_slot = 2 * kX86_64WordSize;
+  __ subq(CpuRegister(RSP), Immediate(extra_slot));
+  __ movups(Address(CpuRegister(RSP), 0), reg);
+  Exchange64(0, mem + extra_slot);
+  Exchange64(kX86_64WordSize, mem + extra_slot + kX86_64WordSize);
+  __ movups(reg, Address(CpuRegister(RSP), 0));
+  __ addq(CpuRegister(RSP), Immediate(extra_slot));
+}
+
 void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   MoveOperands* move = moves_[index];
   Location source = move->GetSource();
@@ -5284,9 +5369,18 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsDoubleStackSlot()) {
     Exchange64(destination.GetStackIndex(), source.GetStackIndex());
   } else if (source.IsFpuRegister() && destination.IsFpuRegister()) {
-    __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
-    __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
-    __ movd(destination.AsFpuRegister<XmmRegister>(), CpuRegister(TMP));
+    if (codegen_->GetGraph()->HasSIMD()) {
+      // Swap the full 128 bits, which the 64-bit temporary would not preserve.
+      XmmRegister reg1 = source.AsFpuRegister<XmmRegister>();
+      XmmRegister reg2 = destination.AsFpuRegister<XmmRegister>();
+      __ xorps(reg1, reg2);
+      __ xorps(reg2, reg1);
+      __ xorps(reg1, reg2);
+    } else {
+      __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
+      __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
+      __ movd(destination.AsFpuRegister<XmmRegister>(), CpuRegister(TMP));
+    }
   } else if (source.IsFpuRegister() && destination.IsStackSlot()) {
     Exchange32(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
   } else if (source.IsStackSlot() && destination.IsFpuRegister()) {
@@ -5295,6 +5389,14 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
     Exchange64(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+  } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
+    Exchange64(destination.GetStackIndex(), source.GetStackIndex());
+    Exchange64(destination.GetStackIndex() + kX86_64WordSize,
+               source.GetStackIndex() + kX86_64WordSize);
+  } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
+    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+  } else if (source.IsSIMDStackSlot() && destination.IsFpuRegister()) {
+    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
@@ -44,7 +44,7 @@
 #include "nodes.h"
 #include "optimizing_unit_test.h"
 #include "prepare_for_register_allocation.h"
-#include "register_allocator.h"
+#include "register_allocator_graph_color.h"
 #include "ssa_liveness_analysis.h"
 #include "utils.h"
 #include "utils/arm/managed_register_arm.h"
@@ -200,8 +200,15 @@ static void Run(const InternalCodeAllocator& allocator,
   VerifyGeneratedCode(target_isa, f, has_result, expected);
 }
 
+// The instruction set and register allocation strategy a graph is compiled for.
+struct CodegenTargetConfig {
+  InstructionSet isa;
+  RegisterAllocator::Strategy strategy;
+};
+
 template <typename Expected>
 static void RunCode(CodeGenerator* codegen,
+                    RegisterAllocator::Strategy strategy,
                     HGraph* graph,
                     std::function<void(HGraph*)> hook_before_codegen,
                     bool has_result,
@@ -219,7 +226,7 @@ static void RunCode(CodeGenerator* codegen,
 
   PrepareForRegisterAllocation(graph).Run();
   liveness.Analyze();
-  RegisterAllocator(graph->GetArena(), codegen, liveness).AllocateRegisters();
+  RegisterAllocator::Create(graph->GetArena(), codegen, liveness, strategy)->AllocateRegisters();
   hook_before_codegen(graph);
 
   InternalCodeAllocator allocator;
@@ -228,47 +235,49 @@ static void RunCode(CodeGenerator* codegen,
 }
 
 template <typename Expected>
-static void RunCode(InstructionSet target_isa,
+static void RunCode(const CodegenTargetConfig& target_config,
                     HGraph* graph,
                     std::function<void(HGraph*)> hook_before_codegen,
                     bool has_result,
                     Expected expected) {
+  InstructionSet target_isa = target_config.isa;
+  RegisterAllocator::Strategy strategy = target_config.strategy;
   CompilerOptions compiler_options;
   if (target_isa == kArm || target_isa == kThumb2) {
     std::unique_ptr<const ArmInstructionSetFeatures> features_arm(
         ArmInstructionSetFeatures::FromCppDefines());
     TestCodeGeneratorARM codegenARM(graph, *features_arm.get(), compiler_options);
-    RunCode(&codegenARM, graph, hook_before_codegen, has_result, expected);
+    RunCode(&codegenARM, strategy, graph, hook_before_codegen, has_result, expected);
   } else if (target_isa == kArm64) {
     std::unique_ptr<const Arm64InstructionSetFeatures> features_arm64(
         Arm64InstructionSetFeatures::FromCppDefines());
     arm64::CodeGeneratorARM64 codegenARM64(graph, *features_arm64.get(), compiler_options);
-    RunCode(&codegenARM64, graph, hook_before_codegen, has_result, expected);
+    RunCode(&codegenARM64, strategy, graph, hook_before_codegen, has_result, expected);
   } else if (target_isa == kX86) {
     std::unique_ptr<const X86InstructionSetFeatures> features_x86(
         X86InstructionSetFeatures::FromCppDefines());
     x86::CodeGeneratorX86 codegenX86(graph, *features_x86.get(), compiler_options);
-    RunCode(&codegenX86, graph, hook_before_codegen, has_result, expected);
+    RunCode(&codegenX86, strategy, graph, hook_before_codegen, has_result, expected);
   } else if (target_isa == kX86_64) {
     std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
         X86_64InstructionSetFeatures::FromCppDefines());
     x86_64::CodeGeneratorX86_64 codegenX86_64(graph, *features_x86_64.get(), compiler_options);
-    RunCode(&codegenX86_64, graph, hook_before_codegen, has_result, expected);
+    RunCode(&codegenX86_64, strategy, graph, hook_before_codegen, has_result, expected);
   } else if (target_isa == kMips) {
     std::unique_ptr<const MipsInstructionSetFeatures> features_mips(
         MipsInstructionSetFeatures::FromCppDefines());
     mips::CodeGeneratorMIPS codegenMIPS(graph, *features_mips.get(), compiler_options);
-    RunCode(&codegenMIPS, graph, hook_before_codegen, has_result, expected);
+    RunCode(&codegenMIPS, strategy, graph, hook_before_codegen, has_result, expected);
   } else if (target_isa == kMips64) {
     std::unique_ptr<const Mips64InstructionSetFeatures> features_mips64(
         Mips64InstructionSetFeatures::FromCppDefines());
     mips64::CodeGeneratorMIPS64 codegenMIPS64(graph, *features_mips64.get(), compiler_options);
-    RunCode(&codegenMIPS64, graph, hook_before_codegen, has_result, expected);
+    RunCode(&codegenMIPS64, strategy, graph, hook_before_codegen, has_result, expected);
   }
 }
 
-static ::std::vector<InstructionSet> GetTargetISAs() {
-  ::std::vector<InstructionSet> v;
+static ::std::vector<CodegenTargetConfig> GetTargetConfigs() {
+  ::std::vector<CodegenTargetConfig> v;
   // Add all ISAs that are executable on hardware or on simulator.
   const ::std::vector<InstructionSet> executable_isa_candidates = {
     kArm,
@@ -282,7 +291,11 @@ static ::std::vector<InstructionSet> GetTargetISAs() {
 
   for (auto target_isa : executable_isa_candidates) {
     if (CanExecute(target_isa)) {
-      v.push_back(target_isa);
+      v.push_back({target_isa, RegisterAllocator::kRegisterAllocatorLinearScan});
+      // Also run every graph through the graph coloring allocator where it is supported.
+      if (RegisterAllocatorGraphColor::CanColorFor(target_isa)) {
+        v.push_back({target_isa, RegisterAllocator::kRegisterAllocatorGraphColor});
+      }
     }
   }
 
@@ -292,26 +305,26 @@ static ::std::vector<InstructionSet> GetTargetISAs() {
 static void TestCode(const uint16_t* data,
                      bool has_result = false,
                      int32_t expected = 0) {
-  for (InstructionSet target_isa : GetTargetISAs()) {
+  for (const CodegenTargetConfig& target_config : GetTargetConfigs()) {
     ArenaPool pool;
     ArenaAllocator arena(&pool);
     HGraph* graph = CreateCFG(&arena, data);
     // Remove suspend checks, they cannot be executed in this context.
     RemoveSuspendChecks(graph);
-    RunCode(target_isa, graph, [](HGraph*) {}, has_result, expected);
+    RunCode(target_config, graph, [](HGraph*) {}, has_result, expected);
   }
 }
 
 static void TestCodeLong(const uint16_t* data,
                          bool has_result,
                          int64_t expected) {
-  for (InstructionSet target_isa : GetTargetISAs()) {
+  for (const CodegenTargetConfig& target_config : GetTargetConfigs()) {
     ArenaPool pool;
     ArenaAllocator arena(&pool);
     HGraph* graph = CreateCFG(&arena, data, Primitive::kPrimLong);
     // Remove suspend checks, they cannot be executed in this context.
     RemoveSuspendChecks(graph);
-    RunCode(target_isa, graph, [](HGraph*) {}, has_result, expected);
+    RunCode(target_config, graph, [](HGraph*) {}, has_result, expected);
   }
 }
 
@@ -628,7 +641,7 @@ TEST_F(CodegenTest, ReturnMulIntLit16) {
 }
 
 TEST_F(CodegenTest, NonMaterializedCondition) {
-  for (InstructionSet target_isa : GetTargetISAs()) {
+  for (const CodegenTargetConfig& target_config : GetTargetConfigs()) {
     ArenaPool pool;
     ArenaAllocator allocator(&pool);
 
@@ -676,12 +689,12 @@ TEST_F(CodegenTest, NonMaterializedCondition) {
       block->InsertInstructionBefore(move, block->GetLastInstruction());
     };
 
-    RunCode(target_isa, graph, hook_before_codegen, true, 0);
+    RunCode(target_config, graph, hook_before_codegen, true, 0);
   }
 }
 
 TEST_F(CodegenTest, MaterializedCondition1) {
-  for (InstructionSet target_isa : GetTargetISAs()) {
+  for (const CodegenTargetConfig& target_config : GetTargetConfigs()) {
     // Check that condition are materialized correctly. A materialized condition
     // should yield `1` if it evaluated to true, and `0` otherwise.
     // We force the materialization of comparisons for different combinations of
@@ -723,13 +736,13 @@ TEST_F(CodegenTest, MaterializedCondition1) {
         HParallelMove* move = new (graph_in->GetArena()) HParallelMove(graph_in->GetArena());
         block->InsertInstructionBefore(move, block->GetLastInstruction());
       };
-      RunCode(target_isa, graph, hook_before_codegen, true, lhs[i] < rhs[i]);
+      RunCode(target_config, graph, hook_before_codegen, true, lhs[i] < rhs[i]);
     }
   }
 }
 
 TEST_F(CodegenTest, MaterializedCondition2) {
-  for (InstructionSet target_isa : GetTargetISAs()) {
+  for (const CodegenTargetConfig& target_config : GetTargetConfigs()) {
     // Check that HIf correctly interprets a materialized condition.
     // We force the materialization of comparisons for different combinations of
     // inputs. An HIf takes the materialized combination as input and returns a
@@ -791,7 +804,7 @@ TEST_F(CodegenTest, MaterializedCondition2) {
         HParallelMove* move = new (graph_in->GetArena()) HParallelMove(graph_in->GetArena());
         block->InsertInstructionBefore(move, block->GetLastInstruction());
       };
-      RunCode(target_isa, graph, hook_before_codegen, true, lhs[i] < rhs[i]);
+      RunCode(target_config, graph, hook_before_codegen, true, lhs[i] < rhs[i]);
     }
   }
 }
@@ -820,7 +833,7 @@ static void TestComparison(IfCondition condition,
                            int64_t i,
                            int64_t j,
                            Primitive::Type type,
-                           const InstructionSet target_isa) {
+                           const CodegenTargetConfig& target_config) {
   ArenaPool pool;
   ArenaAllocator allocator(&pool);
   HGraph* graph = CreateGraph(&allocator);
@@ -902,23 +915,23 @@ static void TestComparison(IfCondition condition,
   block->AddInstruction(new (&allocator) HReturn(comparison));
 
   graph->BuildDominatorTree();
-  RunCode(target_isa, graph, [](HGraph*) {}, true, expected_result);
+  RunCode(target_config, graph, [](HGraph*) {}, true, expected_result);
 }
 
 TEST_F(CodegenTest, ComparisonsInt) {
-  for (InstructionSet target_isa : GetTargetISAs()) {
+  for (const CodegenTargetConfig& target_config : GetTargetConfigs()) {
     for (int64_t i = -1; i <= 1; i++) {
       for (int64_t j = -1; j <= 1; j++) {
-        TestComparison(kCondEQ, i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondNE, i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondLT, i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondLE, i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondGT, i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondGE, i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondB,  i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondBE, i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondA,  i, j, Primitive::kPrimInt, target_isa);
-        TestComparison(kCondAE, i, j, Primitive::kPrimInt, target_isa);
+        TestComparison(kCondEQ, i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondNE, i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondLT, i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondLE, i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondGT, i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondGE, i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondB,  i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondBE, i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondA,  i, j, Primitive::kPrimInt, target_config);
+        TestComparison(kCondAE, i, j, Primitive::kPrimInt, target_config);
       }
     }
   }
@@ -930,23 +943,23 @@ TEST_F(CodegenTest, ComparisonsLong) {
     return;
   }
 
-  for (InstructionSet target_isa : GetTargetISAs()) {
-    if (target_isa == kMips || target_isa == kMips64) {
+  for (const CodegenTargetConfig& target_config : GetTargetConfigs()) {
+    if (target_config.isa == kMips || target_config.isa == kMips64) {
       continue;
     }
 
     for (int64_t i = -1; i <= 1; i++) {
       for (int64_t j = -1; j <= 1; j++) {
-        TestComparison(kCondEQ, i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondNE, i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondLT, i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondLE, i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondGT, i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondGE, i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondB,  i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondBE, i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondA,  i, j, Primitive::kPrimLong, target_isa);
-        TestComparison(kCondAE, i, j, Primitive::kPrimLong, target_isa);
+        TestComparison(kCondEQ, i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondNE, i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondLT, i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondLE, i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondGT, i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondGE, i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondB,  i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondBE, i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondA,  i, j, Primitive::kPrimLong, target_config);
+        TestComparison(kCondAE, i, j, Primitive::kPrimLong, target_config);
       }
     }
   }
@@ -86,6 +86,11 @@ static inline vixl::FPRegister SRegisterFrom(Location location) {
   return vixl::FPRegister::SRegFromCode(location.reg());
 }
 
+static inline vixl::FPRegister QRegisterFrom(Location location) {
+  DCHECK(location.IsFpuRegister()) << location;
+  return vixl::FPRegister::QRegFromCode(location.reg());
+}
+
 static inline vixl::FPRegister FPRegisterFrom(Location location, Primitive::Type type) {
   DCHECK(Primitive::IsFloatingPointType(type)) << type;
   return type == Primitive::kPrimDouble ? DRegisterFrom(location) : SRegisterFrom(location);
@@ -30,6 +30,7 @@
 #include "intrinsics.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jit/offline_profiling_info.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
 #include "nodes.h"
@@ -334,6 +335,8 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
         return false;
       }
     }
+  } else if (compiler_driver_->GetProfileCompilationInfo() != nullptr) {
+    return TryInlineFromOfflineInlineCache(invoke_instruction, resolved_method);
   }
 
   VLOG(compiler) << "Interface or virtual call to "
@@ -342,6 +345,61 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
   return false;
 }
 
+bool HInliner::TryInlineFromOfflineInlineCache(HInvoke* invoke_instruction,
+                                               ArtMethod* resolved_method) {
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  uint32_t method_index = invoke_instruction->GetDexMethodIndex();
+  MethodReference caller_ref(&caller_dex_file, caller_compilation_unit_.GetDexMethodIndex());
+  const ProfileCompilationInfo::DexPcData* data =
+      compiler_driver_->GetProfileCompilationInfo()->FindInlineCache(
+          caller_ref, invoke_instruction->GetDexPc());
+  if (data == nullptr || (data->classes.empty() && !data->is_megamorphic)) {
+    VLOG(compiler) << "Interface or virtual call to "
+                   << PrettyMethod(method_index, caller_dex_file)
+                   << " has no usable profile data and is not inlined";
+    return false;
+  }
+  if (data->is_megamorphic) {
+    VLOG(compiler) << "Interface or virtual call to "
+                   << PrettyMethod(method_index, caller_dex_file)
+                   << " is megamorphic and not inlined";
+    MaybeRecordStat(kMegamorphicCall);
+    return false;
+  }
+
+  // The profile records receiver types as type indices of the caller's dex file.
+  // Only use the ones the compiler already resolved.
+  mirror::DexCache* dex_cache = caller_compilation_unit_.GetDexCache().Get();
+  std::vector<mirror::Class*> types;
+  for (uint16_t type_idx : data->classes) {
+    mirror::Class* cls = dex_cache->GetResolvedType(type_idx);
+    if (cls == nullptr) {
+      VLOG(compiler) << "Interface or virtual call to "
+                     << PrettyMethod(method_index, caller_dex_file)
+                     << " has unresolved receiver types in the profile and is not inlined";
+      return false;
+    }
+    types.push_back(cls);
+  }
+
+  InlineCache ic;
+  ic.SetTypes(invoke_instruction->GetDexPc(), types);
+  if (ic.IsMonomorphic()) {
+    MaybeRecordStat(kMonomorphicCall);
+    return TryInlineMonomorphicCall(invoke_instruction, resolved_method, ic);
+  } else {
+    DCHECK(ic.IsPolymorphic());
+    MaybeRecordStat(kPolymorphicCall);
+    return TryInlinePolymorphicCall(invoke_instruction, resolved_method, ic);
+  }
+}
+
+bool HInliner::IsOutermostReferrer(mirror::Class* cls) const {
+  // Under AOT, the outermost method may not have been resolved.
+  ArtMethod* outermost_method = outermost_graph_->GetArtMethod();
+  return outermost_method != nullptr && cls == outermost_method->GetDeclaringClass();
+}
+
 HInstanceFieldGet* HInliner::BuildGetReceiverClass(ClassLinker* class_linker,
                                                    HInstruction* receiver,
                                                    uint32_t dex_pc) const {
@@ -398,8 +456,7 @@ bool HInliner::TryInlineMonomorphicCall(HInvoke* invoke_instruction,
   }
 
   // We successfully inlined, now add a guard.
-  bool is_referrer =
-      (ic.GetMonomorphicType() == outermost_graph_->GetArtMethod()->GetDeclaringClass());
+  bool is_referrer = IsOutermostReferrer(ic.GetMonomorphicType());
   AddTypeGuard(receiver,
                cursor,
                bb_cursor,
@@ -433,14 +490,17 @@ HInstruction* HInliner::AddTypeGuard(HInstruction* receiver,
 
   const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
   // Note that we will just compare the classes, so we don't need Java semantics access checks.
-  // Also, the caller of `AddTypeGuard` must have guaranteed that the class is in the dex cache.
+  // Under JIT, the caller of `AddTypeGuard` must have guaranteed that the class is in the
+  // dex cache. Under AOT, the class comes from the profile and may not be resolved yet at
+  // runtime.
+  bool is_in_dex_cache = Runtime::Current()->UseJitCompilation();
   HLoadClass* load_class = new (graph_->GetArena()) HLoadClass(graph_->GetCurrentMethod(),
                                                                class_index,
                                                                caller_dex_file,
                                                                is_referrer,
                                                                invoke_instruction->GetDexPc(),
                                                                /* needs_access_check */ false,
-                                                               /* is_in_dex_cache */ true);
+                                                               is_in_dex_cache);
 
   HNotEqual* compare = new (graph_->GetArena()) HNotEqual(load_class, receiver_class);
   // TODO: Extend reference type propagation to understand the guard.
@@ -450,6 +510,9 @@ HInstruction* HInliner::AddTypeGuard(HInstruction* receiver,
     bb_cursor->InsertInstructionBefore(receiver_class, bb_cursor->GetFirstInstruction());
   }
   bb_cursor->InsertInstructionAfter(load_class, receiver_class);
+  if (load_class->NeedsEnvironment()) {
+    load_class->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+  }
   bb_cursor->InsertInstructionAfter(compare, load_class);
   if (with_deoptimization) {
     HDeoptimize* deoptimize = new (graph_->GetArena()) HDeoptimize(
@@ -466,7 +529,9 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, ic)) {
+  // Checking the target method embeds its address in the code, which only works under JIT.
+  if (Runtime::Current()->UseJitCompilation() &&
+      TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, ic)) {
     return true;
   }
 
@@ -502,7 +567,7 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
       all_targets_inlined = false;
     } else {
       one_target_inlined = true;
-      bool is_referrer = (ic.GetTypeAt(i) == outermost_graph_->GetArtMethod()->GetDeclaringClass());
+      bool is_referrer = IsOutermostReferrer(ic.GetTypeAt(i));
 
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
@@ -118,6 +118,15 @@ class HInliner : public HOptimization {
                                             const InlineCache& ic)
     SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Try to inline the targets of a virtual or interface call using the receiver
+  // types recorded for it in the offline profile (AOT only).
+  bool TryInlineFromOfflineInlineCache(HInvoke* invoke_instruction, ArtMethod* resolved_method)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Whether `cls` is the declaring class of the outermost method being compiled.
+  bool IsOutermostReferrer(mirror::Class* cls) const
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
 
   HInstanceFieldGet* BuildGetReceiverClass(ClassLinker* class_linker,
                                            HInstruction* receiver,
@@ -15,6 +15,8 @@
  */
 
 #include "load_store_elimination.h"
+
+#include "escape.h"
 #include "side_effects_analysis.h"
 
 #include <iostream>
@@ -32,53 +34,7 @@ constexpr size_t kMaxNumberOfHeapLocations = 32;
 class ReferenceInfo : public ArenaObject<kArenaAllocMisc> {
  public:
   ReferenceInfo(HInstruction* reference, size_t pos) : reference_(reference), position_(pos) {
-    is_singleton_ = true;
-    is_singleton_and_not_returned_ = true;
-    if (!reference_->IsNewInstance() && !reference_->IsNewArray()) {
-      // For references not allocated in the method, don't assume anything.
-      is_singleton_ = false;
-      is_singleton_and_not_returned_ = false;
-      return;
-    }
-
-    // Visit all uses to determine if this reference can spread into the heap,
-    // a method call, etc.
-    for (const HUseListNode<HInstruction*>& use : reference_->GetUses()) {
-      HInstruction* user = use.GetUser();
-      DCHECK(!user->IsNullCheck()) << "NullCheck should have been eliminated";
-      if (user->IsBoundType()) {
-        // BoundType shouldn't normally be necessary for a NewInstance.
-        // Just be conservative for the uncommon cases.
-        is_singleton_ = false;
-        is_singleton_and_not_returned_ = false;
-        return;
-      }
-      if (user->IsPhi() || user->IsSelect() || user->IsInvoke() ||
-          (user->IsInstanceFieldSet() && (reference_ == user->InputAt(1))) ||
-          (user->IsUnresolvedInstanceFieldSet() && (reference_ == user->InputAt(1))) ||
-          (user->IsStaticFieldSet() && (reference_ == user->InputAt(1))) ||
-          (user->IsUnresolvedStaticFieldSet() && (reference_ == user->InputAt(0))) ||
-          (user->IsArraySet() && (reference_ == user->InputAt(2)))) {
-        // reference_ is merged to HPhi/HSelect, passed to a callee, or stored to heap.
-        // reference_ isn't the only name that can refer to its value anymore.
-        is_singleton_ = false;
-        is_singleton_and_not_returned_ = false;
-        return;
-      }
-      if ((user->IsUnresolvedInstanceFieldGet() && (reference_ == user->InputAt(0))) ||
-          (user->IsUnresolvedInstanceFieldSet() && (reference_ == user->InputAt(0)))) {
-        // The field is accessed in an unresolved way. We mark the object as a singleton to
-        // disable load/store optimizations on it.
-        // Note that we could optimize this case and still perform some optimizations until
-        // we hit the unresolved access, but disabling is the simplest.
-        is_singleton_ = false;
-        is_singleton_and_not_returned_ = false;
-        return;
-      }
-      if (user->IsReturn()) {
-        is_singleton_and_not_returned_ = false;
-      }
-    }
+    CalculateEscape(reference_, &is_singleton_, &is_singleton_and_not_returned_);
   }
 
   HInstruction* GetReference() const {
@@ -522,7 +478,8 @@ class LSEVisitor : public HGraphVisitor {
         removed_loads_(graph->GetArena()->Adapter(kArenaAllocLSE)),
         substitute_instructions_for_loads_(graph->GetArena()->Adapter(kArenaAllocLSE)),
         possibly_removed_stores_(graph->GetArena()->Adapter(kArenaAllocLSE)),
-        singleton_new_instances_(graph->GetArena()->Adapter(kArenaAllocLSE)) {
+        singleton_new_instances_(graph->GetArena()->Adapter(kArenaAllocLSE)),
+        merged_values_(graph->GetArena()->Adapter(kArenaAllocLSE)) {
   }
 
   void VisitBasicBlock(HBasicBlock* block) OVERRIDE {
@@ -566,12 +523,31 @@ class LSEVisitor : public HGraphVisitor {
       store->GetBlock()->RemoveInstruction(store);
     }
 
-    // TODO: remove unnecessary allocations.
-    // Eliminate instructions in singleton_new_instances_ that:
-    // - don't have uses,
-    // - don't have finalizers,
-    // - are instantiable and accessible,
-    // - have no/separate clinit check.
+    // Remove the phis created for merging heap values that no load ended up using.
+    // A phi may only be used by another such phi, so iterate until nothing changes.
+    bool removed_phi = true;
+    while (removed_phi) {
+      removed_phi = false;
+      for (MergedValue& merged : merged_values_) {
+        if (merged.phi != nullptr && !merged.phi->HasUses()) {
+          merged.phi->GetBlock()->RemovePhi(merged.phi);
+          merged.phi = nullptr;
+          removed_phi = true;
+        }
+      }
+    }
+
+    // Eliminate allocations whose fields now all live in SSA values. These
+    // allocations do not escape, have no finalizer, are instantiable and accessible,
+    // and have their clinit check, if any, in a separate instruction. Their remaining
+    // environment uses are only needed for deoptimization or debugging, neither of
+    // which applies here.
+    for (HInstruction* new_instance : singleton_new_instances_) {
+      if (!new_instance->HasNonEnvironmentUses()) {
+        new_instance->RemoveEnvironmentUsers();
+        new_instance->GetBlock()->RemoveInstruction(new_instance);
+      }
+    }
   }
 
  private:
@@ -580,9 +556,14 @@ class LSEVisitor : public HGraphVisitor {
   // effects (which is essentially merging also), since a load later from the
   // location won't be eliminated.
   void KeepIfIsStore(HInstruction* heap_value) {
-    if (heap_value == kDefaultHeapValue ||
-        heap_value == kUnknownHeapValue ||
-        !heap_value->IsInstanceFieldSet()) {
+    if (heap_value == kDefaultHeapValue || heap_value == kUnknownHeapValue) {
+      return;
+    }
+    if (heap_value->IsPhi()) {
+      KeepStoresMergedInto(heap_value->AsPhi());
+      return;
+    }
+    if (!heap_value->IsInstanceFieldSet()) {
       return;
     }
     auto idx = std::find(possibly_removed_stores_.begin(),
@@ -593,6 +574,22 @@ class LSEVisitor : public HGraphVisitor {
     }
   }
 
+  // If `phi` merges the values of a heap location at a join, the stores that
+  // provide these values need to be kept once the merged value is killed.
+  void KeepStoresMergedInto(HPhi* phi) {
+    for (MergedValue& merged : merged_values_) {
+      if (merged.phi == phi) {
+        if (!merged.stores_kept) {
+          merged.stores_kept = true;
+          for (HBasicBlock* predecessor : phi->GetBlock()->GetPredecessors()) {
+            KeepIfIsStore(heap_values_for_[predecessor->GetBlockId()][merged.location]);
+          }
+        }
+        return;
+      }
+    }
+  }
+
   void HandleLoopSideEffects(HBasicBlock* block) {
     DCHECK(block->IsLoopHeader());
     int block_id = block->GetBlockId();
@@ -649,11 +646,18 @@ class LSEVisitor : public HGraphVisitor {
       if (pred0_value != kUnknownHeapValue) {
         for (size_t j = 1; j < predecessors.size(); j++) {
           HInstruction* pred_value = heap_values_for_[predecessors[j]->GetBlockId()][i];
-          if (pred_value != pred0_value) {
+          if (pred_value == kUnknownHeapValue) {
             heap_values[i] = kUnknownHeapValue;
             break;
+          } else if (pred_value != pred0_value) {
+            // The predecessors disagree on the value. The location may still be
+            // tracked by merging the values into a phi.
+            heap_values[i] = nullptr;
           }
         }
+        if (heap_values[i] == nullptr) {
+          heap_values[i] = MergeValuesWithPhi(block, i);
+        }
       }
 
       if (heap_values[i] == kUnknownHeapValue) {
@@ -666,6 +670,53 @@ class LSEVisitor : public HGraphVisitor {
     }
   }
 
+  // Returns a new phi in `block` that merges the values of heap location `idx` in
+  // the predecessors of `block`, or kUnknownHeapValue if the values cannot be merged.
+  // This replaces the fields of a singleton by SSA values across control flow joins.
+  // Only primitive fields are merged, since reference phis would need type information.
+  HInstruction* MergeValuesWithPhi(HBasicBlock* block, size_t idx) {
+    HeapLocation* location = heap_location_collector_.GetHeapLocation(idx);
+    HInstruction* ref = location->GetReferenceInfo()->GetReference();
+    if (location->IsArrayElement() ||
+        heap_location_collector_.MayDeoptimize() ||
+        !location->GetReferenceInfo()->IsSingletonAndNotReturned() ||
+        !ref->IsNewInstance() ||
+        ref->AsNewInstance()->IsFinalizable()) {
+      return kUnknownHeapValue;
+    }
+    const ArenaVector<HBasicBlock*>& predecessors = block->GetPredecessors();
+    Primitive::Type type = Primitive::kPrimVoid;
+    for (HBasicBlock* predecessor : predecessors) {
+      HInstruction* value = heap_values_for_[predecessor->GetBlockId()][idx];
+      DCHECK_NE(value, kUnknownHeapValue);
+      if (value == kDefaultHeapValue) {
+        continue;
+      } else if (value->IsInstanceFieldSet()) {
+        value = value->InputAt(1);
+      }
+      Primitive::Type kind = Primitive::PrimitiveKind(value->GetType());
+      if (kind == Primitive::kPrimNot || (type != Primitive::kPrimVoid && type != kind)) {
+        return kUnknownHeapValue;
+      }
+      type = kind;
+    }
+    DCHECK_NE(type, Primitive::kPrimVoid);
+    ArenaAllocator* arena = GetGraph()->GetArena();
+    HPhi* phi = new (arena) HPhi(arena, kNoRegNumber, 0, type);
+    for (HBasicBlock* predecessor : predecessors) {
+      HInstruction* value = heap_values_for_[predecessor->GetBlockId()][idx];
+      if (value == kDefaultHeapValue) {
+        value = GetDefaultValue(type);
+      } else if (value->IsInstanceFieldSet()) {
+        value = value->InputAt(1);
+      }
+      phi->AddInput(value);
+    }
+    block->AddPhi(phi);
+    merged_values_.push_back({phi, idx, /* stores_kept */ false});
+    return phi;
+  }
+
   // `instruction` is being removed. Try to see if the null check on it
   // can be removed. This can happen if the same value is set in two branches
   // but not in dominators. Such as:
@@ -970,10 +1021,12 @@ class LSEVisitor : public HGraphVisitor {
       return;
     }
     if (!heap_location_collector_.MayDeoptimize() &&
+        !GetGraph()->IsCompilingOsr() &&
         ref_info->IsSingletonAndNotReturned() &&
         !new_instance->IsFinalizable() &&
-        !new_instance->CanThrow()) {
-      // TODO: add new_instance to singleton_new_instances_ and enable allocation elimination.
+        !new_instance->NeedsChecks() &&
+        !new_instance->IsStringAlloc()) {
+      singleton_new_instances_.push_back(new_instance);
     }
     ArenaVector<HInstruction*>& heap_values =
         heap_values_for_[new_instance->GetBlock()->GetBlockId()];
@@ -1015,8 +1068,17 @@ class LSEVisitor : public HGraphVisitor {
   // found that the store cannot be eliminated.
   ArenaVector<HInstruction*> possibly_removed_stores_;
 
+  // Allocations that may be eliminated once their loads and stores are removed.
   ArenaVector<HInstruction*> singleton_new_instances_;
 
+  // A phi created to merge the values of heap location `location` at a join.
+  struct MergedValue {
+    HPhi* phi;
+    size_t location;
+    bool stores_kept;  // Whether the stores providing the merged values are kept.
+  };
+  ArenaVector<MergedValue> merged_values_;
+
   DISALLOW_COPY_AND_ASSIGN(LSEVisitor);
 };
 
@@ -0,0 +1,561 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_optimization.h"
+
+#include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "driver/compiler_driver.h"
+
+namespace art {
+
+// Both SSE on x86-64 and NEON on arm64 operate on 128-bit vector registers.
+static constexpr size_t kVectorSizeInBytes = 16;
+
+static bool IsPhiOf(HInstruction* instruction, HBasicBlock* block) {
+  return instruction->IsPhi() && instruction->GetBlock() == block;
+}
+
+// Returns the condition obtained by swapping the operands of `cond`.
+static IfCondition MirrorCondition(IfCondition cond) {
+  switch (cond) {
+    case kCondLT: return kCondGT;
+    case kCondLE: return kCondGE;
+    case kCondGT: return kCondLT;
+    case kCondGE: return kCondLE;
+    default: return cond;
+  }
+}
+
+// Returns whether `instruction` is a call to Math.min(int, int) or Math.max(int, int).
+static bool IsMinOrMax(HInstruction* instruction) {
+  if (!instruction->IsInvokeStaticOrDirect()) {
+    return false;
+  }
+  HInvokeStaticOrDirect* invoke = instruction->AsInvokeStaticOrDirect();
+  return invoke->GetNumberOfArguments() == 2u &&
+      (invoke->GetIntrinsic() == Intrinsics::kMathMinIntInt ||
+       invoke->GetIntrinsic() == Intrinsics::kMathMaxIntInt);
+}
+
+// Returns whether all non-environment uses of `instruction` are by `user`.
+static bool IsOnlyUsedBy(HInstruction* instruction, HInstruction* user) {
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    if (use.GetUser() != user) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HLoopOptimization::HLoopOptimization(HGraph* graph,
+                                     CompilerDriver* compiler_driver,
+                                     OptimizingCompilerStats* stats)
+    : HOptimization(graph, kLoopOptimizationPassName, stats),
+      compiler_driver_(compiler_driver),
+      has_sse4_1_(false),
+      induction_(nullptr),
+      update_(nullptr),
+      lower_(nullptr),
+      upper_(nullptr),
+      reductions_(graph->GetArena()->Adapter(kArenaAllocLoopOptimization)),
+      lane_type_(Primitive::kPrimVoid),
+      vector_length_(0),
+      vector_body_(nullptr),
+      vector_induction_(nullptr),
+      vector_map_(std::less<HInstruction*>(),
+                  graph->GetArena()->Adapter(kArenaAllocLoopOptimization)) {}
+
+void HLoopOptimization::Run() {
+  // Only the x86-64 and arm64 code generators implement the vector instructions.
+  // Vectorization is disabled in debuggable mode, to keep the loops as written, and
+  // for graphs with try/catch or irreducible loops, which the loop shapes we rely
+  // on do not account for. OSR code may be entered in the middle of any loop.
+  InstructionSet instruction_set = graph_->GetInstructionSet();
+  if ((instruction_set != kX86_64 && instruction_set != kArm64) ||
+      graph_->IsDebuggable() ||
+      graph_->IsCompilingOsr() ||
+      graph_->HasTryCatch() ||
+      graph_->HasIrreducibleLoops()) {
+    return;
+  }
+  if (instruction_set == kX86_64) {
+    has_sse4_1_ = compiler_driver_->GetInstructionSetFeatures()
+        ->AsX86_64InstructionSetFeatures()->HasSSE4_1();
+  }
+
+  // Collect the candidate loops first, as vectorizing a loop adds blocks to the graph.
+  // A loop made of a header and a single body block is necessarily innermost.
+  ArenaVector<HLoopInformation*> loops(graph_->GetArena()->Adapter(kArenaAllocLoopOptimization));
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    if (block->IsLoopHeader() && block->GetLoopInformation()->GetBlocks().NumSetBits() == 2u) {
+      loops.push_back(block->GetLoopInformation());
+    }
+  }
+
+  for (HLoopInformation* loop_info : loops) {
+    if (TryVectorizeLoop(loop_info)) {
+      graph_->SetHasSIMD(true);
+      MaybeRecordStat(MethodCompilationStat::kLoopVectorized);
+    }
+  }
+}
+
+bool HLoopOptimization::TryVectorizeLoop(HLoopInformation* loop_info) {
+  induction_ = nullptr;
+  update_ = nullptr;
+  lower_ = nullptr;
+  upper_ = nullptr;
+  reductions_.clear();
+  lane_type_ = Primitive::kPrimVoid;
+  vector_length_ = 0;
+  vector_map_.clear();
+
+  // The loop must consist of a header and a body block that jumps back to it.
+  HBasicBlock* header = loop_info->GetHeader();
+  if (header->GetPredecessors().size() != 2u ||
+      header->GetSuccessors().size() != 2u ||
+      loop_info->NumberOfBackEdges() != 1u) {
+    return false;
+  }
+  HBasicBlock* body = loop_info->GetBackEdges()[0];
+  if (body->GetPredecessors().size() != 1u ||
+      body->GetSinglePredecessor() != header ||
+      body->GetSuccessors().size() != 1u) {
+    return false;
+  }
+
+  if (!AnalyzeHeader(loop_info, body) || !AnalyzeArrayAccesses(loop_info, body)) {
+    return false;
+  }
+
+  // Check that every instruction of the body can be vectorized.
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    if (!VectorizeInstruction(it.Current(), loop_info, /* generate_code */ false)) {
+      return false;
+    }
+  }
+
+  GenerateVectorLoop(loop_info, body);
+  return true;
+}
+
+bool HLoopOptimization::AnalyzeHeader(HLoopInformation* loop_info, HBasicBlock* body) {
+  // The header must consist of the suspend check, the loop condition and the HIf.
+  HBasicBlock* header = loop_info->GetHeader();
+  HInstruction* suspend_check = header->GetFirstInstruction();
+  if (!loop_info->HasSuspendCheck() || suspend_check != loop_info->GetSuspendCheck()) {
+    return false;
+  }
+  HInstruction* condition = suspend_check->GetNext();
+  HInstruction* control = header->GetLastInstruction();
+  if (!condition->IsCondition() ||
+      condition->GetNext() != control ||
+      !control->IsIf() ||
+      control->InputAt(0) != condition ||
+      !IsOnlyUsedBy(condition, control) ||
+      condition->HasEnvironmentUses()) {
+    return false;
+  }
+
+  // Normalize the condition into `phi < upper`, taken when entering the body.
+  IfCondition cond = (control->AsIf()->IfTrueSuccessor() == body)
+      ? condition->AsCondition()->GetCondition()
+      : condition->AsCondition()->GetOppositeCondition();
+  HInstruction* phi = condition->InputAt(0);
+  upper_ = condition->InputAt(1);
+  if (!IsPhiOf(phi, header)) {
+    std::swap(phi, upper_);
+    cond = MirrorCondition(cond);
+  }
+  if (cond != kCondLT ||
+      !IsPhiOf(phi, header) ||
+      phi->GetType() != Primitive::kPrimInt ||
+      upper_->GetType() != Primitive::kPrimInt ||
+      !loop_info->IsDefinedOutOfTheLoop(upper_)) {
+    return false;
+  }
+
+  // The induction must be incremented by one in the body, and the increment
+  // must only serve to update the induction.
+  induction_ = phi->AsPhi();
+  lower_ = induction_->InputAt(0);
+  update_ = induction_->InputAt(1);
+  if (!update_->IsAdd() ||
+      update_->GetBlock() != body ||
+      !IsOnlyUsedBy(update_, induction_)) {
+    return false;
+  }
+  HInstruction* increment = update_->InputAt(0) == induction_
+      ? update_->InputAt(1)
+      : (update_->InputAt(1) == induction_ ? update_->InputAt(0) : nullptr);
+  if (increment == nullptr || !increment->IsIntConstant() ||
+      increment->AsIntConstant()->GetValue() != 1) {
+    return false;
+  }
+
+  // All other phis must be reductions.
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* other = it.Current()->AsPhi();
+    if (other != induction_ && !AnalyzeReduction(other, loop_info, body)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HLoopOptimization::AnalyzeReduction(HPhi* phi,
+                                         HLoopInformation* loop_info,
+                                         HBasicBlock* body) {
+  if (phi->GetType() != Primitive::kPrimInt) {
+    return false;
+  }
+  HInstruction* update = phi->InputAt(1);
+  if (update->GetBlock() != body || !IsOnlyUsedBy(update, phi)) {
+    return false;
+  }
+  HVecReduce::ReductionKind kind;
+  if (update->IsAdd()) {
+    kind = HVecReduce::kSum;
+  } else if (IsMinOrMax(update)) {
+    kind = update->AsInvokeStaticOrDirect()->GetIntrinsic() == Intrinsics::kMathMinIntInt
+        ? HVecReduce::kMin
+        : HVecReduce::kMax;
+  } else {
+    return false;
+  }
+  HInstruction* operand = nullptr;
+  if (update->InputAt(0) == phi) {
+    operand = update->InputAt(1);
+  } else if (update->InputAt(1) == phi) {
+    operand = update->InputAt(0);
+  }
+  if (operand == nullptr || operand == phi) {
+    return false;
+  }
+  // Inside the loop, the accumulated value may only be used by its update.
+  for (const HUseListNode<HInstruction*>& use : phi->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user != update && !loop_info->IsDefinedOutOfTheLoop(user)) {
+      return false;
+    }
+  }
+  reductions_.push_back(Reduction { phi, update, operand, kind, nullptr });
+  return true;
+}
+
+bool HLoopOptimization::AnalyzeArrayAccesses(HLoopInformation* loop_info, HBasicBlock* body) {
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    Primitive::Type type;
+    if (instruction->IsArrayGet()) {
+      type = instruction->GetType();
+    } else if (instruction->IsArraySet()) {
+      type = instruction->AsArraySet()->GetComponentType();
+    } else {
+      continue;
+    }
+    // Every element of the vector must come from a different iteration
+    // of the scalar loop, which only holds for accesses a[i].
+    if (!loop_info->IsDefinedOutOfTheLoop(instruction->InputAt(0)) ||
+        instruction->InputAt(1) != induction_) {
+      return false;
+    }
+    switch (type) {
+      case Primitive::kPrimByte:
+      case Primitive::kPrimChar:
+      case Primitive::kPrimShort:
+      case Primitive::kPrimInt:
+      case Primitive::kPrimFloat:
+        break;
+      default:
+        return false;
+    }
+    if (lane_type_ == Primitive::kPrimVoid) {
+      lane_type_ = type;
+    } else if (Primitive::ComponentSize(type) != Primitive::ComponentSize(lane_type_) ||
+               Primitive::IsFloatingPointType(type) != Primitive::IsFloatingPointType(lane_type_)) {
+      return false;
+    }
+  }
+  if (lane_type_ == Primitive::kPrimVoid) {
+    return false;
+  }
+  vector_length_ = kVectorSizeInBytes / Primitive::ComponentSize(lane_type_);
+
+  // Reductions on packed bytes or halfwords would overflow the lanes.
+  return reductions_.empty() || lane_type_ == Primitive::kPrimInt;
+}
+
+bool HLoopOptimization::IsSupportedOperation(HInstruction* instruction) const {
+  // In loops over sub-word arrays, the arithmetic is done on ints and truncated when
+  // stored, so only operations that do not depend on the upper bits of their operands
+  // can be done on the packed elements directly.
+  bool is_fp = Primitive::IsFloatingPointType(lane_type_);
+  if (instruction->GetType() != (is_fp ? Primitive::kPrimFloat : Primitive::kPrimInt)) {
+    return false;
+  }
+  bool is_x86_64 = graph_->GetInstructionSet() == kX86_64;
+  if (instruction->IsAdd() || instruction->IsSub()) {
+    return true;
+  } else if (instruction->IsMul()) {
+    // x86-64 has no packed byte multiplication, and needs SSE4.1 for packed ints.
+    if (is_x86_64) {
+      return lane_type_ != Primitive::kPrimByte &&
+          (lane_type_ != Primitive::kPrimInt || has_sse4_1_);
+    }
+    return true;
+  } else if (instruction->IsDiv()) {
+    return is_fp;
+  } else if (instruction->IsAnd() || instruction->IsOr() || instruction->IsXor() ||
+             instruction->IsNot()) {
+    return !is_fp;
+  } else if (instruction->IsNeg()) {
+    // On x86-64, a floating-point negation would need a sign mask in memory.
+    return !is_fp || !is_x86_64;
+  } else if (IsMinOrMax(instruction)) {
+    return lane_type_ == Primitive::kPrimInt && (!is_x86_64 || has_sse4_1_);
+  }
+  return false;
+}
+
+bool HLoopOptimization::VectorizeInstruction(HInstruction* instruction,
+                                             HLoopInformation* loop_info,
+                                             bool generate_code) {
+  ArenaAllocator* arena = graph_->GetArena();
+  if (instruction == update_ || instruction->IsGoto()) {
+    // Taken care of by the control of the vector loop.
+    return true;
+  }
+  for (Reduction& reduction : reductions_) {
+    if (instruction == reduction.update) {
+      if (!IsSupportedOperation(instruction)) {
+        return false;
+      }
+      HInstruction* operand = GetVectorOperand(reduction.operand, loop_info, generate_code);
+      if (operand == nullptr) {
+        return false;
+      }
+      if (generate_code) {
+        reduction.vector_phi->AddInput(AddToVectorBody(new (arena) HVecReduce(
+            arena, reduction.vector_phi, operand, lane_type_, vector_length_, reduction.kind)));
+      }
+      return true;
+    }
+  }
+
+  HInstruction* vector = nullptr;
+  if (instruction->IsArrayGet()) {
+    if (generate_code) {
+      vector = AddToVectorBody(new (arena) HVecLoad(arena,
+                                                    instruction->InputAt(0),
+                                                    vector_induction_,
+                                                    instruction->GetType(),
+                                                    vector_length_));
+    }
+  } else if (instruction->IsArraySet()) {
+    HInstruction* value =
+        GetVectorOperand(instruction->AsArraySet()->GetValue(), loop_info, generate_code);
+    if (value == nullptr) {
+      return false;
+    }
+    if (generate_code) {
+      AddToVectorBody(new (arena) HVecStore(arena,
+                                            instruction->InputAt(0),
+                                            vector_induction_,
+                                            value,
+                                            instruction->AsArraySet()->GetComponentType(),
+                                            vector_length_));
+    }
+    return true;
+  } else if (instruction->IsTypeConversion()) {
+    // A narrowing of an int to the size of the lanes is implicit in the packed
+    // representation. Any other conversion changes the size of the elements.
+    Primitive::Type result_type = instruction->GetType();
+    HInstruction* input = instruction->InputAt(0);
+    if (!Primitive::IsIntegralType(result_type) ||
+        Primitive::ComponentSize(result_type) != Primitive::ComponentSize(lane_type_) ||
+        Primitive::ComponentSize(lane_type_) >= Primitive::ComponentSize(Primitive::kPrimInt) ||
+        !Primitive::IsIntegralType(input->GetType()) ||
+        input->GetType() == Primitive::kPrimLong) {
+      return false;
+    }
+    vector = GetVectorOperand(input, loop_info, generate_code);
+    if (vector == nullptr) {
+      return false;
+    }
+  } else if (IsSupportedOperation(instruction)) {
+    HInstruction* left = GetVectorOperand(instruction->InputAt(0), loop_info, generate_code);
+    if (left == nullptr) {
+      return false;
+    }
+    HInstruction* right = nullptr;
+    if (!instruction->IsNeg() && !instruction->IsNot()) {
+      right = GetVectorOperand(instruction->InputAt(1), loop_info, generate_code);
+      if (right == nullptr) {
+        return false;
+      }
+    }
+    if (generate_code) {
+      Primitive::Type type = lane_type_;
+      size_t length = vector_length_;
+      if (instruction->IsAdd()) {
+        vector = new (arena) HVecAdd(arena, left, right, type, length);
+      } else if (instruction->IsSub()) {
+        vector = new (arena) HVecSub(arena, left, right, type, length);
+      } else if (instruction->IsMul()) {
+        vector = new (arena) HVecMul(arena, left, right, type, length);
+      } else if (instruction->IsDiv()) {
+        vector = new (arena) HVecDiv(arena, left, right, type, length);
+      } else if (instruction->IsAnd()) {
+        vector = new (arena) HVecAnd(arena, left, right, type, length);
+      } else if (instruction->IsOr()) {
+        vector = new (arena) HVecOr(arena, left, right, type, length);
+      } else if (instruction->IsXor()) {
+        vector = new (arena) HVecXor(arena, left, right, type, length);
+      } else if (instruction->IsNeg()) {
+        vector = new (arena) HVecNeg(arena, left, type, length);
+      } else if (instruction->IsNot()) {
+        vector = new (arena) HVecNot(arena, left, type, length);
+      } else if (instruction->AsInvokeStaticOrDirect()->GetIntrinsic() ==
+                 Intrinsics::kMathMinIntInt) {
+        vector = new (arena) HVecMin(arena, left, right, type, length);
+      } else {
+        vector = new (arena) HVecMax(arena, left, right, type, length);
+      }
+      AddToVectorBody(vector);
+    }
+  } else {
+    return false;
+  }
+  MapVector(instruction, generate_code ? vector : instruction);
+  return true;
+}
+
+HInstruction* HLoopOptimization::GetVectorOperand(HInstruction* operand,
+                                                  HLoopInformation* loop_info,
+                                                  bool generate_code) {
+  auto it = vector_map_.find(operand);
+  if (it != vector_map_.end()) {
+    return it->second;
+  }
+  if (!loop_info->IsDefinedOutOfTheLoop(operand)) {
+    // Either a value the body cannot vectorize, or a loop-header phi.
+    return nullptr;
+  }
+  // A loop invariant is replicated into all lanes. This is done in the body, so that
+  // no vector value is live across the suspend check in the header of the vector loop.
+  Primitive::Type type = operand->GetType();
+  bool is_compatible = Primitive::IsFloatingPointType(lane_type_)
+      ? type == Primitive::kPrimFloat
+      : Primitive::IsIntegralType(type) && type != Primitive::kPrimLong;
+  if (!is_compatible) {
+    return nullptr;
+  }
+  HInstruction* vector = operand;
+  if (generate_code) {
+    ArenaAllocator* arena = graph_->GetArena();
+    vector = AddToVectorBody(
+        new (arena) HVecReplicateScalar(arena, operand, lane_type_, vector_length_));
+  }
+  MapVector(operand, vector);
+  return vector;
+}
+
+void HLoopOptimization::MapVector(HInstruction* scalar, HInstruction* vector) {
+  DCHECK(vector_map_.find(scalar) == vector_map_.end());
+  vector_map_.Put(scalar, vector);
+}
+
+HInstruction* HLoopOptimization::AddToVectorBody(HInstruction* instruction) {
+  vector_body_->InsertInstructionBefore(instruction, vector_body_->GetLastInstruction());
+  return instruction;
+}
+
+/*
+ * The loop
+ *
+ *   for (i = lo; i < hi; i++) { body }
+ *
+ * is transformed into
+ *
+ *   vn = lo < hi ? lo + ((hi - lo) & -VL) : lo;
+ *   for (vi = lo; vi < vn; vi += VL) { vector body }
+ *   for (i = vi; i < hi; i++) { body }
+ *
+ * where the original loop serves as epilogue for the last (hi - lo) % VL iterations.
+ * The subtraction hi - lo may wrap around, but the unsigned difference is exact and
+ * keeps vn within [lo, hi].
+ */
+void HLoopOptimization::GenerateVectorLoop(HLoopInformation* loop_info, HBasicBlock* body) {
+  ArenaAllocator* arena = graph_->GetArena();
+  HBasicBlock* header = loop_info->GetHeader();
+  HBasicBlock* pre_header = loop_info->GetPreHeader();
+  HInstruction* cursor = pre_header->GetLastInstruction();
+
+  // Compute the upper bound of the vector loop in the pre-header.
+  HInstruction* difference = new (arena) HSub(Primitive::kPrimInt, upper_, lower_);
+  int32_t vector_length = static_cast<int32_t>(vector_length_);
+  HInstruction* rounded = new (arena) HAnd(
+      Primitive::kPrimInt, difference, graph_->GetIntConstant(-vector_length));
+  HInstruction* bound = new (arena) HAdd(Primitive::kPrimInt, lower_, rounded);
+  HInstruction* entered = new (arena) HLessThan(lower_, upper_);
+  HInstruction* vector_upper = new (arena) HSelect(entered, bound, lower_, kNoDexPc);
+  pre_header->InsertInstructionBefore(difference, cursor);
+  pre_header->InsertInstructionBefore(rounded, cursor);
+  pre_header->InsertInstructionBefore(bound, cursor);
+  pre_header->InsertInstructionBefore(entered, cursor);
+  pre_header->InsertInstructionBefore(vector_upper, cursor);
+
+  // Build the control of the vector loop.
+  HBasicBlock* vector_header = graph_->TransformLoopForVectorization(header);
+  vector_body_ = vector_header->GetSuccessors()[1];
+  vector_induction_ = new (arena) HPhi(
+      arena, induction_->GetRegNumber(), 0, Primitive::kPrimInt);
+  vector_header->AddPhi(vector_induction_);
+  vector_induction_->AddInput(lower_);
+  for (Reduction& reduction : reductions_) {
+    reduction.vector_phi = new (arena) HPhi(
+        arena, reduction.phi->GetRegNumber(), 0, Primitive::kPrimInt);
+    vector_header->AddPhi(reduction.vector_phi);
+    reduction.vector_phi->AddInput(reduction.phi->InputAt(0));
+  }
+  HInstruction* exit = new (arena) HGreaterThanOrEqual(vector_induction_, vector_upper);
+  vector_header->AddInstruction(exit);
+  vector_header->AddInstruction(new (arena) HIf(exit));
+
+  // Generate the vector body.
+  vector_map_.clear();
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    bool vectorized = VectorizeInstruction(it.Current(), loop_info, /* generate_code */ true);
+    DCHECK(vectorized);
+  }
+  vector_induction_->AddInput(AddToVectorBody(new (arena) HAdd(
+      Primitive::kPrimInt,
+      vector_induction_,
+      graph_->GetIntConstant(vector_length))));
+
+  // The scalar loop continues where the vector loop left off.
+  induction_->ReplaceInput(vector_induction_, 0);
+  for (const Reduction& reduction : reductions_) {
+    reduction.phi->ReplaceInput(reduction.vector_phi, 0);
+  }
+  HSuspendCheck* suspend_check = vector_header->GetLoopInformation()->GetSuspendCheck();
+  suspend_check->CopyEnvironmentFromWithLoopPhiAdjustment(
+      loop_info->GetSuspendCheck()->GetEnvironment(), header);
+}
+
+}  // namespace art
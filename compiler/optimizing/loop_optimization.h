@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
+#define ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
+
+#include "base/arena_containers.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+class CompilerDriver;
+
+/**
+ * Loop optimizations. Vectorizes countable innermost loops of the form
+ *
+ *   for (int i = lo; i < hi; i++) { body }
+ *
+ * whose body consists of a single basic block of array accesses a[i] and
+ * arithmetic on their elements, into a loop that executes the body on
+ * vectors of elements, followed by the original loop, which takes care
+ * of the remaining iterations.
+ */
+class HLoopOptimization : public HOptimization {
+ public:
+  HLoopOptimization(HGraph* graph,
+                    CompilerDriver* compiler_driver,
+                    OptimizingCompilerStats* stats);
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kLoopOptimizationPassName = "loop_optimization";
+
+ private:
+  // A loop-header phi that accumulates a value over all iterations,
+  // viz. r = r + e, r = min(r, e) or r = max(r, e).
+  struct Reduction {
+    HPhi* phi;
+    HInstruction* update;
+    HInstruction* operand;
+    HVecReduce::ReductionKind kind;
+    HPhi* vector_phi;  // The corresponding phi of the vector loop, once generated.
+  };
+
+  // Vectorizes the loop if it has a supported shape and body.
+  bool TryVectorizeLoop(HLoopInformation* loop_info);
+
+  // Analysis of the loop header: the loop condition and the loop-header phis.
+  bool AnalyzeHeader(HLoopInformation* loop_info, HBasicBlock* body);
+  bool AnalyzeReduction(HPhi* phi, HLoopInformation* loop_info, HBasicBlock* body);
+
+  // Analysis of the array accesses in the loop body, which determines the
+  // type of the vector lanes and the number of elements per vector.
+  bool AnalyzeArrayAccesses(HLoopInformation* loop_info, HBasicBlock* body);
+
+  // Vectorizes a single instruction of the loop body, or merely checks
+  // whether that is possible if `generate_code` is false.
+  bool VectorizeInstruction(HInstruction* instruction,
+                            HLoopInformation* loop_info,
+                            bool generate_code);
+
+  // Returns the vector value of `operand`, or nullptr if `operand` cannot be vectorized.
+  HInstruction* GetVectorOperand(HInstruction* operand,
+                                 HLoopInformation* loop_info,
+                                 bool generate_code);
+
+  // Records the vector value of a scalar instruction of the loop body.
+  void MapVector(HInstruction* scalar, HInstruction* vector);
+
+  // Returns whether the target supports the vector operation of `instruction`.
+  bool IsSupportedOperation(HInstruction* instruction) const;
+
+  // Builds the vector loop in front of the loop of `loop_info`.
+  void GenerateVectorLoop(HLoopInformation* loop_info, HBasicBlock* body);
+
+  // Adds `instruction` to the body of the vector loop.
+  HInstruction* AddToVectorBody(HInstruction* instruction);
+
+  CompilerDriver* const compiler_driver_;
+
+  // Whether the target instruction set has SSE4.1, which provides
+  // packed 32-bit multiplication, minimum and maximum on x86-64.
+  bool has_sse4_1_;
+
+  // Properties of the loop being analyzed.
+  HPhi* induction_;
+  HInstruction* update_;
+  HInstruction* lower_;
+  HInstruction* upper_;
+  ArenaVector<Reduction> reductions_;
+  Primitive::Type lane_type_;
+  size_t vector_length_;
+
+  // Loop and vector values of the vector loop being generated.
+  HBasicBlock* vector_body_;
+  HPhi* vector_induction_;
+  ArenaSafeMap<HInstruction*, HInstruction*> vector_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(HLoopOptimization);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
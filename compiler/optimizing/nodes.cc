@@ -2251,6 +2251,84 @@ void HGraph::TransformLoopHeaderForBCE(HBasicBlock* header) {
       new_pre_header, old_pre_header, /* replace_if_back_edge */ false);
 }
 
+/*
+ * Loop will be transformed to:
+ *       old_pre_header
+ *             |
+ *          new_header <---
+ *           /    \       |
+ *          /   new_body --
+ *         /
+ *  new_pre_header
+ *         |
+ *       header
+ */
+HBasicBlock* HGraph::TransformLoopForVectorization(HBasicBlock* header) {
+  DCHECK(header->IsLoopHeader());
+  HBasicBlock* old_pre_header = header->GetDominator();
+
+  HBasicBlock* new_header = new (arena_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_body = new (arena_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_pre_header = new (arena_) HBasicBlock(this, header->GetDexPc());
+  AddBlock(new_header);
+  AddBlock(new_body);
+  AddBlock(new_pre_header);
+
+  // Keep the pre-header at predecessor index 0 of both loop headers, so that the
+  // first input of their phis remains the value on loop entry.
+  header->ReplacePredecessor(old_pre_header, new_pre_header);
+  old_pre_header->AddSuccessor(new_header);
+  new_header->AddSuccessor(new_pre_header);  // True successor, exits the new loop.
+  new_header->AddSuccessor(new_body);  // False successor, enters the new loop body.
+  new_body->AddSuccessor(new_header);
+
+  old_pre_header->ReplaceDominatedBlock(header, new_header);
+  new_header->SetDominator(old_pre_header);
+  new_header->dominated_blocks_.push_back(new_body);
+  new_body->SetDominator(new_header);
+  new_header->dominated_blocks_.push_back(new_pre_header);
+  new_pre_header->SetDominator(new_header);
+  new_pre_header->dominated_blocks_.push_back(header);
+  header->SetDominator(new_pre_header);
+
+  // Fix reverse post order.
+  size_t index_of_header = IndexOfElement(reverse_post_order_, header);
+  MakeRoomFor(&reverse_post_order_, 3, index_of_header - 1);
+  reverse_post_order_[index_of_header++] = new_header;
+  reverse_post_order_[index_of_header++] = new_body;
+  reverse_post_order_[index_of_header++] = new_pre_header;
+
+  // The new header starts with a suspend check, whose environment is set by the
+  // client once the loop phis of the new header are known. The body ends with a goto.
+  HSuspendCheck* suspend_check = new (arena_) HSuspendCheck(header->GetDexPc());
+  new_header->AddInstruction(suspend_check);
+  new_body->AddInstruction(new (arena_) HGoto());
+  new_pre_header->AddInstruction(new (arena_) HGoto());
+
+  // Create and populate the new loop, and add its blocks to the outer loops.
+  new_header->AddBackEdge(new_body);
+  new_header->GetLoopInformation()->SetSuspendCheck(suspend_check);
+  new_header->GetLoopInformation()->Populate();
+  HLoopInformationOutwardIterator it(*new_header);
+  for (it.Advance(); !it.Done(); it.Advance()) {
+    it.Current()->Add(new_header);
+    it.Current()->Add(new_body);
+  }
+  TryCatchInformation* try_catch_info = old_pre_header->IsTryBlock()
+      ? old_pre_header->GetTryCatchInformation()
+      : nullptr;
+  new_header->SetTryCatchInformation(try_catch_info);
+  new_body->SetTryCatchInformation(try_catch_info);
+
+  // The pre_header can never be a back edge of a loop.
+  DCHECK((old_pre_header->GetLoopInformation() == nullptr) ||
+         !old_pre_header->GetLoopInformation()->IsBackEdge(*old_pre_header));
+  UpdateLoopAndTryInformationOfNewBlock(
+      new_pre_header, old_pre_header, /* replace_if_back_edge */ false);
+  DCHECK_EQ(header->GetLoopInformation()->GetPreHeader(), new_pre_header);
+  return new_header;
+}
+
 static void CheckAgainstUpperBound(ReferenceTypeInfo rti, ReferenceTypeInfo upper_bound_rti)
     SHARED_REQUIRES(Locks::mutator_lock_) {
   if (rti.IsValid()) {
@@ -297,6 +297,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         has_bounds_checks_(false),
         has_try_catch_(false),
         has_irreducible_loops_(false),
+        has_simd_(false),
         debuggable_(debuggable),
         current_instruction_id_(start_instruction_id),
         dex_file_(dex_file),
@@ -312,7 +313,8 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         cached_double_constants_(std::less<int64_t>(), arena->Adapter(kArenaAllocConstantsMap)),
         cached_current_method_(nullptr),
         inexact_object_rti_(ReferenceTypeInfo::CreateInvalid()),
-        osr_(osr) {
+        osr_(osr),
+        compiling_baseline_(false) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
 
@@ -368,6 +370,14 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // put deoptimization instructions, etc.
   void TransformLoopHeaderForBCE(HBasicBlock* header);
 
+  // Adds a new loop, consisting of a header and a single body block, in front
+  // of the loop of `header`. The new loop exits into a new pre-header of the
+  // original loop. Returns the header of the new loop, which only contains a
+  // suspend check without environment: the client must add the phis, the loop
+  // condition and the HIf, as well as the instructions of the body (which ends
+  // with a HGoto), and then set the environment of the suspend check.
+  HBasicBlock* TransformLoopForVectorization(HBasicBlock* header);
+
   // Removes `block` from the graph. Assumes `block` has been disconnected from
   // other blocks and has no instructions or phis.
   void DeleteDeadEmptyBlock(HBasicBlock* block);
@@ -502,12 +512,18 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingOsr() const { return osr_; }
 
+  bool IsCompilingBaseline() const { return compiling_baseline_; }
+  void SetCompilingBaseline(bool value) { compiling_baseline_ = value; }
+
   bool HasTryCatch() const { return has_try_catch_; }
   void SetHasTryCatch(bool value) { has_try_catch_ = value; }
 
   bool HasIrreducibleLoops() const { return has_irreducible_loops_; }
   void SetHasIrreducibleLoops(bool value) { has_irreducible_loops_ = value; }
 
+  bool HasSIMD() const { return has_simd_; }
+  void SetHasSIMD(bool value) { has_simd_ = value; }
+
   ArtMethod* GetArtMethod() const { return art_method_; }
   void SetArtMethod(ArtMethod* method) { art_method_ = method; }
 
@@ -588,6 +604,11 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // Flag whether there are any irreducible loops in the graph.
   bool has_irreducible_loops_;
 
+  // Flag whether SIMD instructions appear in the graph. If true, the
+  // code generators may have to be more careful spilling the wider
+  // contents of SIMD registers.
+  bool has_simd_;
+
   // Indicates whether the graph should be compiled in a way that
   // ensures full debuggability. If false, we can apply more
   // aggressive optimizations that may limit the level of debugging.
@@ -637,6 +658,11 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // compiled code entries which the interpreter can directly jump to.
   const bool osr_;
 
+  // Whether we are compiling baseline JIT code: only the passes needed for correctness
+  // are run, and the generated code counts its invocations to request an optimized
+  // compilation once it gets hot.
+  bool compiling_baseline_;
+
   friend class SsaBuilder;           // For caching constants.
   friend class SsaLivenessAnalysis;  // For the linear order.
   friend class HInliner;             // For the reverse post order.
@@ -1308,8 +1334,30 @@ class HLoopInformationOutwardIterator : public ValueObject {
 
 #define FOR_EACH_CONCRETE_INSTRUCTION_X86_64(M)
 
+/*
+ * Vector instructions, created by the loop optimization and only
+ * supported by the code generators that implement SIMD.
+ */
+#define FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(M)                         \
+  M(VecReplicateScalar, VecUnaryOperation)                              \
+  M(VecReduce, VecOperation)                                            \
+  M(VecNeg, VecUnaryOperation)                                          \
+  M(VecNot, VecUnaryOperation)                                          \
+  M(VecAdd, VecBinaryOperation)                                         \
+  M(VecSub, VecBinaryOperation)                                         \
+  M(VecMul, VecBinaryOperation)                                         \
+  M(VecDiv, VecBinaryOperation)                                         \
+  M(VecMin, VecBinaryOperation)                                         \
+  M(VecMax, VecBinaryOperation)                                         \
+  M(VecAnd, VecBinaryOperation)                                         \
+  M(VecOr, VecBinaryOperation)                                          \
+  M(VecXor, VecBinaryOperation)                                         \
+  M(VecLoad, VecMemoryOperation)                                        \
+  M(VecStore, VecMemoryOperation)
+
 #define FOR_EACH_CONCRETE_INSTRUCTION(M)                                \
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(M)                               \
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(M)                               \
   FOR_EACH_CONCRETE_INSTRUCTION_SHARED(M)                               \
   FOR_EACH_CONCRETE_INSTRUCTION_ARM(M)                                  \
   FOR_EACH_CONCRETE_INSTRUCTION_ARM64(M)                                \
@@ -1323,7 +1371,11 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(Constant, Instruction)                                              \
   M(UnaryOperation, Instruction)                                        \
   M(BinaryOperation, Instruction)                                       \
-  M(Invoke, Instruction)
+  M(Invoke, Instruction)                                                \
+  M(VecOperation, Instruction)                                          \
+  M(VecUnaryOperation, VecOperation)                                    \
+  M(VecBinaryOperation, VecOperation)                                   \
+  M(VecMemoryOperation, VecOperation)
 
 #define FOR_EACH_INSTRUCTION(M)                                         \
   FOR_EACH_CONCRETE_INSTRUCTION(M)                                      \
@@ -3628,9 +3680,13 @@ class HNewInstance : public HExpression<2> {
 
   // It may throw when called on type that's not instantiable/accessible.
   // It can throw OOME.
-  // TODO: distinguish between the two cases so we can for example allow allocation elimination.
   bool CanThrow() const OVERRIDE { return GetPackedFlag<kFlagCanThrow>() || true; }
 
+  // Whether the allocation may throw for another reason than OOME, viz. because the
+  // type is not instantiable or not accessible. Allocations that can only throw OOME
+  // may be eliminated when their result is unused.
+  bool NeedsChecks() const { return GetPackedFlag<kFlagCanThrow>(); }
+
   bool IsFinalizable() const { return GetPackedFlag<kFlagFinalizable>(); }
 
   bool CanBeNull() const OVERRIDE { return false; }
@@ -6335,6 +6391,8 @@ class HParallelMove : public HTemplateInstruction<0> {
 
 }  // namespace art
 
+#include "nodes_vector.h"
+
 #if defined(ART_ENABLE_CODEGEN_arm) || defined(ART_ENABLE_CODEGEN_arm64)
 #include "nodes_shared.h"
 #endif
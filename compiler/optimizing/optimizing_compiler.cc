@@ -68,6 +68,7 @@
 #include "jni/quick/jni_compiler.h"
 #include "licm.h"
 #include "load_store_elimination.h"
+#include "loop_optimization.h"
 #include "nodes.h"
 #include "oat_quick_method_header.h"
 #include "prepare_for_register_allocation.h"
@@ -292,7 +293,11 @@ class OptimizingCompiler FINAL : public Compiler {
     }
   }
 
-  bool JitCompile(Thread* self, jit::JitCodeCache* code_cache, ArtMethod* method, bool osr)
+  bool JitCompile(Thread* self,
+                  jit::JitCodeCache* code_cache,
+                  ArtMethod* method,
+                  bool baseline,
+                  bool osr)
       OVERRIDE
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -310,6 +315,7 @@ class OptimizingCompiler FINAL : public Compiler {
   // 1) Builds the graph. Returns null if it failed to build it.
   // 2) Transforms the graph to SSA. Returns null if it failed.
   // 3) Runs optimizations on the graph, including register allocator.
+  //    A `baseline` compilation only runs the passes the code generators rely on.
   // 4) Generates code with the `code_allocator` provided.
   CodeGenerator* TryCompile(ArenaAllocator* arena,
                             CodeVectorAllocator* code_allocator,
@@ -322,6 +328,7 @@ class OptimizingCompiler FINAL : public Compiler {
                             const DexFile& dex_file,
                             Handle<mirror::DexCache> dex_cache,
                             ArtMethod* method,
+                            bool baseline,
                             bool osr) const;
 
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
@@ -481,7 +488,8 @@ static void RunArchOptimizations(InstructionSet instruction_set,
 NO_INLINE  // Avoid increasing caller's frame size by large stack-allocated objects.
 static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
-                              PassObserver* pass_observer) {
+                              PassObserver* pass_observer,
+                              RegisterAllocator::Strategy strategy) {
   {
     PassScope scope(PrepareForRegisterAllocation::kPrepareForRegisterAllocationPassName,
                     pass_observer);
@@ -494,10 +502,35 @@ static void AllocateRegisters(HGraph* graph,
   }
   {
     PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
-    RegisterAllocator(graph->GetArena(), codegen, liveness).AllocateRegisters();
+    RegisterAllocator::Create(graph->GetArena(), codegen, liveness, strategy)->AllocateRegisters();
   }
 }
 
+// Baseline JIT code favors compilation speed: skip inlining and the optimizing passes,
+// and only run the ones the code generators depend on.
+static void RunBaselineOptimizations(HGraph* graph,
+                                     CodeGenerator* codegen,
+                                     CompilerDriver* driver,
+                                     OptimizingCompilerStats* stats,
+                                     const DexCompilationUnit& dex_compilation_unit,
+                                     PassObserver* pass_observer) {
+  ArenaAllocator* arena = graph->GetArena();
+  IntrinsicsRecognizer* intrinsics = new (arena) IntrinsicsRecognizer(graph, driver, stats);
+  HSharpening* sharpening = new (arena) HSharpening(graph, codegen, dex_compilation_unit, driver);
+  InstructionSimplifier* simplify = new (arena) InstructionSimplifier(
+      graph, stats, "instruction_simplifier_before_codegen");
+
+  HOptimization* optimizations[] = {
+    intrinsics,
+    sharpening,
+    simplify,
+  };
+  RunOptimizations(optimizations, arraysize(optimizations), pass_observer);
+
+  RunArchOptimizations(driver->GetInstructionSet(), graph, codegen, stats, pass_observer);
+  AllocateRegisters(graph, codegen, pass_observer, RegisterAllocator::kRegisterAllocatorLinearScan);
+}
+
 static void RunOptimizations(HGraph* graph,
                              CodeGenerator* codegen,
                              CompilerDriver* driver,
@@ -505,6 +538,11 @@ static void RunOptimizations(HGraph* graph,
                              const DexCompilationUnit& dex_compilation_unit,
                              PassObserver* pass_observer,
                              StackHandleScopeCollection* handles) {
+  if (graph->IsCompilingBaseline()) {
+    RunBaselineOptimizations(graph, codegen, driver, stats, dex_compilation_unit, pass_observer);
+    return;
+  }
+
   ArenaAllocator* arena = graph->GetArena();
   HDeadCodeElimination* dce1 = new (arena) HDeadCodeElimination(
       graph, stats, HDeadCodeElimination::kInitialDeadCodeEliminationPassName);
@@ -519,6 +557,7 @@ static void RunOptimizations(HGraph* graph,
   GVNOptimization* gvn = new (arena) GVNOptimization(graph, *side_effects);
   LICM* licm = new (arena) LICM(graph, *side_effects, stats);
   LoadStoreElimination* lse = new (arena) LoadStoreElimination(graph, *side_effects);
+  HLoopOptimization* loop = new (arena) HLoopOptimization(graph, driver, stats);
   HInductionVarAnalysis* induction = new (arena) HInductionVarAnalysis(graph);
   BoundsCheckElimination* bce = new (arena) BoundsCheckElimination(graph, *side_effects, induction);
   HSharpening* sharpening = new (arena) HSharpening(graph, codegen, dex_compilation_unit, driver);
@@ -552,6 +591,7 @@ static void RunOptimizations(HGraph* graph,
     fold3,  // evaluates code generated by dynamic bce
     simplify2,
     lse,
+    loop,  // after lse, which does not handle vector loads and stores
     dce2,
     // The codegen has a few assumptions that only the instruction simplifier
     // can satisfy. For example, the code generator does not expect to see a
@@ -561,7 +601,10 @@ static void RunOptimizations(HGraph* graph,
   RunOptimizations(optimizations2, arraysize(optimizations2), pass_observer);
 
   RunArchOptimizations(driver->GetInstructionSet(), graph, codegen, stats, pass_observer);
-  AllocateRegisters(graph, codegen, pass_observer);
+  AllocateRegisters(graph,
+                    codegen,
+                    pass_observer,
+                    driver->GetCompilerOptions().GetRegisterAllocationStrategy());
 }
 
 static ArenaVector<LinkerPatch> EmitAndSortLinkerPatches(CodeGenerator* codegen) {
@@ -616,6 +659,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* arena,
                                               const DexFile& dex_file,
                                               Handle<mirror::DexCache> dex_cache,
                                               ArtMethod* method,
+                                              bool baseline,
                                               bool osr) const {
   MaybeRecordStat(MethodCompilationStat::kAttemptCompilation);
   CompilerDriver* compiler_driver = GetCompilerDriver();
@@ -720,6 +764,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* arena,
   }
   codegen->GetAssembler()->cfi().SetEnabled(
       compiler_driver->GetCompilerOptions().GenerateAnyDebugInfo());
+  // Baseline code on architectures without hotness counting support would never
+  // request its optimized version, so compile those methods optimized right away.
+  graph->SetCompilingBaseline(baseline && !osr && codegen->SupportsBaselineHotnessCounting());
 
   PassObserver pass_observer(graph,
                              codegen.get(),
@@ -814,6 +861,7 @@ CompiledMethod* OptimizingCompiler::Compile(const DexFile::CodeItem* code_item,
                    dex_file,
                    dex_cache,
                    nullptr,
+                   /* baseline */ false,
                    /* osr */ false));
     if (codegen.get() != nullptr) {
       MaybeRecordStat(MethodCompilationStat::kCompiled);
@@ -868,6 +916,7 @@ bool IsCompilingWithCoreImage() {
 bool OptimizingCompiler::JitCompile(Thread* self,
                                     jit::JitCodeCache* code_cache,
                                     ArtMethod* method,
+                                    bool baseline,
                                     bool osr) {
   StackHandleScope<2> hs(self);
   Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
@@ -901,6 +950,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                    *dex_file,
                    dex_cache,
                    method,
+                   baseline,
                    osr));
     if (codegen.get() == nullptr) {
       return false;
@@ -930,6 +980,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
       codegen->GetFpuSpillMask(),
       code_allocator.GetMemory().data(),
       code_allocator.GetSize(),
+      codegen->GetGraph()->IsCompilingBaseline(),
       osr);
 
   if (code == nullptr) {
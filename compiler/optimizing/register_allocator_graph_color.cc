@@ -0,0 +1,844 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register_allocator_graph_color.h"
+
+#include <bitset>
+#include <limits>
+
+#include "code_generator.h"
+#include "register_allocation_resolver.h"
+#include "ssa_liveness_analysis.h"
+
+namespace art {
+
+static constexpr size_t kMaxLifetimePosition = -1;
+
+// Upper bound on the number of registers of one kind on the supported targets.
+static constexpr size_t kMaxNumberOfRegisters = 64;
+
+// Number of coloring attempts after which we consider that the allocator does
+// not converge. Each failed attempt splits or spills some intervals, and in
+// practice coloring succeeds after a few attempts.
+static constexpr size_t kMaxGraphColoringAttemptsDebug = 100;
+
+// Spill weight of intervals that cannot be split any further.
+static constexpr float kUnsplittableSpillWeight = std::numeric_limits<float>::max();
+
+using RegisterBitSet = std::bitset<kMaxNumberOfRegisters>;
+
+static bool IsCoreInterval(LiveInterval* interval) {
+  return (interval->GetType() != Primitive::kPrimDouble)
+      && (interval->GetType() != Primitive::kPrimFloat);
+}
+
+// Returns whether `interval` needs a register at some position it covers.
+static bool RequiresRegister(LiveInterval* interval) {
+  return interval->FirstRegisterUse() != kNoLifetime;
+}
+
+// Returns whether `interval` starts with a definition that requires a register.
+static bool DefinitionRequiresRegister(LiveInterval* interval) {
+  return interval->IsParent() && interval->FirstRegisterUse() == interval->GetStart();
+}
+
+// Returns whether `interval` only covers the register use or definition it
+// requires a register for, so that splitting it further does not help.
+static bool IsUnsplittable(LiveInterval* interval) {
+  return RequiresRegister(interval) && (interval->GetEnd() - interval->GetStart() <= 2);
+}
+
+// Returns whether the live ranges of `first` and `second` intersect.
+static bool Interferes(LiveInterval* first, LiveInterval* second) {
+  LiveRange* first_range = first->GetFirstRange();
+  LiveRange* second_range = second->GetFirstRange();
+  while (first_range != nullptr && second_range != nullptr) {
+    if (first_range->IsBefore(*second_range)) {
+      first_range = first_range->GetNext();
+    } else if (second_range->IsBefore(*first_range)) {
+      second_range = second_range->GetNext();
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the relative execution frequency we assume for the instructions of `block`.
+static float GetFrequencyEstimate(HBasicBlock* block) {
+  size_t loop_depth = 0;
+  for (HLoopInformationOutwardIterator it(*block); !it.Done(); it.Advance()) {
+    ++loop_depth;
+  }
+  // Assume that each loop iterates about eight times.
+  return static_cast<float>(1u << (3u * std::min<size_t>(loop_depth, 8u)));
+}
+
+// Returns the cost of keeping `interval` out of a register, relative to the
+// number of lifetime positions a register would be occupied.
+static float ComputeSpillWeight(LiveInterval* interval) {
+  if (interval->IsTemp() || IsUnsplittable(interval)) {
+    return kUnsplittableSpillWeight;
+  }
+
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+  float use_weight = 0.0f;
+  if (DefinitionRequiresRegister(interval)) {
+    use_weight += GetFrequencyEstimate(interval->GetDefinedBy()->GetBlock());
+  }
+  for (UsePosition* use = interval->GetFirstUse();
+       use != nullptr && use->GetPosition() <= end;
+       use = use->GetNext()) {
+    if (use->GetPosition() > start && !use->IsSynthesized()) {
+      use_weight += GetFrequencyEstimate(use->GetUser()->GetBlock());
+    }
+  }
+  return use_weight / (end - start);
+}
+
+// A node of the interference graph. There is one node for each interval to color,
+// and an edge between the nodes of intervals that are live at the same time.
+class InterferenceNode : public ArenaObject<kArenaAllocRegisterAllocator> {
+ public:
+  InterferenceNode(ArenaAllocator* allocator,
+                   LiveInterval* interval,
+                   const RegisterBitSet& excluded_registers)
+      : interval_(interval),
+        adjacent_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        excluded_registers_(excluded_registers),
+        number_of_excluded_registers_(excluded_registers.count()),
+        spill_weight_(ComputeSpillWeight(interval)),
+        degree_(0),
+        is_simplified_(false),
+        is_in_low_degree_worklist_(false),
+        is_spilled_(false) {}
+
+  LiveInterval* GetInterval() const { return interval_; }
+
+  void AddInterference(InterferenceNode* other) {
+    adjacent_nodes_.push_back(other);
+    ++degree_;
+  }
+
+  const ArenaVector<InterferenceNode*>& GetAdjacentNodes() const { return adjacent_nodes_; }
+
+  const RegisterBitSet& GetExcludedRegisters() const { return excluded_registers_; }
+
+  float GetSpillWeight() const { return spill_weight_; }
+
+  // A node has a low degree if it is guaranteed to get a color, whatever the
+  // colors of the nodes it interferes with that have not been simplified yet.
+  bool IsLowDegree() const {
+    return degree_ + number_of_excluded_registers_ < kMaxNumberOfRegisters;
+  }
+
+  size_t GetDegree() const { return degree_; }
+  void DecrementDegree() { --degree_; }
+
+  bool IsSimplified() const { return is_simplified_; }
+  void SetSimplified() { is_simplified_ = true; }
+
+  bool IsInLowDegreeWorklist() const { return is_in_low_degree_worklist_; }
+  void SetInLowDegreeWorklist() { is_in_low_degree_worklist_ = true; }
+
+  bool IsSpilled() const { return is_spilled_; }
+  void SetSpilled() { is_spilled_ = true; }
+
+ private:
+  LiveInterval* const interval_;
+  ArenaVector<InterferenceNode*> adjacent_nodes_;
+
+  // Registers the interval cannot get: registers blocked by the code generator,
+  // and registers required by instructions or precolored intervals it overlaps.
+  const RegisterBitSet excluded_registers_;
+  const size_t number_of_excluded_registers_;
+
+  const float spill_weight_;
+
+  // Number of adjacent nodes that have not been simplified yet.
+  size_t degree_;
+
+  bool is_simplified_;
+  bool is_in_low_degree_worklist_;
+  bool is_spilled_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterferenceNode);
+};
+
+RegisterAllocatorGraphColor::RegisterAllocatorGraphColor(ArenaAllocator* allocator,
+                                                         CodeGenerator* codegen,
+                                                         const SsaLivenessAnalysis& liveness)
+    : RegisterAllocator(allocator, codegen, liveness),
+      core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      precolored_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      physical_core_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      physical_fp_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      temp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      safepoints_(allocator->Adapter(kArenaAllocRegisterAllocator)) {
+  DCHECK(CanColorFor(codegen->GetInstructionSet()));
+  DCHECK_LE(codegen->GetNumberOfCoreRegisters(), kMaxNumberOfRegisters);
+  DCHECK_LE(codegen->GetNumberOfFloatingPointRegisters(), kMaxNumberOfRegisters);
+  physical_core_register_intervals_.resize(codegen->GetNumberOfCoreRegisters(), nullptr);
+  physical_fp_register_intervals_.resize(codegen->GetNumberOfFloatingPointRegisters(), nullptr);
+}
+
+bool RegisterAllocatorGraphColor::CanColorFor(InstructionSet instruction_set) {
+  // Register pairs are not supported.
+  return instruction_set == kArm64
+      || instruction_set == kMips64
+      || instruction_set == kX86_64;
+}
+
+void RegisterAllocatorGraphColor::AllocateRegisters() {
+  ProcessInstructions();
+
+  // A failed coloring attempt splits or spills the intervals that did not get
+  // a register, so that the next attempt has more chances to succeed.
+  for (size_t attempt = 0; !ColorIntervals(/* processing_core_registers */ true); ++attempt) {
+    DCHECK_LT(attempt, kMaxGraphColoringAttemptsDebug) << "Core register coloring diverges";
+  }
+  for (size_t attempt = 0; !ColorIntervals(/* processing_core_registers */ false); ++attempt) {
+    DCHECK_LT(attempt, kMaxGraphColoringAttemptsDebug) << "FP register coloring diverges";
+  }
+
+  for (size_t i = 0, e = liveness_.GetNumberOfSsaValues(); i < e; ++i) {
+    LiveInterval* interval = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    for (LiveInterval* sibling = interval;
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (sibling->HasRegister()) {
+        codegen_->AddAllocatedRegister(sibling->ToLocation());
+      }
+    }
+  }
+  for (LiveInterval* temp : temp_intervals_) {
+    codegen_->AddAllocatedRegister(temp->IsFloatingPoint()
+        ? Location::FpuRegisterLocation(temp->GetRegister())
+        : Location::RegisterLocation(temp->GetRegister()));
+  }
+
+  AllocateSpillSlots();
+
+  RegisterAllocationResolver(allocator_, codegen_, liveness_)
+      .Resolve(ComputeMaxSafepointLiveRegisters(/* processing_core_registers */ true),
+               ComputeMaxSafepointLiveRegisters(/* processing_core_registers */ false),
+               reserved_out_slots_,
+               int_spill_slots_.size(),
+               long_spill_slots_.size(),
+               float_spill_slots_.size(),
+               double_spill_slots_.size(),
+               catch_phi_spill_slots_,
+               temp_intervals_);
+
+  if (kIsDebugBuild) {
+    Validate(/* log_fatal_on_failure */ true);
+  }
+}
+
+bool RegisterAllocatorGraphColor::Validate(bool log_fatal_on_failure) {
+  for (bool processing_core_registers : {true, false}) {
+    ArenaVector<LiveInterval*> intervals(
+        allocator_->Adapter(kArenaAllocRegisterAllocatorValidate));
+    for (size_t i = 0, e = liveness_.GetNumberOfSsaValues(); i < e; ++i) {
+      LiveInterval* interval = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+      if (interval != nullptr && IsCoreInterval(interval) == processing_core_registers) {
+        intervals.push_back(interval);
+      }
+    }
+
+    const ArenaVector<LiveInterval*>& physical_register_intervals = processing_core_registers
+        ? physical_core_register_intervals_
+        : physical_fp_register_intervals_;
+    for (LiveInterval* fixed : physical_register_intervals) {
+      if (fixed != nullptr) {
+        intervals.push_back(fixed);
+      }
+    }
+
+    for (LiveInterval* temp : temp_intervals_) {
+      if (IsCoreInterval(temp) == processing_core_registers) {
+        intervals.push_back(temp);
+      }
+    }
+
+    if (!ValidateIntervals(intervals, GetNumberOfSpillSlots(), reserved_out_slots_, *codegen_,
+                           allocator_, processing_core_registers, log_fatal_on_failure)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RegisterAllocatorGraphColor::ProcessInstructions() {
+  // Iterate post-order, so that catch phi spill slots are allocated in reverse
+  // linear order, as `AllocateSpillSlotForCatchPhi` requires.
+  for (HLinearPostOrderIterator it(*codegen_->GetGraph()); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HBackwardInstructionIterator back_it(block->GetInstructions()); !back_it.Done();
+         back_it.Advance()) {
+      ProcessInstruction(back_it.Current());
+    }
+    for (HInstructionIterator inst_it(block->GetPhis()); !inst_it.Done(); inst_it.Advance()) {
+      ProcessInstruction(inst_it.Current());
+    }
+
+    if (block->IsCatchBlock() ||
+        (block->IsLoopHeader() && block->GetLoopInformation()->IsIrreducible())) {
+      // By blocking all registers at the top of each catch block or irreducible loop, we force
+      // intervals belonging to the live-in set of the catch/header block to be spilled.
+      size_t position = block->GetLifetimeStart();
+      BlockRegisters(position, position + 1);
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ProcessInstruction(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+
+  if (locations == nullptr) return;
+
+  // Create synthesized intervals for temporaries.
+  for (size_t i = 0; i < locations->GetTempCount(); ++i) {
+    Location temp = locations->GetTemp(i);
+    if (temp.IsRegister() || temp.IsFpuRegister()) {
+      BlockRegister(temp, position, position + 1);
+      // Ensure that an explicit temporary register is marked as being allocated.
+      codegen_->AddAllocatedRegister(temp);
+    } else {
+      DCHECK(temp.IsUnallocated());
+      LiveInterval* interval = nullptr;
+      switch (temp.GetPolicy()) {
+        case Location::kRequiresRegister:
+          interval = LiveInterval::MakeTempInterval(allocator_, Primitive::kPrimInt);
+          break;
+
+        case Location::kRequiresFpuRegister:
+          interval = LiveInterval::MakeTempInterval(allocator_, Primitive::kPrimDouble);
+          break;
+
+        default:
+          LOG(FATAL) << "Unexpected policy for temporary location "
+                     << temp.GetPolicy();
+      }
+      interval->AddTempUse(instruction, i);
+      temp_intervals_.push_back(interval);
+      AddToColoringList(interval);
+    }
+  }
+
+  if (locations->NeedsSafepoint()) {
+    if (codegen_->IsLeafMethod()) {
+      // We do not want the suspend check to artificially create live registers.
+      DCHECK(instruction->IsSuspendCheckEntry());
+      instruction->GetBlock()->RemoveInstruction(instruction);
+      return;
+    }
+    safepoints_.push_back(instruction);
+  }
+
+  if (locations->WillCall()) {
+    BlockRegisters(position, position + 1, /* caller_save_only */ true);
+  }
+
+  for (size_t i = 0; i < instruction->InputCount(); ++i) {
+    Location input = locations->InAt(i);
+    DCHECK(!input.IsPair());
+    if (input.IsRegister() || input.IsFpuRegister()) {
+      BlockRegister(input, position, position + 1);
+    }
+  }
+
+  LiveInterval* interval = instruction->GetLiveInterval();
+  if (interval == nullptr) return;
+
+  DCHECK(!codegen_->NeedsTwoRegisters(interval->GetType()));
+
+  for (size_t safepoint_index = safepoints_.size(); safepoint_index > 0; --safepoint_index) {
+    HInstruction* safepoint = safepoints_[safepoint_index - 1u];
+    size_t safepoint_position = safepoint->GetLifetimePosition();
+
+    if (safepoint_position == interval->GetStart()) {
+      // The safepoint is for this instruction, so the location of the instruction
+      // does not need to be saved.
+      DCHECK_EQ(safepoint, instruction);
+      continue;
+    } else if (interval->IsDeadAt(safepoint_position)) {
+      break;
+    } else if (!interval->Covers(safepoint_position)) {
+      // Hole in the interval.
+      continue;
+    }
+    interval->AddSafepoint(safepoint);
+  }
+  interval->ResetSearchCache();
+
+  // Some instructions define their output in a fixed register or stack slot.
+  Location output = locations->Out();
+  if (output.IsUnallocated() && output.GetPolicy() == Location::kSameAsFirstInput) {
+    Location first = locations->InAt(0);
+    if (first.IsRegister() || first.IsFpuRegister()) {
+      interval->SetFrom(position + 1);
+      interval->SetRegister(first.reg());
+    }
+  } else if (output.IsRegister() || output.IsFpuRegister()) {
+    // Shift the interval's start by one to account for the blocked register.
+    interval->SetFrom(position + 1);
+    interval->SetRegister(output.reg());
+    BlockRegister(output, position, position + 1);
+  } else if (output.IsStackSlot() || output.IsDoubleStackSlot()) {
+    interval->SetSpillSlot(output.GetStackIndex());
+  } else {
+    DCHECK(output.IsUnallocated() || output.IsConstant());
+  }
+
+  if (instruction->IsPhi() && instruction->AsPhi()->IsCatchPhi()) {
+    AllocateSpillSlotForCatchPhi(instruction->AsPhi());
+  }
+
+  if (interval->HasRegister()) {
+    // Keep the register decided by the code generator only up to the next
+    // instruction, so that it does not constrain the rest of the interval.
+    precolored_intervals_.push_back(interval);
+    size_t next_position = position + 2;
+    if (next_position < interval->GetEnd()) {
+      AddToColoringList(Split(interval, next_position));
+    }
+  } else if (interval->HasSpillSlot() || instruction->IsConstant()) {
+    // Split just before first register use.
+    size_t first_register_use = interval->FirstRegisterUse();
+    if (first_register_use != kNoLifetime) {
+      AddToColoringList(SplitBetween(interval, interval->GetStart(), first_register_use - 1));
+    }
+  } else {
+    AddToColoringList(interval);
+  }
+}
+
+void RegisterAllocatorGraphColor::BlockRegister(Location location, size_t start, size_t end) {
+  int reg = location.reg();
+  DCHECK(location.IsRegister() || location.IsFpuRegister());
+  LiveInterval* interval = location.IsRegister()
+      ? physical_core_register_intervals_[reg]
+      : physical_fp_register_intervals_[reg];
+  Primitive::Type type = location.IsRegister()
+      ? Primitive::kPrimInt
+      : Primitive::kPrimFloat;
+  if (interval == nullptr) {
+    interval = LiveInterval::MakeFixedInterval(allocator_, reg, type);
+    if (location.IsRegister()) {
+      physical_core_register_intervals_[reg] = interval;
+    } else {
+      physical_fp_register_intervals_[reg] = interval;
+    }
+  }
+  DCHECK(interval->GetRegister() == reg);
+  interval->AddRange(start, end);
+}
+
+void RegisterAllocatorGraphColor::BlockRegisters(size_t start, size_t end, bool caller_save_only) {
+  for (size_t i = 0; i < codegen_->GetNumberOfCoreRegisters(); ++i) {
+    if (!caller_save_only || !codegen_->IsCoreCalleeSaveRegister(i)) {
+      BlockRegister(Location::RegisterLocation(i), start, end);
+    }
+  }
+  for (size_t i = 0; i < codegen_->GetNumberOfFloatingPointRegisters(); ++i) {
+    if (!caller_save_only || !codegen_->IsFloatingPointCalleeSaveRegister(i)) {
+      BlockRegister(Location::FpuRegisterLocation(i), start, end);
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::AddToColoringList(LiveInterval* interval) {
+  DCHECK(!interval->IsFixed());
+  if (IsCoreInterval(interval)) {
+    core_intervals_.push_back(interval);
+  } else {
+    fp_intervals_.push_back(interval);
+  }
+}
+
+bool RegisterAllocatorGraphColor::IsBlocked(int reg, bool processing_core_registers) const {
+  return processing_core_registers
+      ? codegen_->GetBlockedCoreRegisters()[reg]
+      : codegen_->GetBlockedFloatingPointRegisters()[reg];
+}
+
+bool RegisterAllocatorGraphColor::IsCallerSaveRegister(int reg,
+                                                       bool processing_core_registers) const {
+  return processing_core_registers
+      ? !codegen_->IsCoreCalleeSaveRegister(reg)
+      : !codegen_->IsFloatingPointCalleeSaveRegister(reg);
+}
+
+// Returns the register of a split sibling of `interval` that is adjacent to it,
+// if that register is not in `excluded`. Using it avoids a move between the two.
+static int FindSiblingHint(LiveInterval* interval, const RegisterBitSet& excluded) {
+  for (LiveInterval* sibling = interval->GetParent();
+       sibling != nullptr;
+       sibling = sibling->GetNextSibling()) {
+    if (sibling != interval
+        && sibling->HasRegister()
+        && !excluded.test(sibling->GetRegister())
+        && (sibling->GetEnd() == interval->GetStart()
+            || sibling->GetStart() == interval->GetEnd())) {
+      return sibling->GetRegister();
+    }
+  }
+  return kNoRegister;
+}
+
+bool RegisterAllocatorGraphColor::ColorIntervals(bool processing_core_registers) {
+  ArenaVector<LiveInterval*>& intervals = processing_core_registers
+      ? core_intervals_
+      : fp_intervals_;
+  size_t number_of_registers = processing_core_registers
+      ? codegen_->GetNumberOfCoreRegisters()
+      : codegen_->GetNumberOfFloatingPointRegisters();
+
+  // Registers that no interval can get.
+  RegisterBitSet blocked_registers;
+  for (size_t reg = 0; reg < kMaxNumberOfRegisters; ++reg) {
+    if (reg >= number_of_registers || IsBlocked(reg, processing_core_registers)) {
+      blocked_registers.set(reg);
+    }
+  }
+
+  // Registers required at a given lifetime position, either by an instruction
+  // or by a precolored interval, sorted by position.
+  ArenaVector<std::pair<size_t, int>> fixed_registers(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  auto add_fixed_register = [&fixed_registers](LiveInterval* interval, int reg) {
+    for (LiveRange* range = interval->GetFirstRange(); range != nullptr; range = range->GetNext()) {
+      for (size_t position = range->GetStart(); position < range->GetEnd(); ++position) {
+        fixed_registers.push_back(std::make_pair(position, reg));
+      }
+    }
+  };
+  const ArenaVector<LiveInterval*>& physical_register_intervals = processing_core_registers
+      ? physical_core_register_intervals_
+      : physical_fp_register_intervals_;
+  for (LiveInterval* fixed : physical_register_intervals) {
+    if (fixed != nullptr) {
+      add_fixed_register(fixed, fixed->GetRegister());
+    }
+  }
+  for (LiveInterval* precolored : precolored_intervals_) {
+    if (IsCoreInterval(precolored) == processing_core_registers) {
+      add_fixed_register(precolored, precolored->GetRegister());
+    }
+  }
+  std::sort(fixed_registers.begin(), fixed_registers.end());
+
+  // Build the interference graph.
+  ArenaVector<InterferenceNode*> nodes(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  nodes.reserve(intervals.size());
+  for (LiveInterval* interval : intervals) {
+    interval->ClearRegister();
+    RegisterBitSet excluded_registers = blocked_registers;
+    for (LiveRange* range = interval->GetFirstRange(); range != nullptr; range = range->GetNext()) {
+      for (auto it = std::lower_bound(fixed_registers.begin(),
+                                      fixed_registers.end(),
+                                      std::make_pair(range->GetStart(), 0));
+           it != fixed_registers.end() && it->first < range->GetEnd();
+           ++it) {
+        excluded_registers.set(it->second);
+      }
+    }
+    nodes.push_back(new (allocator_) InterferenceNode(allocator_, interval, excluded_registers));
+  }
+
+  // Sweep over the intervals in order of their start, keeping the ones that
+  // may still be live, to find the intervals that interfere.
+  std::sort(nodes.begin(), nodes.end(), [](InterferenceNode* lhs, InterferenceNode* rhs) {
+    return lhs->GetInterval()->GetStart() < rhs->GetInterval()->GetStart();
+  });
+  ArenaVector<InterferenceNode*> live(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (InterferenceNode* node : nodes) {
+    size_t start = node->GetInterval()->GetStart();
+    live.erase(std::remove_if(live.begin(),
+                              live.end(),
+                              [start](InterferenceNode* other) {
+                                return other->GetInterval()->GetEnd() <= start;
+                              }),
+               live.end());
+    for (InterferenceNode* other : live) {
+      if (Interferes(node->GetInterval(), other->GetInterval())) {
+        node->AddInterference(other);
+        other->AddInterference(node);
+      }
+    }
+    live.push_back(node);
+  }
+
+  // Simplify: remove the nodes from the graph one at a time, starting with the
+  // ones guaranteed to get a color. When only high degree nodes remain, remove the
+  // one that is cheapest to spill, optimistically hoping it still gets a color.
+  ArenaVector<InterferenceNode*> low_degree_worklist(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ArenaVector<InterferenceNode*> high_degree_worklist(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ArenaVector<InterferenceNode*> stack(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (InterferenceNode* node : nodes) {
+    if (node->IsLowDegree()) {
+      node->SetInLowDegreeWorklist();
+      low_degree_worklist.push_back(node);
+    } else {
+      high_degree_worklist.push_back(node);
+    }
+  }
+  while (stack.size() != nodes.size()) {
+    InterferenceNode* node = nullptr;
+    if (!low_degree_worklist.empty()) {
+      node = low_degree_worklist.back();
+      low_degree_worklist.pop_back();
+    } else {
+      high_degree_worklist.erase(
+          std::remove_if(high_degree_worklist.begin(),
+                         high_degree_worklist.end(),
+                         [](InterferenceNode* other) { return other->IsInLowDegreeWorklist(); }),
+          high_degree_worklist.end());
+      DCHECK(!high_degree_worklist.empty());
+      auto cheapest = std::min_element(
+          high_degree_worklist.begin(),
+          high_degree_worklist.end(),
+          [](InterferenceNode* lhs, InterferenceNode* rhs) {
+            return lhs->GetSpillWeight() / (lhs->GetDegree() + 1)
+                < rhs->GetSpillWeight() / (rhs->GetDegree() + 1);
+          });
+      node = *cheapest;
+      high_degree_worklist.erase(cheapest);
+    }
+
+    node->SetSimplified();
+    stack.push_back(node);
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (!adjacent->IsSimplified()) {
+        adjacent->DecrementDegree();
+        if (!adjacent->IsInLowDegreeWorklist() && adjacent->IsLowDegree()) {
+          adjacent->SetInLowDegreeWorklist();
+          low_degree_worklist.push_back(adjacent);
+        }
+      }
+    }
+  }
+
+  // Select: color the nodes in the reverse order of their removal.
+  ArenaVector<InterferenceNode*> uncolored(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  size_t free_until[kMaxNumberOfRegisters];
+  while (!stack.empty()) {
+    InterferenceNode* node = stack.back();
+    stack.pop_back();
+    LiveInterval* interval = node->GetInterval();
+
+    RegisterBitSet excluded_registers = node->GetExcludedRegisters();
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (adjacent->GetInterval()->HasRegister()) {
+        excluded_registers.set(adjacent->GetInterval()->GetRegister());
+      }
+    }
+    if (excluded_registers.all()) {
+      uncolored.push_back(node);
+      continue;
+    }
+
+    // Prefer the register of intervals related to this one, so that the
+    // resolver does not need to insert moves between them.
+    for (size_t reg = 0; reg < kMaxNumberOfRegisters; ++reg) {
+      free_until[reg] = excluded_registers.test(reg) ? 0u : kMaxLifetimePosition;
+    }
+    int reg = interval->IsTemp()
+        ? kNoRegister
+        : interval->FindFirstRegisterHint(free_until, liveness_);
+    if (reg == kNoRegister) {
+      reg = FindSiblingHint(interval, excluded_registers);
+    }
+    if (reg == kNoRegister) {
+      // Prefer caller-save registers, which do not need to be saved in the frame entry.
+      for (size_t i = 0; i < number_of_registers; ++i) {
+        if (excluded_registers.test(i)) {
+          continue;
+        }
+        if (IsCallerSaveRegister(i, processing_core_registers)) {
+          reg = i;
+          break;
+        }
+        if (reg == kNoRegister) {
+          reg = i;
+        }
+      }
+    }
+    DCHECK_NE(reg, kNoRegister);
+    DCHECK(!excluded_registers.test(reg));
+    interval->SetRegister(reg);
+  }
+
+  if (uncolored.empty()) {
+    return true;
+  }
+
+  // Intervals that need a register only at some positions are split around them,
+  // and intervals that do not need one stay in their spill slot. An interval that
+  // cannot be split makes its neighbors give up their register instead.
+  ArenaVector<InterferenceNode*> spilled(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (InterferenceNode* node : uncolored) {
+    if (!IsUnsplittable(node->GetInterval()) && !node->GetInterval()->IsTemp()) {
+      if (!node->IsSpilled()) {
+        node->SetSpilled();
+        spilled.push_back(node);
+      }
+      continue;
+    }
+    bool has_spilled_adjacent = false;
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      LiveInterval* adjacent_interval = adjacent->GetInterval();
+      if (adjacent_interval->HasRegister()
+          && !adjacent_interval->IsTemp()
+          && !IsUnsplittable(adjacent_interval)
+          && !adjacent->IsSpilled()) {
+        adjacent->SetSpilled();
+        spilled.push_back(adjacent);
+        has_spilled_adjacent = true;
+      }
+    }
+    if (!has_spilled_adjacent) {
+      LOG(FATAL) << "Cannot find a register for an unsplittable interval";
+    }
+  }
+
+  intervals.clear();
+  for (InterferenceNode* node : nodes) {
+    if (!node->IsSpilled()) {
+      intervals.push_back(node->GetInterval());
+    }
+  }
+  for (InterferenceNode* node : spilled) {
+    LiveInterval* interval = node->GetInterval();
+    interval->ClearRegister();
+    if (RequiresRegister(interval)) {
+      SplitAtRegisterUses(interval);
+    }
+  }
+  return false;
+}
+
+LiveInterval* RegisterAllocatorGraphColor::TrySplit(LiveInterval* interval, size_t position) {
+  if (interval->GetStart() < position && position < interval->GetEnd()) {
+    LiveInterval* split = Split(interval, position);
+    AddToColoringList(split);
+    return split;
+  }
+  return interval;
+}
+
+void RegisterAllocatorGraphColor::SplitAtRegisterUses(LiveInterval* interval) {
+  DCHECK(!interval->IsTemp());
+  DCHECK(!interval->HasRegister());
+  AddToColoringList(interval);
+
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+
+  // Split just after a definition requiring a register.
+  if (DefinitionRequiresRegister(interval)) {
+    interval = TrySplit(interval, start + 1);
+  }
+
+  // Split around each use requiring a register. Note that a use at the end
+  // of an interval belongs to it, and not to the next sibling.
+  for (UsePosition* use = interval->GetFirstUse();
+       use != nullptr && use->GetPosition() <= end;
+       use = use->GetNext()) {
+    size_t position = use->GetPosition();
+    if (position <= start || !use->RequiresRegister()) {
+      continue;
+    }
+    interval = TrySplit(interval, position - 1);
+    HInstruction* user = liveness_.GetInstructionFromPosition(position / 2);
+    if (user != nullptr && user->IsControlFlow()) {
+      // Moves cannot be inserted after a control flow instruction: split
+      // at the start of the next block instead.
+      interval = TrySplit(interval, position + 1);
+    } else {
+      interval = TrySplit(interval, position);
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlots() {
+  // Values are spilled eagerly at their definition, so a value that does not
+  // live in a register for its whole lifetime needs a spill slot.
+  ArenaVector<LiveInterval*> spilled(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (size_t i = 0, e = liveness_.GetNumberOfSsaValues(); i < e; ++i) {
+    LiveInterval* interval = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    if (interval->HasSpillSlot()) {
+      continue;
+    }
+    for (LiveInterval* sibling = interval;
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister()) {
+        spilled.push_back(interval);
+        break;
+      }
+    }
+  }
+
+  // Allocating in order of lifetime start lets values that are not live at
+  // the same time share spill slots.
+  std::sort(spilled.begin(), spilled.end(), [](LiveInterval* lhs, LiveInterval* rhs) {
+    return lhs->GetStart() < rhs->GetStart();
+  });
+  for (LiveInterval* interval : spilled) {
+    AllocateSpillSlotFor(interval);
+  }
+}
+
+size_t RegisterAllocatorGraphColor::ComputeMaxSafepointLiveRegisters(
+    bool processing_core_registers) const {
+  // The live registers at a slow path safepoint are those of the intervals
+  // covering it. They are saved by the slow path, in the frame.
+  ArenaVector<size_t> live_registers(liveness_.GetMaxLifetimePosition() / 2 + 1,
+                                     0u,
+                                     allocator_->Adapter(kArenaAllocRegisterAllocator));
+  size_t max_live_registers = 0u;
+  for (size_t i = 0, e = liveness_.GetNumberOfSsaValues(); i < e; ++i) {
+    LiveInterval* interval = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    if (IsCoreInterval(interval) != processing_core_registers) {
+      continue;
+    }
+    for (LiveInterval* sibling = interval;
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister()) {
+        continue;
+      }
+      for (SafepointPosition* safepoint = sibling->GetFirstSafepoint();
+           safepoint != nullptr;
+           safepoint = safepoint->GetNext()) {
+        if (safepoint->GetLocations()->OnlyCallsOnSlowPath()) {
+          size_t count = ++live_registers[safepoint->GetPosition() / 2];
+          max_live_registers = std::max(max_live_registers, count);
+        }
+      }
+    }
+  }
+  return max_live_registers;
+}
+
+}  // namespace art
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+#define ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+
+#include "arch/instruction_set.h"
+#include "base/arena_containers.h"
+#include "base/macros.h"
+#include "primitive.h"
+#include "register_allocator.h"
+
+namespace art {
+
+class CodeGenerator;
+class HInstruction;
+class LiveInterval;
+class Location;
+class SsaLivenessAnalysis;
+
+/**
+ * A graph coloring register allocator on an `HGraph` with SSA form.
+ *
+ * The allocator builds an interference graph between the live intervals of
+ * each register kind, and colors it with Chaitin-Briggs optimistic coloring.
+ * Registers required at specific positions (fixed inputs and outputs, temps,
+ * calls) constrain the colors available to the intervals live there. When
+ * selecting a color, the allocator prefers the register of related intervals
+ * (phi inputs, split siblings, fixed uses) to avoid moves. Intervals that
+ * cannot be colored are split around their register uses, with the parts in
+ * between living in a spill slot, and coloring is attempted again.
+ *
+ * Compared to linear scan, coloring takes a global view of the interferences,
+ * which results in fewer spills and moves at the expense of compile time. It
+ * does not support register pairs, so it is only used on 64-bit targets.
+ */
+class RegisterAllocatorGraphColor : public RegisterAllocator {
+ public:
+  RegisterAllocatorGraphColor(ArenaAllocator* allocator,
+                              CodeGenerator* codegen,
+                              const SsaLivenessAnalysis& analysis);
+
+  void AllocateRegisters() OVERRIDE;
+
+  bool Validate(bool log_fatal_on_failure) OVERRIDE;
+
+  // Returns whether graph coloring can allocate registers for `instruction_set`.
+  static bool CanColorFor(InstructionSet instruction_set);
+
+ private:
+  // Collect all intervals, fixed register constraints and safepoints.
+  void ProcessInstructions();
+  void ProcessInstruction(HInstruction* instruction);
+
+  // Update the interval for the register in `location` to cover [start, end).
+  void BlockRegister(Location location, size_t start, size_t end);
+  void BlockRegisters(size_t start, size_t end, bool caller_save_only = false);
+
+  // Add `interval` to the intervals to color for its register kind.
+  void AddToColoringList(LiveInterval* interval);
+
+  // Try to color the intervals of one register kind. Intervals that do not get
+  // a color are either left in their spill slot, or split around their register
+  // uses. Returns false if some intervals were split, and coloring has to be
+  // attempted again.
+  bool ColorIntervals(bool processing_core_registers);
+
+  // Split `interval` so that each register use and a definition requiring a
+  // register are in their own short interval, and add the new intervals to
+  // the coloring list.
+  void SplitAtRegisterUses(LiveInterval* interval);
+
+  // Split `interval` at `position` if it is strictly inside the interval, and add
+  // the new sibling to the coloring list. Returns the interval covering `position`.
+  LiveInterval* TrySplit(LiveInterval* interval, size_t position);
+
+  // Allocate spill slots for the values that do not live in a register for
+  // their whole lifetime.
+  void AllocateSpillSlots();
+
+  // Compute the maximum number of registers live at a slow path safepoint.
+  size_t ComputeMaxSafepointLiveRegisters(bool processing_core_registers) const;
+
+  bool IsBlocked(int reg, bool processing_core_registers) const;
+  bool IsCallerSaveRegister(int reg, bool processing_core_registers) const;
+
+  // Intervals to color for core and floating point registers.
+  ArenaVector<LiveInterval*> core_intervals_;
+  ArenaVector<LiveInterval*> fp_intervals_;
+
+  // Intervals whose register was decided by the code generator. They are
+  // not colored, but constrain the colors of the intervals they interfere with.
+  ArenaVector<LiveInterval*> precolored_intervals_;
+
+  // Fixed intervals for physical registers. Such intervals cover the positions
+  // where an instruction requires a specific register.
+  ArenaVector<LiveInterval*> physical_core_register_intervals_;
+  ArenaVector<LiveInterval*> physical_fp_register_intervals_;
+
+  // Intervals for temporaries. Such intervals cover the positions
+  // where an instruction requires a temporary.
+  ArenaVector<LiveInterval*> temp_intervals_;
+
+  // Instructions that need a safepoint.
+  ArenaVector<HInstruction*> safepoints_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorGraphColor);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
@@ -15,16 +15,18 @@
  */
 
 #include "arch/x86/instruction_set_features_x86.h"
+#include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "base/arena_allocator.h"
 #include "builder.h"
 #include "code_generator.h"
 #include "code_generator_x86.h"
+#include "code_generator_x86_64.h"
 #include "dex_file.h"
 #include "dex_instruction.h"
 #include "driver/compiler_options.h"
 #include "nodes.h"
 #include "optimizing_unit_test.h"
-#include "register_allocator.h"
+#include "register_allocator_linear_scan.h"
 #include "ssa_liveness_analysis.h"
 #include "ssa_phi_elimination.h"
 
@@ -44,11 +46,28 @@ static bool Check(const uint16_t* data) {
   x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
   SsaLivenessAnalysis liveness(graph, &codegen);
   liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+  RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
   register_allocator.AllocateRegisters();
   return register_allocator.Validate(false);
 }
 
+// Same as `Check`, using the graph coloring register allocator, which does not
+// support the register pairs of x86.
+static bool CheckGraphColor(const uint16_t* data) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HGraph* graph = CreateCFG(&allocator, data);
+  std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+      X86_64InstructionSetFeatures::FromCppDefines());
+  x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+  SsaLivenessAnalysis liveness(graph, &codegen);
+  liveness.Analyze();
+  RegisterAllocator* register_allocator = RegisterAllocator::Create(
+      &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+  register_allocator->AllocateRegisters();
+  return register_allocator->Validate(false);
+}
+
 /**
  * Unit testing of RegisterAllocator::ValidateIntervals. Register allocator
  * tests are based on this validation method.
@@ -160,6 +179,7 @@ TEST_F(RegisterAllocatorTest, CFG1) {
     Instruction::RETURN);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(CheckGraphColor(data));
 }
 
 TEST_F(RegisterAllocatorTest, Loop1) {
@@ -199,6 +219,7 @@ TEST_F(RegisterAllocatorTest, Loop1) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(CheckGraphColor(data));
 }
 
 TEST_F(RegisterAllocatorTest, Loop2) {
@@ -248,6 +269,24 @@ TEST_F(RegisterAllocatorTest, Loop2) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(CheckGraphColor(data));
+}
+
+// The phi of the Loop3 graph is still live when its back edge input is computed,
+// and is returned after the loop.
+static void CheckLoop3Registers(HGraph* graph) {
+  HBasicBlock* loop_header = graph->GetBlocks()[2];
+  HPhi* phi = loop_header->GetFirstPhi()->AsPhi();
+
+  LiveInterval* phi_interval = phi->GetLiveInterval();
+  LiveInterval* loop_update = phi->InputAt(1)->GetLiveInterval();
+  ASSERT_TRUE(phi_interval->HasRegister());
+  ASSERT_TRUE(loop_update->HasRegister());
+  ASSERT_NE(phi_interval->GetRegister(), loop_update->GetRegister());
+
+  HBasicBlock* return_block = graph->GetBlocks()[3];
+  HReturn* ret = return_block->GetLastInstruction()->AsReturn();
+  ASSERT_EQ(phi_interval->GetRegister(), ret->InputAt(0)->GetLiveInterval()->GetRegister());
 }
 
 TEST_F(RegisterAllocatorTest, Loop3) {
@@ -289,28 +328,33 @@ TEST_F(RegisterAllocatorTest, Loop3) {
 
   ArenaPool pool;
   ArenaAllocator allocator(&pool);
-  HGraph* graph = CreateCFG(&allocator, data);
-  std::unique_ptr<const X86InstructionSetFeatures> features_x86(
-      X86InstructionSetFeatures::FromCppDefines());
-  x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
-  SsaLivenessAnalysis liveness(graph, &codegen);
-  liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
-  register_allocator.AllocateRegisters();
-  ASSERT_TRUE(register_allocator.Validate(false));
 
-  HBasicBlock* loop_header = graph->GetBlocks()[2];
-  HPhi* phi = loop_header->GetFirstPhi()->AsPhi();
-
-  LiveInterval* phi_interval = phi->GetLiveInterval();
-  LiveInterval* loop_update = phi->InputAt(1)->GetLiveInterval();
-  ASSERT_TRUE(phi_interval->HasRegister());
-  ASSERT_TRUE(loop_update->HasRegister());
-  ASSERT_NE(phi_interval->GetRegister(), loop_update->GetRegister());
+  {
+    HGraph* graph = CreateCFG(&allocator, data);
+    std::unique_ptr<const X86InstructionSetFeatures> features_x86(
+        X86InstructionSetFeatures::FromCppDefines());
+    x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
+    register_allocator.AllocateRegisters();
+    ASSERT_TRUE(register_allocator.Validate(false));
+    CheckLoop3Registers(graph);
+  }
 
-  HBasicBlock* return_block = graph->GetBlocks()[3];
-  HReturn* ret = return_block->GetLastInstruction()->AsReturn();
-  ASSERT_EQ(phi_interval->GetRegister(), ret->InputAt(0)->GetLiveInterval()->GetRegister());
+  {
+    HGraph* graph = CreateCFG(&allocator, data);
+    std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+        X86_64InstructionSetFeatures::FromCppDefines());
+    x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+    ASSERT_TRUE(register_allocator->Validate(false));
+    CheckLoop3Registers(graph);
+  }
 }
 
 TEST_F(RegisterAllocatorTest, FirstRegisterUse) {
@@ -377,16 +421,33 @@ TEST_F(RegisterAllocatorTest, DeadPhi) {
 
   ArenaPool pool;
   ArenaAllocator allocator(&pool);
-  HGraph* graph = CreateCFG(&allocator, data);
-  SsaDeadPhiElimination(graph).Run();
-  std::unique_ptr<const X86InstructionSetFeatures> features_x86(
-      X86InstructionSetFeatures::FromCppDefines());
-  x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
-  SsaLivenessAnalysis liveness(graph, &codegen);
-  liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
-  register_allocator.AllocateRegisters();
-  ASSERT_TRUE(register_allocator.Validate(false));
+
+  {
+    HGraph* graph = CreateCFG(&allocator, data);
+    SsaDeadPhiElimination(graph).Run();
+    std::unique_ptr<const X86InstructionSetFeatures> features_x86(
+        X86InstructionSetFeatures::FromCppDefines());
+    x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
+    register_allocator.AllocateRegisters();
+    ASSERT_TRUE(register_allocator.Validate(false));
+  }
+
+  {
+    HGraph* graph = CreateCFG(&allocator, data);
+    SsaDeadPhiElimination(graph).Run();
+    std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+        X86_64InstructionSetFeatures::FromCppDefines());
+    x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+    ASSERT_TRUE(register_allocator->Validate(false));
+  }
 }
 
 /**
@@ -408,7 +469,7 @@ TEST_F(RegisterAllocatorTest, FreeUntil) {
   x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
   SsaLivenessAnalysis liveness(graph, &codegen);
   liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+  RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
 
   // Add an artifical range to cover the temps that will be put in the unhandled list.
   LiveInterval* unhandled = graph->GetEntryBlock()->GetFirstInstruction()->GetLiveInterval();
@@ -541,7 +602,7 @@ TEST_F(RegisterAllocatorTest, PhiHint) {
     liveness.Analyze();
 
     // Check that the register allocator is deterministic.
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 0);
@@ -560,7 +621,7 @@ TEST_F(RegisterAllocatorTest, PhiHint) {
     // Set the phi to a specific register, and check that the inputs get allocated
     // the same register.
     phi->GetLocations()->UpdateOut(Location::RegisterLocation(2));
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 2);
@@ -579,7 +640,7 @@ TEST_F(RegisterAllocatorTest, PhiHint) {
     // Set input1 to a specific register, and check that the phi and other input get allocated
     // the same register.
     input1->GetLocations()->UpdateOut(Location::RegisterLocation(2));
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 2);
@@ -598,13 +659,32 @@ TEST_F(RegisterAllocatorTest, PhiHint) {
     // Set input2 to a specific register, and check that the phi and other input get allocated
     // the same register.
     input2->GetLocations()->UpdateOut(Location::RegisterLocation(2));
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 2);
     ASSERT_EQ(input2->GetLiveInterval()->GetRegister(), 2);
     ASSERT_EQ(phi->GetLiveInterval()->GetRegister(), 2);
   }
+
+  {
+    HGraph* graph = BuildIfElseWithPhi(&allocator, &phi, &input1, &input2);
+    std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+        X86_64InstructionSetFeatures::FromCppDefines());
+    x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+
+    // Graph coloring keeps the register fixed for the phi, and the moves from
+    // the inputs into it must be valid.
+    phi->GetLocations()->UpdateOut(Location::RegisterLocation(2));
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+
+    ASSERT_TRUE(register_allocator->Validate(false));
+    ASSERT_EQ(phi->GetLiveInterval()->GetRegister(), 2);
+  }
 }
 
 static HGraph* BuildFieldReturn(ArenaAllocator* allocator,
@@ -658,7 +738,7 @@ TEST_F(RegisterAllocatorTest, ExpectedInRegisterHint) {
     SsaLivenessAnalysis liveness(graph, &codegen);
     liveness.Analyze();
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     // Sanity check that in normal conditions, the register should be hinted to 0 (EAX).
@@ -677,11 +757,30 @@ TEST_F(RegisterAllocatorTest, ExpectedInRegisterHint) {
     // Don't use SetInAt because we are overriding an already allocated location.
     ret->GetLocations()->inputs_[0] = Location::RegisterLocation(2);
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(field->GetLiveInterval()->GetRegister(), 2);
   }
+
+  {
+    HGraph* graph = BuildFieldReturn(&allocator, &field, &ret);
+    std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+        X86_64InstructionSetFeatures::FromCppDefines());
+    x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+
+    // Check that graph coloring satisfies a fixed input register.
+    ret->GetLocations()->inputs_[0] = Location::RegisterLocation(2);
+
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+
+    ASSERT_TRUE(register_allocator->Validate(false));
+    ASSERT_EQ(field->GetLiveInterval()->GetRegister(), 2);
+  }
 }
 
 static HGraph* BuildTwoSubs(ArenaAllocator* allocator,
@@ -726,7 +825,7 @@ TEST_F(RegisterAllocatorTest, SameAsFirstInputHint) {
     SsaLivenessAnalysis liveness(graph, &codegen);
     liveness.Analyze();
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     // Sanity check that in normal conditions, the registers are the same.
@@ -748,12 +847,35 @@ TEST_F(RegisterAllocatorTest, SameAsFirstInputHint) {
     ASSERT_EQ(first_sub->GetLocations()->Out().GetPolicy(), Location::kSameAsFirstInput);
     ASSERT_EQ(second_sub->GetLocations()->Out().GetPolicy(), Location::kSameAsFirstInput);
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(first_sub->GetLiveInterval()->GetRegister(), 2);
     ASSERT_EQ(second_sub->GetLiveInterval()->GetRegister(), 2);
   }
+
+  {
+    HGraph* graph = BuildTwoSubs(&allocator, &first_sub, &second_sub);
+    std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+        X86_64InstructionSetFeatures::FromCppDefines());
+    x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+
+    // Check that graph coloring handles two-address instructions whose first
+    // input lives in a fixed register.
+    first_sub->InputAt(0)->GetLocations()->output_ = Location::RegisterLocation(2);
+    ASSERT_EQ(first_sub->GetLocations()->Out().GetPolicy(), Location::kSameAsFirstInput);
+    ASSERT_EQ(second_sub->GetLocations()->Out().GetPolicy(), Location::kSameAsFirstInput);
+
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+
+    ASSERT_TRUE(register_allocator->Validate(false));
+    ASSERT_TRUE(first_sub->GetLiveInterval()->HasRegister());
+    ASSERT_TRUE(second_sub->GetLiveInterval()->HasRegister());
+  }
 }
 
 static HGraph* BuildDiv(ArenaAllocator* allocator,
@@ -795,12 +917,139 @@ TEST_F(RegisterAllocatorTest, ExpectedExactInRegisterAndSameOutputHint) {
     SsaLivenessAnalysis liveness(graph, &codegen);
     liveness.Analyze();
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     // div on x86 requires its first input in eax and the output be the same as the first input.
     ASSERT_EQ(div->GetLiveInterval()->GetRegister(), 0);
   }
+
+  {
+    HGraph* graph = BuildDiv(&allocator, &div);
+    std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+        X86_64InstructionSetFeatures::FromCppDefines());
+    x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+
+    // div on x86_64 has the same constraints, with rax.
+    ASSERT_TRUE(register_allocator->Validate(false));
+    ASSERT_EQ(div->GetLiveInterval()->GetRegister(), 0);
+  }
+}
+
+static HGraph* BuildManyLiveValues(ArenaAllocator* allocator,
+                                   size_t number_of_values) {
+  HGraph* graph = CreateGraph(allocator);
+  ScopedNullHandle<mirror::DexCache> dex_cache;
+  HBasicBlock* entry = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (allocator) HParameterValue(
+      graph->GetDexFile(), 0, 0, Primitive::kPrimNot);
+  entry->AddInstruction(parameter);
+
+  HBasicBlock* block = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(block);
+  entry->AddSuccessor(block);
+
+  // Load all values first, and only then sum them, so that they are all live at the same time.
+  ArenaVector<HInstruction*> values(allocator->Adapter());
+  for (size_t i = 0; i < number_of_values; ++i) {
+    HInstruction* value = new (allocator) HInstanceFieldGet(parameter,
+                                                            Primitive::kPrimInt,
+                                                            MemberOffset(8 + 4 * i),
+                                                            false,
+                                                            kUnknownFieldIndex,
+                                                            kUnknownClassDefIndex,
+                                                            graph->GetDexFile(),
+                                                            dex_cache,
+                                                            0);
+    block->AddInstruction(value);
+    values.push_back(value);
+  }
+  HInstruction* sum = values.back();
+  for (size_t i = number_of_values - 1; i > 0; --i) {
+    sum = new (allocator) HAdd(Primitive::kPrimInt, values[i - 1], sum);
+    block->AddInstruction(sum);
+  }
+  block->AddInstruction(new (allocator) HReturn(sum));
+
+  HBasicBlock* exit = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(exit);
+  block->AddSuccessor(exit);
+  exit->AddInstruction(new (allocator) HExit());
+
+  graph->BuildDominatorTree();
+  return graph;
+}
+
+// Test that values are spilled when more of them are live than there are registers.
+TEST_F(RegisterAllocatorTest, SpillManyLiveValues) {
+  static constexpr size_t kNumberOfValues = 24;
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+
+  {
+    HGraph* graph = BuildManyLiveValues(&allocator, kNumberOfValues);
+    std::unique_ptr<const X86InstructionSetFeatures> features_x86(
+        X86InstructionSetFeatures::FromCppDefines());
+    x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
+    register_allocator.AllocateRegisters();
+    ASSERT_TRUE(register_allocator.Validate(false));
+    ASSERT_NE(register_allocator.GetNumberOfSpillSlots(), 0u);
+  }
+
+  {
+    HGraph* graph = BuildManyLiveValues(&allocator, kNumberOfValues);
+    std::unique_ptr<const X86_64InstructionSetFeatures> features_x86_64(
+        X86_64InstructionSetFeatures::FromCppDefines());
+    x86_64::CodeGeneratorX86_64 codegen(graph, *features_x86_64.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+    ASSERT_TRUE(register_allocator->Validate(false));
+    ASSERT_NE(register_allocator->GetNumberOfSpillSlots(), 0u);
+  }
+}
+
+TEST_F(RegisterAllocatorTest, SwapPhis) {
+  /*
+   * Test the following snippet:
+   *  int a = 0;
+   *  int b = 1;
+   *  while (a != 5) {
+   *    int c = a;
+   *    a = b;
+   *    b = c;
+   *  }
+   *  return b;
+   *
+   * The back edge exchanges the values of the two loop phis, which
+   * requires a parallel move with a cycle when they are in registers.
+   */
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::CONST_4 | 1 << 12 | 1 << 8,
+    Instruction::CONST_4 | 5 << 12 | 2 << 8,
+    Instruction::IF_EQ | 0 << 8 | 2 << 12, 6,
+    Instruction::MOVE | 3 << 8 | 0 << 12,
+    Instruction::MOVE | 0 << 8 | 1 << 12,
+    Instruction::MOVE | 1 << 8 | 3 << 12,
+    Instruction::GOTO | 0xFB00,
+    Instruction::RETURN | 1 << 8);
+
+  ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(CheckGraphColor(data));
 }
 
 // Test a bug in the register allocator, where allocating a blocked
@@ -892,7 +1141,7 @@ TEST_F(RegisterAllocatorTest, SpillInactive) {
     liveness.instructions_from_lifetime_position_.push_back(user);
   }
 
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+  RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
   register_allocator.unhandled_core_intervals_.push_back(fourth);
   register_allocator.unhandled_core_intervals_.push_back(third);
   register_allocator.unhandled_core_intervals_.push_back(second);
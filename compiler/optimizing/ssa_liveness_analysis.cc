@@ -522,8 +522,14 @@ bool LiveInterval::SameRegisterKind(Location other) const {
   }
 }
 
-bool LiveInterval::NeedsTwoSpillSlots() const {
-  return type_ == Primitive::kPrimLong || type_ == Primitive::kPrimDouble;
+size_t LiveInterval::NumberOfSpillSlotsNeeded() const {
+  HInstruction* defined_by = GetParent()->GetDefinedBy();
+  if (defined_by != nullptr &&
+      defined_by->IsVecOperation() &&
+      defined_by->AsVecOperation()->ReturnsSIMDValue()) {
+    return defined_by->AsVecOperation()->GetVectorNumberOfBytes() / kVRegSize;
+  }
+  return (type_ == Primitive::kPrimLong || type_ == Primitive::kPrimDouble) ? 2 : 1;
 }
 
 Location LiveInterval::ToLocation() const {
@@ -547,17 +553,24 @@ Location LiveInterval::ToLocation() const {
     if (defined_by->IsConstant()) {
       return defined_by->GetLocations()->Out();
     } else if (GetParent()->HasSpillSlot()) {
-      if (NeedsTwoSpillSlots()) {
-        return Location::DoubleStackSlot(GetParent()->GetSpillSlot());
-      } else {
-        return Location::StackSlot(GetParent()->GetSpillSlot());
-      }
+      return ToSpillLocation();
     } else {
       return Location();
     }
   }
 }
 
+Location LiveInterval::ToSpillLocation() const {
+  DCHECK(GetParent()->HasSpillSlot());
+  size_t slot = GetParent()->GetSpillSlot();
+  switch (NumberOfSpillSlotsNeeded()) {
+    case 1: return Location::StackSlot(slot);
+    case 2: return Location::DoubleStackSlot(slot);
+    case 4: return Location::SIMDStackSlot(slot);
+    default: LOG(FATAL) << "Unexpected number of spill slots"; UNREACHABLE();
+  }
+}
+
 Location LiveInterval::GetLocationAt(size_t position) {
   LiveInterval* sibling = GetSiblingAt(position);
   DCHECK(sibling != nullptr);
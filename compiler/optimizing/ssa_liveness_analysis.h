@@ -712,9 +712,9 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
   // Returns kNoRegister otherwise.
   int FindHintAtDefinition() const;
 
-  // Returns whether the interval needs two (Dex virtual register size `kVRegSize`)
-  // slots for spilling.
-  bool NeedsTwoSpillSlots() const;
+  // Returns the number of (Dex virtual register size `kVRegSize`) slots needed
+  // for spilling the interval. SIMD values need more than two slots.
+  size_t NumberOfSpillSlotsNeeded() const;
 
   bool IsFloatingPoint() const {
     return type_ == Primitive::kPrimFloat || type_ == Primitive::kPrimDouble;
@@ -723,6 +723,9 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
   // Converts the location of the interval to a `Location` object.
   Location ToLocation() const;
 
+  // Converts the spill slot of the interval's parent to a `Location` object.
+  Location ToSpillLocation() const;
+
   // Returns the location of the interval following its siblings at `position`.
   Location GetLocationAt(size_t position);
 
@@ -1202,6 +1202,15 @@ void X86Assembler::addl(const Address& address, const Immediate& imm) {
 }
 
 
+void X86Assembler::addw(const Address& address, const Immediate& imm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // Only the sign-extended 8-bit immediate form is encoded with a 16-bit operand size.
+  CHECK(imm.is_int8());
+  EmitUint8(0x66);
+  EmitComplex(0, address, imm);
+}
+
+
 void X86Assembler::adcl(Register reg, const Immediate& imm) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitComplex(2, Operand(reg), imm);
@@ -250,6 +250,14 @@ TEST_F(AssemblerX86Test, BsflAddress) {
   DriverStr(expected, "bsfl_address");
 }
 
+TEST_F(AssemblerX86Test, AddwAddress) {
+  GetAssembler()->addw(x86::Address(x86::Register(x86::EDI), 18), x86::Immediate(1));
+  const char* expected =
+    "addw $1, 0x12(%EDI)\n";
+
+  DriverStr(expected, "addw_address");
+}
+
 TEST_F(AssemblerX86Test, Bsrl) {
   DriverStr(RepeatRR(&x86::X86Assembler::bsrl, "bsrl %{reg2}, %{reg1}"), "bsrl");
 }
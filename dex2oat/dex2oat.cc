@@ -226,8 +226,9 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --image=<file.art>: specifies an output image filename.");
   UsageError("      Example: --image=/system/framework/boot.art");
   UsageError("");
-  UsageError("  --image-format=(uncompressed|lz4|lz4hc):");
-  UsageError("      Which format to store the image.");
+  UsageError("  --image-format=(uncompressed|lz4|lz4hc|lz4blocks):");
+  UsageError("      Which format to store the image. lz4blocks compresses the image in blocks");
+  UsageError("      that the runtime can decompress in parallel.");
   UsageError("      Example: --image-format=lz4");
   UsageError("      Default: uncompressed");
   UsageError("");
@@ -324,6 +325,13 @@ NO_RETURN static void Usage(const char* fmt, ...) {
              CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("      Default: %d", CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("");
+  UsageError("  --register-allocation-strategy=(linear-scan|graph-color): the register");
+  UsageError("      allocator used by Optimizing. graph-color is only supported on 64-bit");
+  UsageError("      targets, other targets use linear-scan. Intended for development/experimental");
+  UsageError("      use.");
+  UsageError("      Example: --register-allocation-strategy=graph-color");
+  UsageError("      Default: linear-scan");
+  UsageError("");
   UsageError("  --dump-timing: display a breakdown of where time was spent");
   UsageError("");
   UsageError("  --include-patch-information: Include patching information so the generated code");
@@ -683,6 +691,8 @@ class Dex2Oat FINAL {
       image_storage_mode_ = ImageHeader::kStorageModeLZ4;
     } else if (format_str == "lz4hc") {
       image_storage_mode_ = ImageHeader::kStorageModeLZ4HC;
+    } else if (format_str == "lz4blocks") {
+      image_storage_mode_ = ImageHeader::kStorageModeLZ4Blocks;
     } else if (format_str == "uncompressed") {
       image_storage_mode_ = ImageHeader::kStorageModeUncompressed;
     } else {
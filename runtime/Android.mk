@@ -187,6 +187,7 @@ LIBART_COMMON_SRC_FILES := \
   type_lookup_table.cc \
   utf.cc \
   utils.cc \
+  verifier/background_verifier.cc \
   verifier/instruction_flags.cc \
   verifier/method_verifier.cc \
   verifier/reg_type.cc \
@@ -221,6 +222,7 @@ LIBART_COMMON_SRC_FILES += \
   entrypoints/quick/quick_field_entrypoints.cc \
   entrypoints/quick/quick_fillarray_entrypoints.cc \
   entrypoints/quick/quick_instrumentation_entrypoints.cc \
+  entrypoints/quick/quick_jit_entrypoints.cc \
   entrypoints/quick/quick_jni_entrypoints.cc \
   entrypoints/quick/quick_lock_entrypoints.cc \
   entrypoints/quick/quick_math_entrypoints.cc \
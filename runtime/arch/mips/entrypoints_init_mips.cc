@@ -289,6 +289,10 @@ void InitEntryPoints(JniEntryPoints* jpoints, QuickEntryPoints* qpoints) {
   qpoints->pReadBarrierForRootSlow = artReadBarrierForRootSlow;
   static_assert(IsDirectEntrypoint(kQuickReadBarrierForRootSlow),
                 "Direct C stub not marked direct.");
+
+  // JIT
+  qpoints->pCompileOptimized = artCompileOptimized;
+  static_assert(IsDirectEntrypoint(kQuickCompileOptimized), "Direct C stub not marked direct.");
 };
 
 }  // namespace art
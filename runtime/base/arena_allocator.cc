@@ -50,6 +50,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "Instruction  ",
   "InvokeInputs ",
   "PhiInputs    ",
+  "VectorNode   ",
   "LoopInfo     ",
   "LIBackEdges  ",
   "TryCatchInf  ",
@@ -69,6 +70,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "DCE          ",
   "LSE          ",
   "LICM         ",
+  "LoopOpt      ",
   "SsaLiveness  ",
   "SsaPhiElim   ",
   "RefTypeProp  ",
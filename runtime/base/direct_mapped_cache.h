@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BASE_DIRECT_MAPPED_CACHE_H_
+#define ART_RUNTIME_BASE_DIRECT_MAPPED_CACHE_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art {
+
+// A fixed size cache where each hash maps to exactly one entry, selected by its low bits. Filling
+// an entry evicts whatever key it held before, so the Entry type stores its key and the caller
+// checks it on lookup. A value-initialized Entry is an empty entry.
+//
+// There is no synchronization, the cache is meant to be owned by a single thread.
+template <typename Entry, size_t kSize>
+class DirectMappedCache {
+ public:
+  static_assert(IsPowerOfTwo(kSize), "Cache size must be a power of two");
+
+  DirectMappedCache() {
+    Clear();
+  }
+
+  Entry& GetEntry(size_t hash) {
+    return entries_[hash & (kSize - 1)];
+  }
+
+  const Entry& GetEntry(size_t hash) const {
+    return entries_[hash & (kSize - 1)];
+  }
+
+  void Clear() {
+    std::fill_n(entries_, kSize, Entry());
+  }
+
+ private:
+  Entry entries_[kSize];
+
+  DISALLOW_COPY_AND_ASSIGN(DirectMappedCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BASE_DIRECT_MAPPED_CACHE_H_
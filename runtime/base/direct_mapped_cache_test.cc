@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "direct_mapped_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+struct TestEntry {
+  size_t key;
+  int value;
+};
+
+using TestCache = DirectMappedCache<TestEntry, 16>;
+
+static bool Lookup(const TestCache& cache, size_t key, int* value) {
+  const TestEntry& entry = cache.GetEntry(key);
+  if (entry.value == 0 || entry.key != key) {
+    return false;
+  }
+  *value = entry.value;
+  return true;
+}
+
+static void Insert(TestCache* cache, size_t key, int value) {
+  TestEntry& entry = cache->GetEntry(key);
+  entry.key = key;
+  entry.value = value;
+}
+
+TEST(DirectMappedCache, InsertLookupClear) {
+  TestCache cache;
+  int value = 0;
+  // A new cache is empty.
+  for (size_t key = 0; key != 16u; ++key) {
+    EXPECT_FALSE(Lookup(cache, key, &value));
+  }
+
+  Insert(&cache, 3u, 42);
+  Insert(&cache, 4u, 43);
+  ASSERT_TRUE(Lookup(cache, 3u, &value));
+  EXPECT_EQ(42, value);
+  ASSERT_TRUE(Lookup(cache, 4u, &value));
+  EXPECT_EQ(43, value);
+  EXPECT_FALSE(Lookup(cache, 5u, &value));
+
+  cache.Clear();
+  EXPECT_FALSE(Lookup(cache, 3u, &value));
+  EXPECT_FALSE(Lookup(cache, 4u, &value));
+}
+
+TEST(DirectMappedCache, Conflict) {
+  TestCache cache;
+  int value = 0;
+  // Keys which differ only above the index bits share an entry, the last one inserted wins.
+  Insert(&cache, 3u, 42);
+  Insert(&cache, 3u + 16u, 43);
+  EXPECT_FALSE(Lookup(cache, 3u, &value));
+  ASSERT_TRUE(Lookup(cache, 3u + 16u, &value));
+  EXPECT_EQ(43, value);
+  // Other entries are not affected.
+  Insert(&cache, 4u, 44);
+  ASSERT_TRUE(Lookup(cache, 3u + 16u, &value));
+  EXPECT_EQ(43, value);
+}
+
+}  // namespace art
@@ -91,6 +91,7 @@
 #include "trace.h"
 #include "utils.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
+#include "verifier/background_verifier.h"
 #include "verifier/method_verifier.h"
 #include "well_known_classes.h"
 
@@ -2583,6 +2584,14 @@ mirror::Class* ClassLinker::DefineClass(Thread* self,
   // Notify native debugger of the new class and its layout.
   jit::Jit::NewTypeLoadedIfUsingJit(h_new_class.Get());
 
+  // Verify the class ahead of its first use if it was not verified at compile time.
+  verifier::BackgroundVerifier* background_verifier = Runtime::Current()->GetBackgroundVerifier();
+  if (background_verifier != nullptr &&
+      class_loader.Get() != nullptr &&
+      verifier::BackgroundVerifier::NeedsVerification(dex_file)) {
+    background_verifier->VerifyClass(self, h_new_class.Get());
+  }
+
   return h_new_class.Get();
 }
 
@@ -3622,11 +3631,24 @@ mirror::Class* ClassLinker::LookupClass(Thread* self,
                                         size_t hash,
                                         mirror::ClassLoader* class_loader) {
   {
+    // Check the classes recently found by this thread first, which does not need any lock. The
+    // class table of a class loader is only ever set once, and is kept alive by the loader.
+    ClassLookupCache* const cache = self->GetClassLookupCache();
+    ClassTable* class_table = ClassTableForClassLoader(class_loader);
+    if (class_table != nullptr) {
+      mirror::Class* cached = cache->Get(class_table, hash, class_table->GetUpdateCount());
+      if (cached != nullptr && cached->DescriptorEquals(descriptor)) {
+        return cached;
+      }
+    }
     ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
-    ClassTable* const class_table = ClassTableForClassLoader(class_loader);
+    class_table = ClassTableForClassLoader(class_loader);
     if (class_table != nullptr) {
+      // Read the count before the lookup, so that a concurrent update invalidates the entry.
+      const uint32_t update_count = class_table->GetUpdateCount();
       mirror::Class* result = class_table->Lookup(descriptor, hash);
       if (result != nullptr) {
+        cache->Set(class_table, hash, update_count, result);
         return result;
       }
     }
@@ -3933,6 +3955,12 @@ void ClassLinker::VerifyClass(Thread* self, Handle<mirror::Class> klass, LogSeve
   const DexFile& dex_file = *klass->GetDexCache()->GetDexFile();
   mirror::Class::Status oat_file_class_status(mirror::Class::kStatusNotReady);
   bool preverified = VerifyClassUsingOatFile(dex_file, klass.Get(), oat_file_class_status);
+  if (!preverified && oat_file_class_status != mirror::Class::kStatusError) {
+    // The background verifier may have verified the class since it was defined.
+    verifier::BackgroundVerifier* background_verifier = Runtime::Current()->GetBackgroundVerifier();
+    preverified = background_verifier != nullptr &&
+        background_verifier->TakeVerifiedClass(self, klass.Get());
+  }
   // If the oat file says the class had an error, re-run the verifier. That way we will get a
   // precise error message. To ensure a rerun, test:
   //     oat_file_class_status == mirror::Class::kStatusError => !preverified
@@ -3945,6 +3973,7 @@ void ClassLinker::VerifyClass(Thread* self, Handle<mirror::Class> klass, LogSeve
     verifier_failure = verifier::MethodVerifier::VerifyClass(self,
                                                              klass.Get(),
                                                              runtime->GetCompilerCallbacks(),
+                                                             true /* can_load_classes */,
                                                              runtime->IsAotCompiler(),
                                                              log_level,
                                                              &error_msg);
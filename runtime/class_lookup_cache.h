@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CLASS_LOOKUP_CACHE_H_
+#define ART_RUNTIME_CLASS_LOOKUP_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/direct_mapped_cache.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ClassTable;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// Classes recently found by ClassLinker::LookupClass on one thread, so that repeated lookups of
+// the same descriptors do not take the class table locks. Entries are keyed by the class table
+// and the descriptor hash, and record the update count of the class table when they were
+// filled: an entry is stale once a class of its table has been replaced or removed.
+//
+// Holding a class here does not keep it alive, so Thread::VisitRoots empties the cache before
+// the GC can move or unload the class.
+class ClassLookupCache {
+ public:
+  ClassLookupCache() {}
+
+  // Return the cached class for the descriptor with the given hash, or null if not cached.
+  // The caller checks the descriptor, as different descriptors may share a hash.
+  mirror::Class* Get(const ClassTable* table, size_t hash, uint32_t update_count) const {
+    const Entry& entry = cache_.GetEntry(hash);
+    if (entry.table == table && entry.hash == hash && entry.update_count == update_count) {
+      return entry.klass;
+    }
+    return nullptr;
+  }
+
+  void Set(const ClassTable* table, size_t hash, uint32_t update_count, mirror::Class* klass) {
+    Entry& entry = cache_.GetEntry(hash);
+    entry.table = table;
+    entry.klass = klass;
+    entry.hash = hash;
+    entry.update_count = update_count;
+  }
+
+  void Clear() {
+    cache_.Clear();
+  }
+
+  static constexpr size_t kSize = 64;
+
+ private:
+  struct Entry {
+    const ClassTable* table;
+    mirror::Class* klass;
+    size_t hash;
+    uint32_t update_count;
+  };
+
+  DirectMappedCache<Entry, kSize> cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClassLookupCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CLASS_LOOKUP_CACHE_H_
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_lookup_cache.h"
+
+#include "class_linker.h"
+#include "class_table.h"
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "scoped_thread_state_change.h"
+#include "thread-inl.h"
+#include "utf.h"
+
+namespace art {
+
+class ClassLookupCacheTest : public CommonRuntimeTest {
+ protected:
+  class NoopRootVisitor : public SingleRootVisitor {
+   public:
+    void VisitRoot(mirror::Object* root ATTRIBUTE_UNUSED,
+                   const RootInfo& info ATTRIBUTE_UNUSED) OVERRIDE {}
+  };
+};
+
+TEST_F(ClassLookupCacheTest, StaleAfterClassTableUpdate) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader*>(LoadDex("MyClass"))));
+  const char* const descriptor = "LMyClass;";
+  Handle<mirror::Class> klass(hs.NewHandle(class_linker_->FindClass(self, descriptor,
+                                                                    class_loader)));
+  ASSERT_TRUE(klass.Get() != nullptr);
+  const size_t hash = ComputeModifiedUtf8Hash(descriptor);
+  ClassTable* const table = class_loader->GetClassTable();
+  ASSERT_TRUE(table != nullptr);
+  ClassLookupCache* const cache = self->GetClassLookupCache();
+
+  // A lookup fills the cache for the current state of the class table.
+  EXPECT_EQ(klass.Get(), class_linker_->LookupClass(self, descriptor, hash, class_loader.Get()));
+  EXPECT_EQ(klass.Get(), cache->Get(table, hash, table->GetUpdateCount()));
+
+  // Removing the class updates the table, after which the cached class must not be returned.
+  const uint32_t update_count = table->GetUpdateCount();
+  ASSERT_TRUE(class_linker_->RemoveClass(descriptor, class_loader.Get()));
+  EXPECT_NE(update_count, table->GetUpdateCount());
+  EXPECT_TRUE(cache->Get(table, hash, table->GetUpdateCount()) == nullptr);
+  EXPECT_TRUE(class_linker_->LookupClass(self, descriptor, hash, class_loader.Get()) == nullptr);
+
+  // Once the class is back in the table, lookups find and cache it again.
+  EXPECT_TRUE(class_linker_->InsertClass(descriptor, klass.Get(), hash) == nullptr);
+  EXPECT_EQ(klass.Get(), class_linker_->LookupClass(self, descriptor, hash, class_loader.Get()));
+  EXPECT_EQ(klass.Get(), cache->Get(table, hash, table->GetUpdateCount()));
+}
+
+TEST_F(ClassLookupCacheTest, ClearedWhenThreadRootsAreVisited) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader*>(LoadDex("MyClass"))));
+  const char* const descriptor = "LMyClass;";
+  Handle<mirror::Class> klass(hs.NewHandle(class_linker_->FindClass(self, descriptor,
+                                                                    class_loader)));
+  ASSERT_TRUE(klass.Get() != nullptr);
+  const size_t hash = ComputeModifiedUtf8Hash(descriptor);
+  ClassTable* const table = class_loader->GetClassTable();
+  ClassLookupCache* const cache = self->GetClassLookupCache();
+
+  EXPECT_EQ(klass.Get(), class_linker_->LookupClass(self, descriptor, hash, class_loader.Get()));
+  ASSERT_EQ(klass.Get(), cache->Get(table, hash, table->GetUpdateCount()));
+
+  // The cached class is not a root, so it must be gone once the GC visited the thread.
+  NoopRootVisitor visitor;
+  self->VisitRoots(&visitor);
+  EXPECT_TRUE(cache->Get(table, hash, table->GetUpdateCount()) == nullptr);
+  // The next lookup goes to the class table.
+  EXPECT_EQ(klass.Get(), class_linker_->LookupClass(self, descriptor, hash, class_loader.Get()));
+}
+
+}  // namespace art
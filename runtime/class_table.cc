@@ -20,7 +20,9 @@
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      update_count_(0u) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
@@ -74,6 +76,7 @@ mirror::Class* ClassTable::UpdateClass(const char* descriptor, mirror::Class* kl
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
   // doesn't change.
   *existing_it = GcRoot<mirror::Class>(klass);
+  update_count_.FetchAndAddSequentiallyConsistent(1u);
   return existing;
 }
 
@@ -122,6 +125,7 @@ bool ClassTable::Remove(const char* descriptor) {
     auto it = class_set.Find(descriptor);
     if (it != class_set.end()) {
       class_set.Erase(it);
+      update_count_.FetchAndAddSequentiallyConsistent(1u);
       return true;
     }
   }
@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "atomic.h"
 #include "base/allocator.h"
 #include "base/hash_set.h"
 #include "base/macros.h"
@@ -115,6 +116,12 @@ class ClassTable {
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Return the number of times a class of the table was replaced or removed. Classes cached
+  // from a lookup remain valid as long as the count does not change.
+  uint32_t GetUpdateCount() const {
+    return update_count_.LoadSequentiallyConsistent();
+  }
+
   // Return the first class that matches the descriptor of klass. Returns null if there are none.
   mirror::Class* LookupByDescriptor(mirror::Class* klass)
       REQUIRES(!lock_)
@@ -173,6 +180,8 @@ class ClassTable {
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
   std::vector<GcRoot<mirror::Object>> strong_roots_ GUARDED_BY(lock_);
+  // Number of classes replaced or removed, see GetUpdateCount().
+  Atomic<uint32_t> update_count_;
 
   friend class ImageWriter;  // for InsertWithoutLocks.
 };
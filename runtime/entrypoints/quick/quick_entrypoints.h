@@ -97,6 +97,11 @@ extern "C" mirror::Object* artReadBarrierSlow(mirror::Object* ref,
 extern "C" mirror::Object* artReadBarrierForRootSlow(GcRoot<mirror::Object>* root)
     SHARED_REQUIRES(Locks::mutator_lock_) HOT_ATTR;
 
+// Called by JIT baseline code once its invocation counter overflows, to request an
+// optimized compilation of `method`. Must not suspend the calling thread.
+extern "C" void artCompileOptimized(ArtMethod* method)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_ENTRYPOINTS_H_
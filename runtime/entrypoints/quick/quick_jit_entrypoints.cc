@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "art_method.h"
+#include "entrypoints/quick/quick_entrypoints.h"
+#include "jit/jit.h"
+#include "runtime.h"
+#include "thread-inl.h"
+
+namespace art {
+
+extern "C" void artCompileOptimized(ArtMethod* method) SHARED_REQUIRES(Locks::mutator_lock_) {
+  // This entrypoint is called directly from compiled code, without setting up a managed
+  // frame, so we must not suspend.
+  Thread* self = Thread::Current();
+  ScopedAssertNoThreadSuspension ants(self, __FUNCTION__);
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr) {
+    jit->EnqueueOptimizedCompilation(method, self);
+  }
+}
+
+}  // namespace art
@@ -16,9 +16,14 @@
 
 #include "allocation_record.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "art_method-inl.h"
 #include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "stack.h"
+#include "utils.h"
 
 #ifdef __ANDROID__
 #include "cutils/properties.h"
@@ -88,6 +93,20 @@ void AllocRecordObjectMap::SetProperties() {
       max_stack_depth_ = value;
     }
   }
+  // Check whether there's a system property asking to only sample allocations, recording one
+  // allocation per given number of bytes on average.
+  propertyName = "dalvik.vm.allocTrackerSampleBytes";
+  char sampleBytesString[PROPERTY_VALUE_MAX];
+  if (property_get(propertyName, sampleBytesString, "") > 0) {
+    char* end;
+    size_t value = strtoul(sampleBytesString, &end, 10);
+    if (*end != '\0') {
+      LOG(ERROR) << "Ignoring  " << propertyName << " '" << sampleBytesString
+                 << "' --- invalid";
+    } else {
+      sample_interval_bytes_ = value;
+    }
+  }
 #endif
 }
 
@@ -115,6 +134,14 @@ void AllocRecordObjectMap::VisitRoots(RootVisitor* visitor) {
       element.GetMethod()->VisitRoots(buffered_visitor, sizeof(void*));
     }
   }
+  // Likewise for the stack traces of the sampled allocation sites.
+  for (const AllocSiteStats& site : alloc_sites_) {
+    for (size_t i = 0, depth = site.trace->GetDepth(); i < depth; ++i) {
+      const AllocRecordStackTraceElement& element = site.trace->GetStackElement(i);
+      DCHECK(element.GetMethod() != nullptr);
+      element.GetMethod()->VisitRoots(buffered_visitor, sizeof(void*));
+    }
+  }
 }
 
 static inline void SweepClassObject(AllocRecord* record, IsMarkedVisitor* visitor)
@@ -237,6 +264,11 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       LOG(INFO) << "Enabling alloc tracker (" << records->alloc_record_max_ << " entries of "
                 << records->max_stack_depth_ << " frames, taking up to "
                 << PrettySize(sz * records->alloc_record_max_) << ")";
+      if (records->sample_interval_bytes_ != 0) {
+        LOG(INFO) << "Sampling one allocation per "
+                  << PrettySize(records->sample_interval_bytes_) << " on average, in up to "
+                  << records->alloc_site_max_ << " allocation sites";
+      }
     }
     Runtime::Current()->GetInstrumentation()->InstrumentQuickAllocEntryPoints();
     {
@@ -264,6 +296,9 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
 void AllocRecordObjectMap::RecordAllocation(Thread* self,
                                             mirror::Object** obj,
                                             size_t byte_count) {
+  if (!ShouldSampleAllocation(self, byte_count)) {
+    return;
+  }
   // Get stack trace outside of lock in case there are allocations during the stack walk.
   // b/27858645.
   AllocRecordStackTrace trace;
@@ -303,6 +338,10 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
   // Erase extra unfilled elements.
   trace.SetTid(self->GetTid());
 
+  if (sample_interval_bytes_ != 0) {
+    RecordAllocationSite(trace, byte_count);
+  }
+
   // Add the record.
   Put(*obj, AllocRecord(byte_count, (*obj)->GetClass(), std::move(trace)));
   DCHECK_LE(Size(), alloc_record_max_);
@@ -310,6 +349,112 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
 
 void AllocRecordObjectMap::Clear() {
   entries_.clear();
+  alloc_sites_.clear();
+  alloc_site_indices_.clear();
+  dropped_site_samples_ = 0;
+}
+
+bool AllocRecordObjectMap::ShouldSampleAllocation(Thread* self, size_t byte_count) {
+  if (sample_interval_bytes_ == 0) {
+    return true;
+  }
+  int64_t bytes_left = self->GetAllocRecordSampleBytesLeft();
+  if (bytes_left == 0) {
+    // First allocation of the thread since sampling was enabled.
+    bytes_left = NextSampleDistance(self);
+  }
+  bytes_left -= static_cast<int64_t>(byte_count);
+  if (bytes_left > 0) {
+    self->SetAllocRecordSampleBytesLeft(bytes_left);
+    return false;
+  }
+  self->SetAllocRecordSampleBytesLeft(NextSampleDistance(self));
+  return true;
+}
+
+int64_t AllocRecordObjectMap::NextSampleDistance(Thread* self) const {
+  // Mix the time and thread id into a uniform value in (0, 1]. This is only used to space the
+  // samples, so it does not need a stronger random number generator.
+  uint64_t bits = NanoTime() ^ (static_cast<uint64_t>(self->GetTid()) << 32);
+  bits += UINT64_C(0x9e3779b97f4a7c15);
+  bits = (bits ^ (bits >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  bits = (bits ^ (bits >> 27)) * UINT64_C(0x94d049bb133111eb);
+  bits ^= bits >> 31;
+  double uniform = (static_cast<double>(bits >> 11) + 1.0) / static_cast<double>(UINT64_C(1) << 53);
+  double distance = -std::log(uniform) * static_cast<double>(sample_interval_bytes_);
+  return std::max<int64_t>(static_cast<int64_t>(distance), 1);
+}
+
+void AllocRecordObjectMap::RecordAllocationSite(const AllocRecordStackTrace& trace,
+                                                size_t byte_count) {
+  // Sites are shared by all threads.
+  AllocRecordStackTrace site_trace(trace);
+  site_trace.SetTid(0);
+  auto it = alloc_site_indices_.find(site_trace);
+  if (it == alloc_site_indices_.end()) {
+    if (alloc_sites_.size() >= alloc_site_max_) {
+      ++dropped_site_samples_;
+      return;
+    }
+    it = alloc_site_indices_.emplace(std::move(site_trace), alloc_sites_.size()).first;
+    alloc_sites_.push_back(AllocSiteStats { &it->first, 0u, 0u, 0.0, 0.0 });
+  }
+  // An allocation of byte_count bytes is sampled with probability 1 - exp(-byte_count / interval),
+  // weight the sample by the inverse to estimate the unsampled allocations.
+  double probability =
+      1.0 - std::exp(-static_cast<double>(byte_count) / sample_interval_bytes_);
+  AllocSiteStats& site = alloc_sites_[it->second];
+  ++site.samples;
+  site.sampled_bytes += byte_count;
+  site.estimated_count += 1.0 / probability;
+  site.estimated_bytes += byte_count / probability;
+}
+
+void AllocRecordObjectMap::DumpAllocationSites(std::ostream& os, size_t max_sites) {
+  std::vector<AllocSiteStats> sites;
+  std::vector<AllocRecordStackTrace> traces;
+  size_t num_sites;
+  uint64_t dropped_samples;
+  {
+    MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+    if (sample_interval_bytes_ == 0) {
+      return;
+    }
+    num_sites = alloc_sites_.size();
+    dropped_samples = dropped_site_samples_;
+    sites = alloc_sites_;
+    max_sites = std::min(max_sites, num_sites);
+    std::partial_sort(sites.begin(),
+                      sites.begin() + max_sites,
+                      sites.end(),
+                      [](const AllocSiteStats& lhs, const AllocSiteStats& rhs) {
+                        return lhs.estimated_bytes > rhs.estimated_bytes;
+                      });
+    sites.resize(max_sites);
+    traces.reserve(max_sites);
+    for (const AllocSiteStats& site : sites) {
+      traces.push_back(*site.trace);
+    }
+  }
+
+  os << "Sampled allocation sites: " << num_sites << " sites, one sample per "
+     << PrettySize(sample_interval_bytes_) << " on average";
+  if (dropped_samples != 0) {
+    os << ", " << dropped_samples << " samples from untracked sites";
+  }
+  os << "\n";
+  for (size_t i = 0; i < max_sites; ++i) {
+    const AllocSiteStats& site = sites[i];
+    os << "  " << PrettySize(static_cast<size_t>(site.estimated_bytes)) << " in about "
+       << static_cast<uint64_t>(site.estimated_count) << " allocations (" << site.samples
+       << " samples of " << PrettySize(site.sampled_bytes) << ")\n";
+    const AllocRecordStackTrace& trace = traces[i];
+    for (size_t j = 0, depth = trace.GetDepth(); j < depth; ++j) {
+      const AllocRecordStackTraceElement& element = trace.GetStackElement(j);
+      os << "    at " << PrettyMethod(element.GetMethod()) << " line "
+         << element.ComputeLineNumber() << "\n";
+    }
+  }
 }
 
 AllocRecordObjectMap::AllocRecordObjectMap()
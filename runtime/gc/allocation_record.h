@@ -19,6 +19,9 @@
 
 #include <list>
 #include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
 
 #include "base/mutex.h"
 #include "object_callbacks.h"
@@ -290,21 +293,66 @@ class AllocRecordObjectMap {
 
   void Clear() REQUIRES(Locks::alloc_tracker_lock_);
 
+  // Return the mean number of bytes allocated between two recorded allocations, or 0 if every
+  // allocation is recorded.
+  size_t GetSampleIntervalBytes() const {
+    return sample_interval_bytes_;
+  }
+
+  // Statistics of the sampled allocations made from one allocation site.
+  struct AllocSiteStats {
+    const AllocRecordStackTrace* trace;
+    uint64_t samples;
+    uint64_t sampled_bytes;
+    // Estimates of the total number of allocations and bytes the samples stand for.
+    double estimated_count;
+    double estimated_bytes;
+  };
+
+  // Dump the allocation sites with the most estimated bytes. The sites are copied under the
+  // allocation tracker lock, so allocating threads are not blocked while they are printed.
+  void DumpAllocationSites(std::ostream& os, size_t max_sites)
+      REQUIRES(!Locks::alloc_tracker_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
  private:
   static constexpr size_t kDefaultNumAllocRecords = 512 * 1024;
   static constexpr size_t kDefaultNumRecentRecords = 64 * 1024 - 1;
   static constexpr size_t kDefaultAllocStackDepth = 16;
   static constexpr size_t kMaxSupportedStackDepth = 128;
+  // Record every allocation by default.
+  static constexpr size_t kDefaultSampleIntervalBytes = 0;
+  static constexpr size_t kDefaultNumAllocSites = 16 * 1024;
   size_t alloc_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumAllocRecords;
   size_t recent_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumRecentRecords;
   size_t max_stack_depth_ = kDefaultAllocStackDepth;
+  size_t sample_interval_bytes_ = kDefaultSampleIntervalBytes;
+  size_t alloc_site_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumAllocSites;
   pid_t alloc_ddm_thread_id_  GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
   bool allow_new_record_ GUARDED_BY(Locks::alloc_tracker_lock_) = true;
   ConditionVariable new_record_condition_ GUARDED_BY(Locks::alloc_tracker_lock_);
   // see the comment in typedef of EntryList
   EntryList entries_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // When sampling, the distinct stack traces of the sampled allocations, mapped to the index of
+  // their statistics in alloc_sites_. Samples from new sites are only counted in
+  // dropped_site_samples_ once alloc_site_max_ sites are known.
+  std::unordered_map<AllocRecordStackTrace, size_t, HashAllocRecordTypes> alloc_site_indices_
+      GUARDED_BY(Locks::alloc_tracker_lock_);
+  std::vector<AllocSiteStats> alloc_sites_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  uint64_t dropped_site_samples_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
 
   void SetProperties() REQUIRES(Locks::alloc_tracker_lock_);
+
+  // Return whether the allocation of `byte_count` bytes by `self` should be recorded, updating
+  // the number of bytes left before the next sample of the thread.
+  bool ShouldSampleAllocation(Thread* self, size_t byte_count);
+
+  // Return the number of bytes to allocate before the next sample, drawn from an exponential
+  // distribution so that samples form a Poisson process over the allocated bytes.
+  int64_t NextSampleDistance(Thread* self) const;
+
+  void RecordAllocationSite(const AllocRecordStackTrace& trace, size_t byte_count)
+      REQUIRES(Locks::alloc_tracker_lock_);
 };
 
 }  // namespace gc
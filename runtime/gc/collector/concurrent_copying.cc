@@ -19,6 +19,7 @@
 #include "art_field-inl.h"
 #include "base/stl_util.h"
 #include "debugger.h"
+#include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "gc/reference_processor.h"
@@ -31,6 +32,7 @@
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -38,8 +40,18 @@ namespace gc {
 namespace collector {
 
 static constexpr size_t kDefaultGcMarkStackSize = 2 * MB;
-
-ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix)
+// Used for the generational mode. A full collection happens after this many bytes have been
+// promoted to the old regions since the last full collection.
+static constexpr size_t kBytesPromotedThreshold = 32 * MB;
+// Used for the generational mode. A full collection happens after this many bytes of large objects
+// have been allocated since the last full collection, as young collections don't free them.
+static constexpr size_t kLargeObjectBytesAllocatedThreshold = 16 * MB;
+// Process the GC mark stack with the heap thread pool when it holds at least this many refs.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+static constexpr bool kParallelProcessMarkStack = true;
+
+ConcurrentCopying::ConcurrentCopying(Heap* heap, bool generational,
+                                     const std::string& name_prefix)
     : GarbageCollector(heap,
                        name_prefix + (name_prefix.empty() ? "" : " ") +
                        "concurrent copying + mark sweep"),
@@ -50,11 +62,19 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix)
       mark_stack_lock_("concurrent copying mark stack lock", kMarkSweepMarkStackLock),
       thread_running_gc_(nullptr),
       is_marking_(false), is_active_(false), is_asserting_to_space_invariant_(false),
-      heap_mark_bitmap_(nullptr), live_stack_freeze_size_(0), mark_stack_mode_(kMarkStackModeOff),
+      region_space_bitmap_(nullptr), heap_mark_bitmap_(nullptr), live_stack_freeze_size_(0),
+      mark_stack_mode_(kMarkStackModeOff),
       weak_ref_access_enabled_(true),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       rb_table_(heap_->GetReadBarrierTable()),
-      force_evacuate_all_(false) {
+      force_evacuate_all_(false),
+      generational_(generational),
+      // Start with a full collection, which sets up the region space bitmap for the following
+      // young collections.
+      young_gen_(false),
+      bytes_promoted_since_last_full_collection_(0),
+      large_object_bytes_allocated_at_last_full_collection_(0),
+      collector_name_(name_) {
   static_assert(space::RegionSpace::kRegionSize == accounting::ReadBarrierTable::kRegionSize,
                 "The region space size and the read barrier table region size must match");
   cc_heap_bitmap_.reset(new accounting::HeapBitmap(heap));
@@ -88,6 +108,8 @@ void ConcurrentCopying::MarkHeapReference(mirror::HeapReference<mirror::Object>*
 
 ConcurrentCopying::~ConcurrentCopying() {
   STLDeleteElements(&pooled_mark_stacks_);
+  // Persists across collections in the generational mode.
+  delete region_space_bitmap_;
 }
 
 void ConcurrentCopying::RunPhases() {
@@ -147,12 +169,22 @@ void ConcurrentCopying::BindBitmaps() {
       cc_heap_bitmap_->AddContinuousSpaceBitmap(bitmap);
       cc_bitmaps_.push_back(bitmap);
     } else if (space == region_space_) {
-      accounting::ContinuousSpaceBitmap* bitmap =
-          accounting::ContinuousSpaceBitmap::Create("cc region space bitmap",
-                                                    space->Begin(), space->Capacity());
-      cc_heap_bitmap_->AddContinuousSpaceBitmap(bitmap);
-      cc_bitmaps_.push_back(bitmap);
-      region_space_bitmap_ = bitmap;
+      if (region_space_bitmap_ == nullptr) {
+        accounting::ContinuousSpaceBitmap* bitmap =
+            accounting::ContinuousSpaceBitmap::Create("cc region space bitmap",
+                                                      space->Begin(), space->Capacity());
+        cc_heap_bitmap_->AddContinuousSpaceBitmap(bitmap);
+        if (!generational_) {
+          cc_bitmaps_.push_back(bitmap);
+        }
+        region_space_bitmap_ = bitmap;
+      } else if (!young_gen_ || region_space_->OldSpaceSize() == 0U) {
+        // In the generational mode, the bitmap persists across collections to record the objects
+        // in the old regions. A full collection marks it from scratch, and so does a young
+        // collection if the region space was cleared (e.g. by the zygote compaction).
+        DCHECK(generational_);
+        region_space_bitmap_->Clear();
+      }
     }
   }
 }
@@ -175,9 +207,23 @@ void ConcurrentCopying::InitializePhase() {
   } else {
     force_evacuate_all_ = false;
   }
+  if (generational_) {
+    if (force_evacuate_all_) {
+      // If an explicit, native allocation-triggered, or last attempt
+      // collection, collect the whole heap.
+      young_gen_ = false;
+    }
+    if (young_gen_) {
+      VLOG(heap) << "Young generation collection";
+      name_ = collector_name_ + " young";
+    } else {
+      VLOG(heap) << "Full heap collection";
+      name_ = collector_name_ + " full";
+    }
+  }
   BindBitmaps();
   if (kVerboseMode) {
-    LOG(INFO) << "force_evacuate_all=" << force_evacuate_all_;
+    LOG(INFO) << "force_evacuate_all=" << force_evacuate_all_ << " young_gen=" << young_gen_;
     LOG(INFO) << "Largest immune region: " << immune_spaces_.GetLargestImmuneRegion().Begin()
               << "-" << immune_spaces_.GetLargestImmuneRegion().End();
     for (space::ContinuousSpace* space : immune_spaces_.GetSpaces()) {
@@ -238,15 +284,26 @@ class ConcurrentCopying::FlipCallback : public Closure {
     Thread* self = Thread::Current();
     CHECK(thread == self);
     Locks::mutator_lock_->AssertExclusiveHeld(self);
-    cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_);
+    cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_, cc->young_gen_);
     cc->SwapStacks();
     if (ConcurrentCopying::kEnableFromSpaceAccountingCheck) {
       cc->RecordLiveStackFreezeSize(self);
-      cc->from_space_num_objects_at_first_pause_ = cc->region_space_->GetObjectsAllocated();
-      cc->from_space_num_bytes_at_first_pause_ = cc->region_space_->GetBytesAllocated();
+      // Exclude the old regions that a young collection leaves in the to-space.
+      cc->from_space_num_objects_at_first_pause_ =
+          cc->region_space_->GetObjectsAllocatedInFromSpace() +
+          cc->region_space_->GetObjectsAllocatedInUnevacFromSpace();
+      cc->from_space_num_bytes_at_first_pause_ =
+          cc->region_space_->GetBytesAllocatedInFromSpace() +
+          cc->region_space_->GetBytesAllocatedInUnevacFromSpace();
     }
     cc->is_marking_ = true;
     cc->mark_stack_mode_.StoreRelaxed(ConcurrentCopying::kMarkStackModeThreadLocal);
+    if (cc->young_gen_) {
+      cc->GrayDirtyOldObjects();
+    } else if (cc->generational_) {
+      // A full collection traces all the old objects. Record the writes into them from scratch.
+      cc->heap_->GetCardTable()->ClearCardTable();
+    }
     if (UNLIKELY(Runtime::Current()->IsActiveTransaction())) {
       CHECK(Runtime::Current()->IsAotCompiler());
       TimingLogger::ScopedTiming split2("(Paused)VisitTransactionRoots", cc->GetTimings());
@@ -330,6 +387,117 @@ class ConcurrentCopying::ImmuneSpaceObjVisitor {
   ConcurrentCopying* const collector_;
 };
 
+// Used to gray the old objects that may refer to the young regions at the start of a young
+// collection.
+class ConcurrentCopying::GrayOldObjectVisitor {
+ public:
+  explicit GrayOldObjectVisitor(ConcurrentCopying* cc) : collector_(cc) {}
+
+  void operator()(mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_)
+      SHARED_REQUIRES(Locks::heap_bitmap_lock_) {
+    collector_->GrayOldObject(obj);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+// Used to gray the large objects on dirty cards. The large object space bitmap can't be scanned
+// with CardTable::Scan(). Large objects are page aligned and don't share cards.
+class ConcurrentCopying::GrayDirtyLargeObjectVisitor {
+ public:
+  GrayDirtyLargeObjectVisitor(ConcurrentCopying* cc, accounting::CardTable* card_table)
+      : collector_(cc), card_table_(card_table) {}
+
+  void operator()(mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_)
+      SHARED_REQUIRES(Locks::heap_bitmap_lock_) {
+    if (card_table_->IsDirty(obj)) {
+      *card_table_->CardFromAddr(obj) = accounting::CardTable::kCardClean;
+      collector_->GrayOldObject(obj);
+    }
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  accounting::CardTable* const card_table_;
+};
+
+// Gray an old object and push it onto the mark stack so that its references to the young regions
+// get forwarded in a young collection. Outside the region space, also mark it so that
+// ClearBlackPtrs() turns it back to white afterwards.
+void ConcurrentCopying::GrayOldObject(mirror::Object* obj) {
+  DCHECK(young_gen_);
+  DCHECK(obj != nullptr);
+  if (region_space_->HasAddress(obj)) {
+    DCHECK(region_space_->IsInToSpace(obj)) << obj;
+  } else if (immune_spaces_.ContainsObject(obj)) {
+    if (cc_heap_bitmap_->GetContinuousSpaceBitmap(obj)->AtomicTestAndSet(obj)) {
+      // Already grayed.
+      return;
+    }
+  } else {
+    accounting::ContinuousSpaceBitmap* mark_bitmap =
+        heap_mark_bitmap_->GetContinuousSpaceBitmap(obj);
+    bool is_marked = mark_bitmap != nullptr
+        ? mark_bitmap->AtomicTestAndSet(obj)
+        : heap_mark_bitmap_->GetLargeObjectBitmap(obj)->AtomicTestAndSet(obj);
+    if (is_marked) {
+      // Already grayed.
+      return;
+    }
+  }
+  if (kUseBakerReadBarrier) {
+    bool success = obj->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(),
+                                                    ReadBarrier::GrayPtr());
+    DCHECK(success) << "An old object must be white between collections " << obj;
+  }
+  PushOntoMarkStack(obj);
+}
+
+// Called during the flip pause of a young collection. The old objects are not traced, so gray
+// and scan the ones that may refer to the young regions: those on dirty cards, as the write
+// barrier marks the card of the object written to, and those allocated outside the region space
+// since the last collection, which are on the live stack.
+void ConcurrentCopying::GrayDirtyOldObjects() {
+  TimingLogger::ScopedTiming split("(Paused)GrayDirtyOldObjects", GetTimings());
+  Thread* self = Thread::Current();
+  accounting::CardTable* card_table = heap_->GetCardTable();
+  GrayOldObjectVisitor visitor(this);
+  std::vector<std::pair<uint8_t*, uint8_t*>> old_region_ranges;
+  region_space_->GetOldRegionRanges(&old_region_ranges);
+  WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  for (const std::pair<uint8_t*, uint8_t*>& range : old_region_ranges) {
+    card_table->Scan<false>(region_space_bitmap_, range.first, range.second, visitor);
+  }
+  // Clear the cards of the old regions along with those of the young regions, which are about
+  // to be evacuated.
+  card_table->ClearCardRange(region_space_->Begin(), region_space_->Limit());
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    if (space == region_space_) {
+      continue;
+    }
+    accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+    if (live_bitmap != nullptr) {
+      card_table->Scan<true>(live_bitmap, space->Begin(), space->End(), visitor);
+    }
+  }
+  space::LargeObjectSpace* large_object_space = heap_->GetLargeObjectsSpace();
+  if (large_object_space != nullptr) {
+    GrayDirtyLargeObjectVisitor los_visitor(this, card_table);
+    large_object_space->GetLiveBitmap()->VisitMarkedRange(
+        reinterpret_cast<uintptr_t>(large_object_space->Begin()),
+        reinterpret_cast<uintptr_t>(large_object_space->End()),
+        los_visitor);
+  }
+  accounting::ObjectStack* live_stack = heap_->GetLiveStack();
+  for (auto* it = live_stack->Begin(), *end = live_stack->End(); it < end; ++it) {
+    mirror::Object* obj = it->AsMirrorPtr();
+    if (obj != nullptr) {
+      visitor(obj);
+    }
+  }
+}
+
 class EmptyCheckpoint : public Closure {
  public:
   explicit EmptyCheckpoint(ConcurrentCopying* concurrent_copying)
@@ -386,14 +554,17 @@ void ConcurrentCopying::MarkingPhase() {
     Runtime::Current()->VisitNonThreadRoots(this);
   }
 
-  // Immune spaces.
-  for (auto& space : immune_spaces_.GetSpaces()) {
-    DCHECK(space->IsImageSpace() || space->IsZygoteSpace());
-    accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
-    ImmuneSpaceObjVisitor visitor(this);
-    live_bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
-                                  reinterpret_cast<uintptr_t>(space->Limit()),
-                                  visitor);
+  // Immune spaces. A young collection only scans the immune objects on dirty cards, which
+  // GrayDirtyOldObjects() has grayed.
+  if (!young_gen_) {
+    for (auto& space : immune_spaces_.GetSpaces()) {
+      DCHECK(space->IsImageSpace() || space->IsZygoteSpace());
+      accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+      ImmuneSpaceObjVisitor visitor(this);
+      live_bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
+                                    reinterpret_cast<uintptr_t>(space->Limit()),
+                                    visitor);
+    }
   }
 
   Thread* self = Thread::Current();
@@ -674,9 +845,10 @@ class ConcurrentCopying::VerifyNoFromSpaceRefsVisitor : public SingleRootVisitor
             << "To-space ref " << ref << " " << PrettyTypeOf(ref)
             << " has non-white rb_ptr " << ref->GetReadBarrierPointer();
       } else {
+        // A young collection leaves the old objects white unless they are on dirty cards.
         CHECK(ref->GetReadBarrierPointer() == ReadBarrier::BlackPtr() ||
               (ref->GetReadBarrierPointer() == ReadBarrier::WhitePtr() &&
-               collector_->IsOnAllocStack(ref)))
+               (collector_->IsOnAllocStack(ref) || collector_->young_gen_)))
             << "Non-moving/unevac from space ref " << ref << " " << PrettyTypeOf(ref)
             << " has non-black rb_ptr " << ref->GetReadBarrierPointer()
             << " but isn't on the alloc stack (and has white rb_ptr)."
@@ -754,7 +926,7 @@ class ConcurrentCopying::VerifyNoFromSpaceRefsObjectVisitor {
       } else {
         CHECK(obj->GetReadBarrierPointer() == ReadBarrier::BlackPtr() ||
               (obj->GetReadBarrierPointer() == ReadBarrier::WhitePtr() &&
-               collector->IsOnAllocStack(obj)))
+               (collector->IsOnAllocStack(obj) || collector->young_gen_)))
             << "Non-moving space/unevac from space ref " << obj << " " << PrettyTypeOf(obj)
             << " has non-black rb_ptr " << obj->GetReadBarrierPointer()
             << " but isn't on the alloc stack (and has white rb_ptr). Is it in the non-moving space="
@@ -786,9 +958,15 @@ void ConcurrentCopying::VerifyNoFromSpaceReferences() {
     VerifyNoFromSpaceRefsVisitor ref_visitor(this);
     Runtime::Current()->VisitRoots(&ref_visitor);
   }
-  // The to-space.
-  region_space_->WalkToSpace(VerifyNoFromSpaceRefsObjectVisitor::ObjectCallback, this);
-  // Non-moving spaces.
+  if (young_gen_) {
+    // The to-space, except for the old regions, which a young collection doesn't trace. Their
+    // dead objects may refer to objects freed by earlier collections.
+    region_space_->WalkNewToSpace(VerifyNoFromSpaceRefsObjectVisitor::ObjectCallback, this);
+  } else {
+    // The to-space.
+    region_space_->WalkToSpace(VerifyNoFromSpaceRefsObjectVisitor::ObjectCallback, this);
+  }
+  // Non-moving spaces. For a young collection, the mark bitmap covers the grayed old objects.
   {
     WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
     heap_->GetMarkBitmap()->Visit(visitor);
@@ -950,6 +1128,112 @@ void ConcurrentCopying::RevokeThreadLocalMarkStack(Thread* thread) {
   }
 }
 
+// A chunk of the GC mark stack processed by a heap thread pool worker. Refs that the worker grays
+// while scanning go onto its thread-local mark stack, as they would for a mutator, and the worker
+// keeps draining that stack so that each task traverses as much of the graph as it can reach.
+class ConcurrentCopying::MarkStackTask : public Task {
+ public:
+  MarkStackTask(ConcurrentCopying* collector,
+                size_t mark_stack_size,
+                StackReference<mirror::Object>* mark_stack)
+      : collector_(collector), mark_stack_size_(mark_stack_size) {
+    DCHECK_LE(mark_stack_size, static_cast<size_t>(kMaxSize));
+    std::copy(mark_stack, mark_stack + mark_stack_size, mark_stack_);
+  }
+
+  static constexpr size_t kMaxSize = 1 * KB;
+
+  // No thread safety analysis since the GC thread holds the mutator lock on behalf of the workers
+  // for the duration of ProcessMarkStackParallel().
+  virtual void Run(Thread* self) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = 0; i < mark_stack_size_; ++i) {
+      collector_->ProcessMarkStackRef(mark_stack_[i].AsMirrorPtr());
+    }
+    collector_->DrainThreadLocalMarkStack(self);
+  }
+
+  virtual void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  const size_t mark_stack_size_;
+  StackReference<mirror::Object> mark_stack_[kMaxSize];
+
+  DISALLOW_COPY_AND_ASSIGN(MarkStackTask);
+};
+
+size_t ConcurrentCopying::GetThreadCount() const {
+  // Use less threads if we are in a background state (non jank perceptible) since we want to leave
+  // more CPU time for the foreground apps.
+  if (heap_->GetThreadPool() == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  return heap_->GetParallelGCThreadCount() + 1;
+}
+
+size_t ConcurrentCopying::ProcessMarkStackParallel(size_t thread_count) {
+  Thread* self = Thread::Current();
+  DCHECK_EQ(self, thread_running_gc_);
+  DCHECK_EQ(static_cast<uint32_t>(mark_stack_mode_.LoadRelaxed()),
+            static_cast<uint32_t>(kMarkStackModeThreadLocal));
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  const size_t count = gc_mark_stack_->Size();
+  const size_t chunk_size = std::min(count / thread_count + 1,
+                                     static_cast<size_t>(MarkStackTask::kMaxSize));
+  // Split the GC mark stack up into tasks. The tasks copy their refs, so the GC mark stack can be
+  // reset before the workers start; the GC thread pushes onto it again if it helps run the tasks.
+  for (auto* it = gc_mark_stack_->Begin(), *end = gc_mark_stack_->End(); it < end; ) {
+    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
+    thread_pool->AddTask(self, new MarkStackTask(this, delta, it));
+    it += delta;
+  }
+  gc_mark_stack_->Reset();
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  return count;
+}
+
+void ConcurrentCopying::DrainThreadLocalMarkStack(Thread* self) {
+  if (self == thread_running_gc_) {
+    // The GC thread pushes onto the GC mark stack, which ProcessMarkStackOnce() drains.
+    return;
+  }
+  while (true) {
+    accounting::ObjectStack* tl_mark_stack = self->GetThreadLocalMarkStack();
+    if (tl_mark_stack != nullptr && !tl_mark_stack->IsEmpty()) {
+      ProcessMarkStackRef(tl_mark_stack->PopBack());
+      continue;
+    }
+    // Out of local work. Steal a full stack that a mutator or another worker has revoked.
+    accounting::ObjectStack* mark_stack = nullptr;
+    {
+      MutexLock mu(self, mark_stack_lock_);
+      if (!revoked_mark_stacks_.empty()) {
+        mark_stack = revoked_mark_stacks_.back();
+        revoked_mark_stacks_.pop_back();
+      }
+    }
+    if (mark_stack == nullptr) {
+      // Anything pushed from now on is picked up by the GC thread in ProcessMarkStackOnce().
+      break;
+    }
+    for (StackReference<mirror::Object>* p = mark_stack->Begin(); p != mark_stack->End(); ++p) {
+      ProcessMarkStackRef(p->AsMirrorPtr());
+    }
+    MutexLock mu(self, mark_stack_lock_);
+    if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+      delete mark_stack;
+    } else {
+      mark_stack->Reset();
+      pooled_mark_stacks_.push_back(mark_stack);
+    }
+  }
+}
+
 void ConcurrentCopying::ProcessMarkStack() {
   if (kVerboseMode) {
     LOG(INFO) << "ProcessMarkStack. ";
@@ -975,12 +1259,18 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
     // Process the thread-local mark stacks and the GC mark stack.
     count += ProcessThreadLocalMarkStacks(false);
-    while (!gc_mark_stack_->IsEmpty()) {
-      mirror::Object* to_ref = gc_mark_stack_->PopBack();
-      ProcessMarkStackRef(to_ref);
-      ++count;
+    size_t thread_count = GetThreadCount();
+    if (kParallelProcessMarkStack && thread_count > 1 &&
+        gc_mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+      count += ProcessMarkStackParallel(thread_count);
+    } else {
+      while (!gc_mark_stack_->IsEmpty()) {
+        mirror::Object* to_ref = gc_mark_stack_->PopBack();
+        ProcessMarkStackRef(to_ref);
+        ++count;
+      }
+      gc_mark_stack_->Reset();
     }
-    gc_mark_stack_->Reset();
   } else if (mark_stack_mode == kMarkStackModeShared) {
     // Process the shared GC mark stack with a lock.
     {
@@ -1204,6 +1494,10 @@ void ConcurrentCopying::Sweep(bool swap_bitmaps) {
     live_stack->Reset();
   }
   CheckEmptyMarkStack();
+  if (young_gen_) {
+    // The non-moving spaces and the large objects are only swept by full collections.
+    return;
+  }
   TimingLogger::ScopedTiming split("Sweep", GetTimings());
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace()) {
@@ -1250,6 +1544,12 @@ void ConcurrentCopying::ClearBlackPtrs() {
       continue;
     }
     accounting::ContinuousSpaceBitmap* mark_bitmap = space->GetMarkBitmap();
+    if (young_gen_ && immune_spaces_.ContainsSpace(space)) {
+      // Only the immune objects on dirty cards were grayed. The mark bitmap of an immune space is
+      // bound to its live bitmap.
+      mark_bitmap = cc_heap_bitmap_->GetContinuousSpaceBitmap(
+          reinterpret_cast<mirror::Object*>(space->Begin()));
+    }
     if (kVerboseMode) {
       LOG(INFO) << "ClearBlackPtrs: " << *space << " bitmap: " << *mark_bitmap;
     }
@@ -1334,14 +1634,29 @@ void ConcurrentCopying::ReclaimPhase() {
     }
   }
 
-  {
+  if (!young_gen_) {
+    // A young collection has no unevacuated from-space regions.
     TimingLogger::ScopedTiming split3("ComputeUnevacFromSpaceLiveRatio", GetTimings());
     ComputeUnevacFromSpaceLiveRatio();
   }
 
   {
     TimingLogger::ScopedTiming split4("ClearFromSpace", GetTimings());
-    region_space_->ClearFromSpace();
+    size_t from_space_size = 0;
+    size_t unevac_from_space_size = 0;
+    if (VLOG_IS_ON(heap)) {
+      from_space_size = region_space_->FromSpaceSize();
+      unevac_from_space_size = region_space_->UnevacFromSpaceSize();
+    }
+    uint64_t cleared_bytes;
+    uint64_t cleared_objects;
+    region_space_->ClearFromSpace(&cleared_bytes, &cleared_objects);
+    // The unevacuated regions found to have no live objects were freed as well.
+    RecordFree(ObjectBytePair(cleared_objects, cleared_bytes));
+    VLOG(heap) << GetName() << " evacuated regions: " << PrettySize(from_space_size)
+               << " (" << PrettySize(bytes_moved_.LoadSequentiallyConsistent()) << " copied)"
+               << ", unevacuated regions: " << PrettySize(unevac_from_space_size)
+               << " (" << PrettySize(cleared_bytes) << " freed for having no live objects)";
   }
 
   {
@@ -1350,7 +1665,9 @@ void ConcurrentCopying::ReclaimPhase() {
       ClearBlackPtrs();
     }
     Sweep(false);
-    SwapBitmaps();
+    if (!young_gen_) {
+      SwapBitmaps();
+    }
     heap_->UnBindBitmaps();
 
     // Remove bitmaps for the immune spaces.
@@ -1360,7 +1677,9 @@ void ConcurrentCopying::ReclaimPhase() {
       delete cc_bitmap;
       cc_bitmaps_.pop_back();
     }
-    region_space_bitmap_ = nullptr;
+    if (!generational_) {
+      region_space_bitmap_ = nullptr;
+    }
   }
 
   CheckEmptyMarkStack();
@@ -1378,6 +1697,11 @@ class ConcurrentCopying::ComputeUnevacFromSpaceLiveRatioVisitor {
       SHARED_REQUIRES(Locks::heap_bitmap_lock_) {
     DCHECK(ref != nullptr);
     DCHECK(collector_->region_space_bitmap_->Test(ref)) << ref;
+    if (collector_->generational_ && !collector_->region_space_->IsInUnevacFromSpace(ref)) {
+      // A promoted object, recorded by Copy().
+      DCHECK(collector_->region_space_->IsInToSpace(ref)) << ref;
+      return;
+    }
     DCHECK(collector_->region_space_->IsInUnevacFromSpace(ref)) << ref;
     if (kUseBakerReadBarrier) {
       DCHECK_EQ(ref->GetReadBarrierPointer(), ReadBarrier::BlackPtr()) << ref;
@@ -1546,6 +1870,10 @@ void ConcurrentCopying::LogFromSpaceRefHolder(mirror::Object* obj, MemberOffset
 void ConcurrentCopying::AssertToSpaceInvariantInNonMovingSpace(mirror::Object* obj,
                                                                mirror::Object* ref) {
   // In a non-moving spaces. Check that the ref is marked.
+  if (young_gen_) {
+    // Not marked in a young collection.
+    return;
+  }
   if (immune_spaces_.ContainsObject(ref)) {
     accounting::ContinuousSpaceBitmap* cc_bitmap =
         cc_heap_bitmap_->GetContinuousSpaceBitmap(ref);
@@ -1826,6 +2154,11 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref) {
           heap_mark_bitmap_->GetContinuousSpaceBitmap(to_ref);
       CHECK(mark_bitmap != nullptr);
       CHECK(!mark_bitmap->AtomicTestAndSet(to_ref));
+      if (young_gen_) {
+        // A young collection doesn't swap the bitmaps. Make it live for the card scanning and
+        // the sweeping of the following collections.
+        CHECK(!heap_->non_moving_space_->GetLiveBitmap()->AtomicTestAndSet(to_ref));
+      }
     }
   }
   DCHECK(to_ref != nullptr);
@@ -1866,6 +2199,9 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref) {
             heap_mark_bitmap_->GetContinuousSpaceBitmap(to_ref);
         CHECK(mark_bitmap != nullptr);
         CHECK(mark_bitmap->Clear(to_ref));
+        if (young_gen_) {
+          CHECK(heap_->non_moving_space_->GetLiveBitmap()->Clear(to_ref));
+        }
         heap_->non_moving_space_->Free(Thread::Current(), to_ref);
       }
 
@@ -1894,6 +2230,10 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref) {
       bytes_moved_.FetchAndAddSequentiallyConsistent(region_space_alloc_size);
       if (LIKELY(!fall_back_to_non_moving)) {
         DCHECK(region_space_->IsInToSpace(to_ref));
+        if (generational_) {
+          // Record the promoted object for the card scanning of the following young collections.
+          region_space_bitmap_->AtomicTestAndSet(to_ref);
+        }
       } else {
         DCHECK(heap_->non_moving_space_->HasAddress(to_ref));
         DCHECK_EQ(bytes_allocated, non_moving_space_bytes_allocated);
@@ -1931,6 +2271,9 @@ mirror::Object* ConcurrentCopying::IsMarked(mirror::Object* from_ref) {
     } else {
       to_ref = nullptr;
     }
+  } else if (young_gen_) {
+    // from_ref is in a non-moving space. A young collection doesn't collect these.
+    to_ref = from_ref;
   } else {
     // from_ref is in a non-moving space.
     if (immune_spaces_.ContainsObject(from_ref)) {
@@ -1987,6 +2330,11 @@ bool ConcurrentCopying::IsOnAllocStack(mirror::Object* ref) {
 mirror::Object* ConcurrentCopying::MarkNonMoving(mirror::Object* ref) {
   // ref is in a non-moving space (from_ref == to_ref).
   DCHECK(!region_space_->HasAddress(ref)) << ref;
+  if (young_gen_) {
+    // A young collection doesn't collect the non-moving spaces. The non-moving objects that may
+    // refer to the young regions were grayed at the flip.
+    return ref;
+  }
   if (immune_spaces_.ContainsObject(ref)) {
     accounting::ContinuousSpaceBitmap* cc_bitmap =
         cc_heap_bitmap_->GetContinuousSpaceBitmap(ref);
@@ -2071,6 +2419,33 @@ void ConcurrentCopying::FinishPhase() {
     MutexLock mu(self, mark_stack_lock_);
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
+  if (generational_) {
+    // Decide whether to do a young or a full collection at the next collection by updating
+    // young_gen_.
+    space::LargeObjectSpace* los = GetHeap()->GetLargeObjectsSpace();
+    uint64_t bytes_promoted = bytes_moved_.LoadSequentiallyConsistent();
+    if (young_gen_) {
+      // Do a full collection next if the bytes promoted since the last full collection or the
+      // large object bytes allocated exceeds a threshold.
+      bytes_promoted_since_last_full_collection_ += bytes_promoted;
+      bool bytes_promoted_threshold_exceeded =
+          bytes_promoted_since_last_full_collection_ >= kBytesPromotedThreshold;
+      uint64_t current_los_bytes_allocated = los != nullptr ? los->GetBytesAllocated() : 0U;
+      bool large_object_bytes_threshold_exceeded =
+          current_los_bytes_allocated >=
+          large_object_bytes_allocated_at_last_full_collection_ +
+          kLargeObjectBytesAllocatedThreshold;
+      if (bytes_promoted_threshold_exceeded || large_object_bytes_threshold_exceeded) {
+        young_gen_ = false;
+      }
+    } else {
+      // Reset the counters.
+      bytes_promoted_since_last_full_collection_ = bytes_promoted;
+      large_object_bytes_allocated_at_last_full_collection_ =
+          los != nullptr ? los->GetBytesAllocated() : 0U;
+      young_gen_ = true;
+    }
+  }
   region_space_ = nullptr;
   {
     MutexLock mu(Thread::Current(), skipped_blocks_lock_);
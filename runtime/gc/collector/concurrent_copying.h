@@ -59,7 +59,11 @@ class ConcurrentCopying : public GarbageCollector {
   // Enable verbose mode.
   static constexpr bool kVerboseMode = false;
 
-  ConcurrentCopying(Heap* heap, const std::string& name_prefix = "");
+  // If generational is true, most collections are young collections that only evacuate the
+  // regions allocated since the last collection, using the card table to find the references
+  // from the old generation.
+  explicit ConcurrentCopying(Heap* heap, bool generational = false,
+                             const std::string& name_prefix = "");
   ~ConcurrentCopying();
 
   virtual void RunPhases() OVERRIDE REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_);
@@ -136,6 +140,15 @@ class ConcurrentCopying : public GarbageCollector {
   bool ProcessMarkStackOnce() SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
   void ProcessMarkStackRef(mirror::Object* to_ref) SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Returns the number of threads, including the GC thread, used to process the GC mark stack.
+  size_t GetThreadCount() const;
+  // Process the GC mark stack with the heap thread pool. Returns the number of refs handed out.
+  size_t ProcessMarkStackParallel(size_t thread_count) SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Process the calling worker's thread-local mark stack and steal revoked mark stacks until there
+  // is no work left.
+  void DrainThreadLocalMarkStack(Thread* self) SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
   size_t ProcessThreadLocalMarkStacks(bool disable_weak_ref_access)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
   void RevokeThreadLocalMarkStacks(bool disable_weak_ref_access)
@@ -175,6 +188,9 @@ class ConcurrentCopying : public GarbageCollector {
   void SwapStacks() SHARED_REQUIRES(Locks::mutator_lock_);
   void RecordLiveStackFreezeSize(Thread* self);
   void ComputeUnevacFromSpaceLiveRatio();
+  void GrayDirtyOldObjects() REQUIRES(Locks::mutator_lock_, !mark_stack_lock_);
+  void GrayOldObject(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
   void LogFromSpaceRefHolder(mirror::Object* obj, MemberOffset offset)
       SHARED_REQUIRES(Locks::mutator_lock_);
   void AssertToSpaceInvariantInNonMovingSpace(mirror::Object* obj, mirror::Object* ref)
@@ -237,6 +253,27 @@ class ConcurrentCopying : public GarbageCollector {
   accounting::ReadBarrierTable* rb_table_;
   bool force_evacuate_all_;  // True if all regions are evacuated.
 
+  // When true, the generational mode (young collections of the regions allocated since the last
+  // collection) is enabled.
+  const bool generational_;
+
+  // Used for the generational mode. When true, the current collection is a young collection: the
+  // old regions, the non-moving spaces and the large objects are not traced and the old objects
+  // on dirty cards are scanned instead. region_space_bitmap_ then persists across collections and
+  // records the objects in the old regions.
+  bool young_gen_;
+
+  // Used for the generational mode. Keeps track of how many bytes of objects have been promoted
+  // to the old regions since the last full collection.
+  uint64_t bytes_promoted_since_last_full_collection_;
+
+  // Used for the generational mode. Keeps track of how many bytes of large objects were allocated
+  // at the last full collection.
+  uint64_t large_object_bytes_allocated_at_last_full_collection_;
+
+  // The name of the collector.
+  std::string collector_name_;
+
   class AssertToSpaceInvariantFieldVisitor;
   class AssertToSpaceInvariantObjectVisitor;
   class AssertToSpaceInvariantRefsVisitor;
@@ -244,8 +281,11 @@ class ConcurrentCopying : public GarbageCollector {
   class ComputeUnevacFromSpaceLiveRatioVisitor;
   class DisableMarkingCheckpoint;
   class FlipCallback;
+  class GrayDirtyLargeObjectVisitor;
+  class GrayOldObjectVisitor;
   class ImmuneSpaceObjVisitor;
   class LostCopyVisitor;
+  class MarkStackTask;
   class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class VerifyNoFromSpaceRefsFieldVisitor;
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "concurrent_copying.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "base/stringprintf.h"
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string-inl.h"
+#include "scoped_thread_state_change.h"
+#include "thread_list.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+class ConcurrentCopyingTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    if (kUseReadBarrier) {
+      options->push_back(std::make_pair("-Xgc:CC", nullptr));
+    }
+  }
+
+  // Runs a collection the way the heap task daemon does after an allocation, which lets a
+  // generational collector do a young collection.
+  void BackgroundGc(Thread* self) {
+    ScopedThreadSuspension sts(self, kNative);
+    Runtime::Current()->GetHeap()->ConcurrentGC(self, /* force_full */ false);
+  }
+
+  // Runs an explicit collection, which is always a full collection.
+  void ExplicitGc(Thread* self) {
+    ScopedThreadSuspension sts(self, kNative);
+    Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references */ false);
+  }
+
+  size_t VerifyHeap(Thread* self) {
+    ScopedThreadSuspension sts(self, kSuspended);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    return Runtime::Current()->GetHeap()->VerifyHeapReferences();
+  }
+
+  mirror::Class* FindObjectArrayClass(Thread* self) SHARED_REQUIRES(Locks::mutator_lock_) {
+    return class_linker_->FindSystemClass(self, "[Ljava/lang/Object;");
+  }
+};
+
+class GenerationalConcurrentCopyingTest : public ConcurrentCopyingTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    ConcurrentCopyingTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:GenerationalCC", nullptr));
+  }
+
+  static bool WasYoungCollection(ConcurrentCopying* cc) {
+    return strstr(cc->GetName(), " young") != nullptr;
+  }
+};
+
+class ParallelConcurrentCopyingTest : public ConcurrentCopyingTest {
+ protected:
+  static constexpr size_t kParallelGcThreads = 4;
+  static constexpr size_t kNumEdges = 4;
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    ConcurrentCopyingTest::SetUpRuntimeOptions(options);
+    options->push_back(
+        std::make_pair(StringPrintf("-XX:ParallelGCThreads=%zu", kParallelGcThreads), nullptr));
+  }
+
+  static size_t NextRandom(size_t* seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 16;
+  }
+
+  // A node is an object array with kNumEdges references to other nodes, followed by a string
+  // holding the index of the node.
+  static size_t NodeIndex(mirror::Object* node) SHARED_REQUIRES(Locks::mutator_lock_) {
+    mirror::Object* label = node->AsObjectArray<mirror::Object>()->Get(kNumEdges);
+    return atoi(label->AsString()->ToModifiedUtf8().c_str());
+  }
+};
+
+constexpr size_t ParallelConcurrentCopyingTest::kParallelGcThreads;
+constexpr size_t ParallelConcurrentCopyingTest::kNumEdges;
+
+TEST_F(GenerationalConcurrentCopyingTest, OldToYoungReferences) {
+  if (!kUseReadBarrier) {
+    // The concurrent copying collector needs read barriers.
+    return;
+  }
+  static constexpr size_t kNumOldArrays = 16;
+  static constexpr size_t kOldArrayLength = 64;
+  static constexpr size_t kNumCycles = 8;
+  // Every fourth collection is a full collection, the others are young collections.
+  static constexpr size_t kFullCollectionInterval = 4;
+
+  Heap* heap = Runtime::Current()->GetHeap();
+  ASSERT_EQ(kCollectorTypeCC, heap->CurrentCollectorType());
+  ConcurrentCopying* cc = heap->ConcurrentCopyingCollector();
+  ASSERT_TRUE(cc != nullptr);
+
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Class> array_class(hs.NewHandle(FindObjectArrayClass(self)));
+  ASSERT_TRUE(array_class.Get() != nullptr);
+  Handle<mirror::ObjectArray<mirror::Object>> old_arrays(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumOldArrays)));
+  ASSERT_TRUE(old_arrays.Get() != nullptr);
+  for (size_t i = 0; i < kNumOldArrays; ++i) {
+    mirror::Object* array =
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kOldArrayLength);
+    ASSERT_TRUE(array != nullptr);
+    old_arrays->Set<false>(i, array);
+  }
+  // Promote the arrays to the old generation.
+  ExplicitGc(self);
+  EXPECT_FALSE(WasYoungCollection(cc));
+  EXPECT_EQ(0u, VerifyHeap(self));
+
+  for (size_t cycle = 0; cycle < kNumCycles; ++cycle) {
+    // Replace the strings the old arrays refer to with new ones, so that the only references to
+    // the young strings are from old objects on dirty cards, and the previous strings die.
+    for (size_t i = 0; i < kNumOldArrays; ++i) {
+      for (size_t j = 0; j < kOldArrayLength; ++j) {
+        std::string value = StringPrintf("%zu-%zu-%zu", cycle, i, j);
+        mirror::String* string = mirror::String::AllocFromModifiedUtf8(self, value.c_str());
+        ASSERT_TRUE(string != nullptr);
+        old_arrays->Get(i)->AsObjectArray<mirror::Object>()->Set<false>(j, string);
+      }
+    }
+    const bool full = (cycle % kFullCollectionInterval) == kFullCollectionInterval - 1;
+    if (full) {
+      ExplicitGc(self);
+    } else {
+      BackgroundGc(self);
+    }
+    EXPECT_EQ(!full, WasYoungCollection(cc)) << "cycle " << cycle;
+    EXPECT_EQ(0u, VerifyHeap(self)) << "cycle " << cycle;
+
+    // The young strings survived the collection, and were moved with their contents intact.
+    for (size_t i = 0; i < kNumOldArrays; ++i) {
+      mirror::ObjectArray<mirror::Object>* array =
+          old_arrays->Get(i)->AsObjectArray<mirror::Object>();
+      for (size_t j = 0; j < kOldArrayLength; ++j) {
+        mirror::Object* string = array->Get(j);
+        ASSERT_TRUE(string != nullptr);
+        ASSERT_TRUE(string->IsString());
+        EXPECT_EQ(StringPrintf("%zu-%zu-%zu", cycle, i, j), string->AsString()->ToModifiedUtf8());
+      }
+    }
+  }
+}
+
+TEST_F(ParallelConcurrentCopyingTest, LinkedGraph) {
+  if (!kUseReadBarrier) {
+    // The concurrent copying collector needs read barriers.
+    return;
+  }
+  static constexpr size_t kNumNodes = 16 * KB;
+  static constexpr size_t kNumRoots = 256;
+  static constexpr size_t kNumCycles = 4;
+  // Every kRewireStride-th live node gets one of its edges pointed at another live node.
+  static constexpr size_t kRewireStride = 8;
+
+  // The heap thread pool is created by CommonRuntimeTest, and the collector processes the mark
+  // stack with it when it holds enough refs.
+  Heap* heap = Runtime::Current()->GetHeap();
+  ASSERT_EQ(kCollectorTypeCC, heap->CurrentCollectorType());
+  ASSERT_EQ(kParallelGcThreads, heap->GetParallelGCThreadCount());
+  ASSERT_TRUE(heap->GetThreadPool() != nullptr);
+
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<3> hs(self);
+  Handle<mirror::Class> array_class(hs.NewHandle(FindObjectArrayClass(self)));
+  ASSERT_TRUE(array_class.Get() != nullptr);
+  MutableHandle<mirror::ObjectArray<mirror::Object>> nodes(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumNodes)));
+  ASSERT_TRUE(nodes.Get() != nullptr);
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    StackHandleScope<1> hs2(self);
+    Handle<mirror::String> label(hs2.NewHandle(
+        mirror::String::AllocFromModifiedUtf8(self, StringPrintf("%zu", i).c_str())));
+    ASSERT_TRUE(label.Get() != nullptr);
+    mirror::ObjectArray<mirror::Object>* node =
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumEdges + 1);
+    ASSERT_TRUE(node != nullptr);
+    node->Set<false>(kNumEdges, label.Get());
+    nodes->Set<false>(i, node);
+  }
+  // Link the nodes at random, so that most of them are only reachable through long paths, and
+  // the workers find more refs to process than the tasks they started with.
+  size_t seed = 123456789;
+  std::vector<size_t> edges(kNumNodes * kNumEdges);
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    for (size_t k = 0; k < kNumEdges; ++k) {
+      const size_t target = NextRandom(&seed) % kNumNodes;
+      edges[i * kNumEdges + k] = target;
+      nodes->Get(i)->AsObjectArray<mirror::Object>()->Set<false>(k, nodes->Get(target));
+    }
+  }
+  Handle<mirror::ObjectArray<mirror::Object>> roots(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumRoots)));
+  ASSERT_TRUE(roots.Get() != nullptr);
+  for (size_t r = 0; r < kNumRoots; ++r) {
+    roots->Set<false>(r, nodes->Get(r * (kNumNodes / kNumRoots)));
+  }
+  // From now on, the nodes are only reachable from the roots.
+  nodes.Assign(nullptr);
+
+  for (size_t cycle = 0; cycle < kNumCycles; ++cycle) {
+    ExplicitGc(self);
+    EXPECT_EQ(0u, VerifyHeap(self)) << "cycle " << cycle;
+
+    // Walk the graph from the roots, checking that every edge still leads to the right node.
+    std::vector<mirror::Object*> live_nodes(kNumNodes, nullptr);
+    std::vector<mirror::Object*> work_stack;
+    for (size_t r = 0; r < kNumRoots; ++r) {
+      work_stack.push_back(roots->Get(r));
+    }
+    while (!work_stack.empty()) {
+      mirror::Object* node = work_stack.back();
+      work_stack.pop_back();
+      ASSERT_TRUE(node != nullptr);
+      ASSERT_TRUE(node->IsObjectArray());
+      const size_t index = NodeIndex(node);
+      ASSERT_LT(index, kNumNodes);
+      if (live_nodes[index] != nullptr) {
+        EXPECT_EQ(live_nodes[index], node) << "cycle " << cycle << " node " << index;
+        continue;
+      }
+      live_nodes[index] = node;
+      for (size_t k = 0; k < kNumEdges; ++k) {
+        mirror::Object* target = node->AsObjectArray<mirror::Object>()->Get(k);
+        ASSERT_TRUE(target != nullptr);
+        EXPECT_EQ(edges[index * kNumEdges + k], NodeIndex(target))
+            << "cycle " << cycle << " node " << index << " edge " << k;
+        work_stack.push_back(target);
+      }
+    }
+
+    // Rewire some edges, which makes the nodes only reachable through them garbage and changes
+    // the shape of the graph for the next collection. Nothing allocates meanwhile, so the raw
+    // pointers stay valid.
+    std::vector<size_t> live_indices;
+    for (size_t i = 0; i < kNumNodes; ++i) {
+      if (live_nodes[i] != nullptr) {
+        live_indices.push_back(i);
+      }
+    }
+    ASSERT_GT(live_indices.size(), kNumRoots);
+    for (size_t n = 0; n < live_indices.size(); n += kRewireStride) {
+      const size_t index = live_indices[n];
+      const size_t k = NextRandom(&seed) % kNumEdges;
+      const size_t target = live_indices[NextRandom(&seed) % live_indices.size()];
+      edges[index * kNumEdges + k] = target;
+      live_nodes[index]->AsObjectArray<mirror::Object>()->Set<false>(k, live_nodes[target]);
+    }
+  }
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
@@ -146,6 +146,8 @@ Heap::Heap(size_t initial_size,
            size_t long_gc_log_threshold,
            bool ignore_max_footprint,
            bool use_tlab,
+           bool use_generational_cc,
+           uint32_t evacuate_live_percent_threshold,
            bool verify_pre_gc_heap,
            bool verify_pre_sweeping_heap,
            bool verify_post_gc_heap,
@@ -442,7 +444,8 @@ Heap::Heap(size_t initial_size,
   }
   // Create other spaces based on whether or not we have a moving GC.
   if (foreground_collector_type_ == kCollectorTypeCC) {
-    region_space_ = space::RegionSpace::Create("Region space", capacity_ * 2, request_begin);
+    region_space_ = space::RegionSpace::Create("Region space", capacity_ * 2, request_begin,
+                                               evacuate_live_percent_threshold);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_) &&
       foreground_collector_type_ != kCollectorTypeGSS) {
@@ -594,7 +597,8 @@ Heap::Heap(size_t initial_size,
       garbage_collectors_.push_back(semi_space_collector_);
     }
     if (MayUseCollector(kCollectorTypeCC)) {
-      concurrent_copying_collector_ = new collector::ConcurrentCopying(this);
+      concurrent_copying_collector_ = new collector::ConcurrentCopying(
+          this, use_generational_cc, use_generational_cc ? "generational" : "");
       garbage_collectors_.push_back(concurrent_copying_collector_);
     }
     if (MayUseCollector(kCollectorTypeMC)) {
@@ -3491,6 +3495,20 @@ void Heap::DumpForSigQuit(std::ostream& os) {
   os << "Heap: " << GetPercentFree() << "% free, " << PrettySize(GetBytesAllocated()) << "/"
      << PrettySize(GetTotalMemory()) << "; " << GetObjectsAllocated() << " objects\n";
   DumpGcPerformanceInfo(os);
+  if (IsAllocTrackingEnabled()) {
+    static constexpr size_t kNumDumpedAllocationSites = 20;
+    Thread* self = Thread::Current();
+    AllocRecordObjectMap* records;
+    {
+      MutexLock mu(self, *Locks::alloc_tracker_lock_);
+      records = GetAllocationRecords();
+    }
+    // The allocation records are kept until the heap is deleted once allocated.
+    if (records != nullptr && records->GetSampleIntervalBytes() != 0) {
+      ScopedObjectAccess soa(self);
+      records->DumpAllocationSites(os, kNumDumpedAllocationSites);
+    }
+  }
 }
 
 size_t Heap::GetPercentFree() {
@@ -133,6 +133,8 @@ class Heap {
   static constexpr double kDefaultHeapGrowthMultiplier = 2.0;
   // Primitive arrays larger than this size are put in the large object space.
   static constexpr size_t kDefaultLargeObjectThreshold = 3 * kPageSize;
+  // Region space regions whose live percent is below this are evacuated by the CC collector.
+  static constexpr uint32_t kDefaultEvacuateLivePercentThreshold = 75U;
   // Whether or not parallel GC is enabled. If not, then we never create the thread pool.
   static constexpr bool kDefaultEnableParallelGC = false;
 
@@ -175,6 +177,8 @@ class Heap {
        size_t long_gc_threshold,
        bool ignore_max_footprint,
        bool use_tlab,
+       bool use_generational_cc,
+       uint32_t evacuate_live_percent_threshold,
        bool verify_pre_gc_heap,
        bool verify_pre_sweeping_heap,
        bool verify_post_gc_heap,
@@ -18,6 +18,7 @@
 
 #include "base/time_utils.h"
 #include "collector/garbage_collector.h"
+#include "heap.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/reference-inl.h"
@@ -26,6 +27,7 @@
 #include "ScopedLocalRef.h"
 #include "scoped_thread_state_change.h"
 #include "task_processor.h"
+#include "thread_pool.h"
 #include "utils.h"
 #include "well_known_classes.h"
 
@@ -37,12 +39,19 @@ static constexpr bool kAsyncReferenceQueueAdd = false;
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
       preserving_references_(false),
+      clearing_references_(false),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
-      soft_reference_queue_(Locks::reference_queue_soft_references_lock_),
-      weak_reference_queue_(Locks::reference_queue_weak_references_lock_),
       finalizer_reference_queue_(Locks::reference_queue_finalizer_references_lock_),
       phantom_reference_queue_(Locks::reference_queue_phantom_references_lock_),
       cleared_references_(Locks::reference_queue_cleared_references_lock_) {
+  for (size_t i = 0; i < kNumReferenceQueueStripes; ++i) {
+    soft_reference_queue_locks_[i].reset(
+        new Mutex("ReferenceQueue soft references lock", kReferenceQueueSoftReferencesLock));
+    weak_reference_queue_locks_[i].reset(
+        new Mutex("ReferenceQueue weak references lock", kReferenceQueueWeakReferencesLock));
+    soft_reference_queues_[i].reset(new ReferenceQueue(soft_reference_queue_locks_[i].get()));
+    weak_reference_queues_[i].reset(new ReferenceQueue(weak_reference_queue_locks_[i].get()));
+  }
 }
 
 void ReferenceProcessor::EnableSlowPath() {
@@ -96,6 +105,14 @@ mirror::Object* ReferenceProcessor::GetReferent(Thread* self, mirror::Reference*
            (LIKELY(!reference->IsFinalizerReferenceInstance()) && reference->IsUnprocessed())) {
           return referent_addr->AsMirrorPtr();
         }
+      } else if (clearing_references_ &&
+                 LIKELY(!reference->IsFinalizerReferenceInstance()) &&
+                 !reference->IsUnprocessed()) {
+        // Marking is complete and the reference was discovered this cycle, so its referent is
+        // white for good and is going to be cleared. This does not hold for references which were
+        // not discovered, e.g. allocated after marking, whose referents may be live objects that
+        // are only on the allocation stack.
+        return nullptr;
       }
     }
     condition_.WaitHoldingLocks(self);
@@ -115,6 +132,77 @@ void ReferenceProcessor::StopPreservingReferences(Thread* self) {
   condition_.Broadcast(self);
 }
 
+void ReferenceProcessor::StartClearingReferences(Thread* self) {
+  MutexLock mu(self, *Locks::reference_processor_lock_);
+  clearing_references_ = true;
+  // Marking is complete, the blocked mutators can now tell whether their referent is cleared.
+  condition_.Broadcast(self);
+}
+
+class ClearWhiteReferencesTask : public Task {
+ public:
+  ClearWhiteReferencesTask(ReferenceQueue* queue,
+                           ReferenceQueue* cleared_references,
+                           collector::GarbageCollector* collector)
+      : queue_(queue), cleared_references_(cleared_references), collector_(collector) {}
+
+  // The GC thread holds the mutator lock for the workers.
+  void Run(Thread* self ATTRIBUTE_UNUSED) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    queue_->ClearWhiteReferences(cleared_references_, collector_);
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  ReferenceQueue* const queue_;
+  ReferenceQueue* const cleared_references_;
+  collector::GarbageCollector* const collector_;
+};
+
+void ReferenceProcessor::ClearWhiteSoftAndWeakReferences(bool concurrent,
+                                                         collector::GarbageCollector* collector) {
+  Heap* const heap = Runtime::Current()->GetHeap();
+  ThreadPool* const thread_pool = heap->GetThreadPool();
+  const size_t thread_count = (thread_pool == nullptr)
+      ? 1u
+      : (concurrent ? heap->GetConcGCThreadCount() : heap->GetParallelGCThreadCount()) + 1u;
+  // Transactions record the cleared referents and are not thread safe.
+  if (thread_count == 1u || Runtime::Current()->IsActiveTransaction()) {
+    for (size_t i = 0; i < kNumReferenceQueueStripes; ++i) {
+      soft_reference_queues_[i]->ClearWhiteReferences(&cleared_references_, collector);
+      weak_reference_queues_[i]->ClearWhiteReferences(&cleared_references_, collector);
+    }
+    return;
+  }
+  // Each task clears one queue into its own queue of cleared references, which are then joined.
+  Thread* self = Thread::Current();
+  std::vector<std::unique_ptr<ReferenceQueue>> cleared_queues;
+  for (size_t i = 0; i < 2 * kNumReferenceQueueStripes; ++i) {
+    ReferenceQueue* queue = (i < kNumReferenceQueueStripes)
+        ? soft_reference_queues_[i].get()
+        : weak_reference_queues_[i - kNumReferenceQueueStripes].get();
+    if (queue->IsEmpty()) {
+      continue;
+    }
+    ReferenceQueue* cleared_queue =
+        new ReferenceQueue(Locks::reference_queue_cleared_references_lock_);
+    cleared_queues.emplace_back(cleared_queue);
+    thread_pool->AddTask(self, new ClearWhiteReferencesTask(queue, cleared_queue, collector));
+  }
+  if (cleared_queues.empty()) {
+    return;
+  }
+  thread_pool->SetMaxActiveWorkers(std::min(thread_count, cleared_queues.size()) - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  for (const std::unique_ptr<ReferenceQueue>& cleared_queue : cleared_queues) {
+    cleared_references_.EnqueueQueue(cleared_queue.get());
+  }
+}
+
 // Process reference class instances and schedule finalizations.
 void ReferenceProcessor::ProcessReferences(bool concurrent, TimingLogger* timings,
                                            bool clear_soft_references,
@@ -124,6 +212,7 @@ void ReferenceProcessor::ProcessReferences(bool concurrent, TimingLogger* timing
   {
     MutexLock mu(self, *Locks::reference_processor_lock_);
     collector_ = collector;
+    clearing_references_ = false;
     if (!kUseReadBarrier) {
       CHECK_EQ(SlowPathEnabled(), concurrent) << "Slow path must be enabled iff concurrent";
     } else {
@@ -140,15 +229,16 @@ void ReferenceProcessor::ProcessReferences(bool concurrent, TimingLogger* timing
     }
     // TODO: Add smarter logic for preserving soft references. The behavior should be a conditional
     // mark if the SoftReference is supposed to be preserved.
-    soft_reference_queue_.ForwardSoftReferences(collector);
+    for (const std::unique_ptr<ReferenceQueue>& queue : soft_reference_queues_) {
+      queue->ForwardSoftReferences(collector);
+    }
     collector->ProcessMarkStack();
     if (concurrent) {
       StopPreservingReferences(self);
     }
   }
   // Clear all remaining soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteSoftAndWeakReferences(concurrent, collector);
   {
     TimingLogger::ScopedTiming t2(concurrent ? "EnqueueFinalizerReferences" :
         "(Paused)EnqueueFinalizerReferences", timings);
@@ -162,14 +252,18 @@ void ReferenceProcessor::ProcessReferences(bool concurrent, TimingLogger* timing
       StopPreservingReferences(self);
     }
   }
+  if (concurrent) {
+    StartClearingReferences(self);
+  }
   // Clear all finalizer referent reachable soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteSoftAndWeakReferences(concurrent, collector);
   // Clear all phantom references with white referents.
   phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
   // At this point all reference queues other than the cleared references should be empty.
-  DCHECK(soft_reference_queue_.IsEmpty());
-  DCHECK(weak_reference_queue_.IsEmpty());
+  for (size_t i = 0; i < kNumReferenceQueueStripes; ++i) {
+    DCHECK(soft_reference_queues_[i]->IsEmpty());
+    DCHECK(weak_reference_queues_[i]->IsEmpty());
+  }
   DCHECK(finalizer_reference_queue_.IsEmpty());
   DCHECK(phantom_reference_queue_.IsEmpty());
   {
@@ -179,6 +273,7 @@ void ReferenceProcessor::ProcessReferences(bool concurrent, TimingLogger* timing
     // starts since there is a small window of time where slow_path_enabled_ is enabled but the
     // callback isn't yet set.
     collector_ = nullptr;
+    clearing_references_ = false;
     if (!kUseReadBarrier && concurrent) {
       // Done processing, disable the slow path and broadcast to the waiters.
       DisableSlowPath(self);
@@ -199,10 +294,12 @@ void ReferenceProcessor::DelayReferenceReferent(mirror::Class* klass, mirror::Re
     // TODO: Remove these locks, and use atomic stacks for storing references?
     // We need to check that the references haven't already been enqueued since we can end up
     // scanning the same reference multiple times due to dirty cards.
+    // A reference is always delayed at the same address during a collection, so it is always
+    // checked for being already enqueued under the same stripe lock.
     if (klass->IsSoftReferenceClass()) {
-      soft_reference_queue_.AtomicEnqueueIfNotEnqueued(self, ref);
+      soft_reference_queues_[GetReferenceQueueStripe(ref)]->AtomicEnqueueIfNotEnqueued(self, ref);
     } else if (klass->IsWeakReferenceClass()) {
-      weak_reference_queue_.AtomicEnqueueIfNotEnqueued(self, ref);
+      weak_reference_queues_[GetReferenceQueueStripe(ref)]->AtomicEnqueueIfNotEnqueued(self, ref);
     } else if (klass->IsFinalizerReferenceClass()) {
       finalizer_reference_queue_.AtomicEnqueueIfNotEnqueued(self, ref);
     } else if (klass->IsPhantomReferenceClass()) {
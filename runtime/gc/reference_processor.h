@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include <memory>
+
 #include "base/mutex.h"
 #include "globals.h"
 #include "jni.h"
@@ -72,6 +74,15 @@ class ReferenceProcessor {
                !Locks::reference_queue_finalizer_references_lock_);
 
  private:
+  // Soft and weak references are discovered in several queues, picked by the address of the
+  // reference, so that the threads marking objects rarely contend on the queue locks and the
+  // queues can be cleared in parallel.
+  static constexpr size_t kNumReferenceQueueStripes = 8;
+
+  static size_t GetReferenceQueueStripe(mirror::Reference* ref) {
+    return (reinterpret_cast<uintptr_t>(ref) / kObjectAlignment) % kNumReferenceQueueStripes;
+  }
+
   bool SlowPathEnabled() SHARED_REQUIRES(Locks::mutator_lock_);
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
@@ -81,22 +92,36 @@ class ReferenceProcessor {
   // referents.
   void StartPreservingReferences(Thread* self) REQUIRES(!Locks::reference_processor_lock_);
   void StopPreservingReferences(Thread* self) REQUIRES(!Locks::reference_processor_lock_);
+  // Called once marking is complete, after which GetReferent no longer needs to block.
+  void StartClearingReferences(Thread* self) REQUIRES(!Locks::reference_processor_lock_);
+  // Clear the soft and weak references with white referents, on the heap thread pool if possible.
+  void ClearWhiteSoftAndWeakReferences(bool concurrent, collector::GarbageCollector* collector)
+      SHARED_REQUIRES(Locks::mutator_lock_);
   // Collector which is clearing references, used by the GetReferent to return referents which are
   // already marked.
   collector::GarbageCollector* collector_ GUARDED_BY(Locks::reference_processor_lock_);
   // Boolean for whether or not we are preserving references (either soft references or finalizers).
   // If this is true, then we cannot return a referent (see comment in GetReferent).
   bool preserving_references_ GUARDED_BY(Locks::reference_processor_lock_);
+  // Boolean for whether marking is complete and the white referents of the discovered references
+  // are only waiting to be cleared. If this is true, GetReferent can return whether or not the
+  // referent of a discovered reference is marked.
+  bool clearing_references_ GUARDED_BY(Locks::reference_processor_lock_);
   // Condition that people wait on if they attempt to get the referent of a reference while
   // processing is in progress.
   ConditionVariable condition_ GUARDED_BY(Locks::reference_processor_lock_);
+  // Locks of the soft and weak reference queue stripes.
+  std::unique_ptr<Mutex> soft_reference_queue_locks_[kNumReferenceQueueStripes];
+  std::unique_ptr<Mutex> weak_reference_queue_locks_[kNumReferenceQueueStripes];
   // Reference queues used by the GC.
-  ReferenceQueue soft_reference_queue_;
-  ReferenceQueue weak_reference_queue_;
+  std::unique_ptr<ReferenceQueue> soft_reference_queues_[kNumReferenceQueueStripes];
+  std::unique_ptr<ReferenceQueue> weak_reference_queues_[kNumReferenceQueueStripes];
   ReferenceQueue finalizer_reference_queue_;
   ReferenceQueue phantom_reference_queue_;
   ReferenceQueue cleared_references_;
 
+  friend class ReferenceProcessorTest;
+
   DISALLOW_COPY_AND_ASSIGN(ReferenceProcessor);
 };
 
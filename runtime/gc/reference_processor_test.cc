@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reference_processor.h"
+
+#include <sched.h>
+
+#include <set>
+
+#include "atomic.h"
+#include "common_runtime_test.h"
+#include "gc/collector/garbage_collector.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/reference.h"
+#include "reference_queue.h"
+#include "scoped_thread_state_change.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace gc {
+
+// Collector which considers marked exactly the objects it is told about, and records whether the
+// reference processor asked it about a referent.
+class FakeCollector : public collector::GarbageCollector {
+ public:
+  explicit FakeCollector(Heap* heap) : GarbageCollector(heap, "fake collector"), queried_(false) {}
+
+  void SetMarked(mirror::Object* obj) {
+    marked_.insert(obj);
+  }
+
+  bool WasQueried() const {
+    return queried_.LoadSequentiallyConsistent();
+  }
+
+  collector::GcType GetGcType() const OVERRIDE {
+    return collector::kGcTypeFull;
+  }
+  CollectorType GetCollectorType() const OVERRIDE {
+    return kCollectorTypeCMS;
+  }
+  mirror::Object* IsMarked(mirror::Object* obj) OVERRIDE {
+    return (marked_.find(obj) != marked_.end()) ? obj : nullptr;
+  }
+  bool IsMarkedHeapReference(mirror::HeapReference<mirror::Object>* obj) OVERRIDE {
+    queried_.StoreSequentiallyConsistent(true);
+    return IsMarked(obj->AsMirrorPtr()) != nullptr;
+  }
+  void ProcessMarkStack() OVERRIDE {}
+  mirror::Object* MarkObject(mirror::Object* obj) OVERRIDE {
+    SetMarked(obj);
+    return obj;
+  }
+  void MarkHeapReference(mirror::HeapReference<mirror::Object>* obj) OVERRIDE {
+    SetMarked(obj->AsMirrorPtr());
+  }
+  void DelayReferenceReferent(mirror::Class*, mirror::Reference*) OVERRIDE {}
+  void VisitRoots(mirror::Object***, size_t, const RootInfo&) OVERRIDE {}
+  void VisitRoots(mirror::CompressedReference<mirror::Object>**, size_t, const RootInfo&)
+      OVERRIDE {}
+
+ protected:
+  void RunPhases() OVERRIDE {}
+  void RevokeAllThreadLocalBuffers() OVERRIDE {}
+
+ private:
+  std::set<mirror::Object*> marked_;
+  Atomic<bool> queried_;
+};
+
+class ReferenceProcessorTest : public CommonRuntimeTest {
+ protected:
+  // Put `processor` in the state it is in once concurrent marking by `collector` is complete.
+  static void StartClearingReferences(ReferenceProcessor* processor,
+                                      collector::GarbageCollector* collector)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    processor->EnableSlowPath();
+    MutexLock mu(self, *Locks::reference_processor_lock_);
+    processor->collector_ = collector;
+    processor->clearing_references_ = true;
+  }
+
+  // Finish reference processing and wake up the mutators blocked in GetReferent.
+  static void FinishProcessingReferences(ReferenceProcessor* processor)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    MutexLock mu(self, *Locks::reference_processor_lock_);
+    processor->collector_ = nullptr;
+    processor->clearing_references_ = false;
+    processor->DisableSlowPath(self);
+  }
+
+  // Finish reference processing once the collector was asked about a referent, that is once a
+  // mutator is about to block in GetReferent.
+  class FinishProcessingReferencesTask : public Task {
+   public:
+    FinishProcessingReferencesTask(ReferenceProcessor* processor, FakeCollector* collector)
+        : processor_(processor), collector_(collector) {}
+
+    void Run(Thread* self) OVERRIDE {
+      while (!collector_->WasQueried()) {
+        sched_yield();
+      }
+      // The mutator holds the reference processor lock until it blocks.
+      ScopedObjectAccess soa(self);
+      FinishProcessingReferences(processor_);
+    }
+
+   private:
+    ReferenceProcessor* const processor_;
+    FakeCollector* const collector_;
+  };
+
+  mirror::Class* FindWeakReferenceClass(Thread* self) SHARED_REQUIRES(Locks::mutator_lock_) {
+    return class_linker_->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                    ScopedNullHandle<mirror::ClassLoader>());
+  }
+};
+
+TEST_F(ReferenceProcessorTest, DiscoveredWhiteReferentIsCleared) {
+  if (kUseReadBarrier) {
+    // The concurrent copying collector blocks GetReferent through weak ref access instead.
+    return;
+  }
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<4> hs(self);
+  Handle<mirror::Class> ref_class(hs.NewHandle(FindWeakReferenceClass(self)));
+  ASSERT_TRUE(ref_class.Get() != nullptr);
+  Handle<mirror::Reference> ref(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref.Get() != nullptr);
+  Handle<mirror::Object> referent(hs.NewHandle(ref_class->AllocObject(self)));
+  ASSERT_TRUE(referent.Get() != nullptr);
+  ref->SetReferent<false>(referent.Get());
+
+  // Discover the reference, as the collector would while marking.
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue(&lock);
+  queue.EnqueueReference(ref.Get());
+  ASSERT_FALSE(ref->IsUnprocessed());
+
+  FakeCollector collector(Runtime::Current()->GetHeap());
+  ReferenceProcessor processor;
+  StartClearingReferences(&processor, &collector);
+  // The referent is white and about to be cleared, so it is returned as cleared without blocking.
+  EXPECT_TRUE(processor.GetReferent(self, ref.Get()) == nullptr);
+  // A marked referent is returned.
+  collector.SetMarked(referent.Get());
+  EXPECT_EQ(referent.Get(), processor.GetReferent(self, ref.Get()));
+  FinishProcessingReferences(&processor);
+  queue.DequeuePendingReference();
+}
+
+TEST_F(ReferenceProcessorTest, UndiscoveredLiveReferentIsNotCleared) {
+  if (kUseReadBarrier) {
+    // The concurrent copying collector blocks GetReferent through weak ref access instead.
+    return;
+  }
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Reference processor test thread pool", 1);
+  ScopedObjectAccess soa(self);
+  StackHandleScope<4> hs(self);
+  Handle<mirror::Class> ref_class(hs.NewHandle(FindWeakReferenceClass(self)));
+  ASSERT_TRUE(ref_class.Get() != nullptr);
+
+  FakeCollector collector(Runtime::Current()->GetHeap());
+  ReferenceProcessor processor;
+  StartClearingReferences(&processor, &collector);
+
+  // Create the reference and its referent after marking. The referent is held live by a handle,
+  // but is not marked, like an object that is only on the allocation stack.
+  Handle<mirror::Reference> ref(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref.Get() != nullptr);
+  Handle<mirror::Object> referent(hs.NewHandle(ref_class->AllocObject(self)));
+  ASSERT_TRUE(referent.Get() != nullptr);
+  ref->SetReferent<false>(referent.Get());
+  ASSERT_TRUE(ref->IsUnprocessed());
+
+  // GetReferent must block until reference processing is done instead of returning null.
+  FinishProcessingReferencesTask task(&processor, &collector);
+  thread_pool.AddTask(self, &task);
+  thread_pool.StartWorkers(self);
+  EXPECT_EQ(referent.Get(), processor.GetReferent(self, ref.Get()));
+  EXPECT_TRUE(collector.WasQueried());
+  thread_pool.Wait(self, false, true);
+  EXPECT_EQ(referent.Get(), processor.GetReferent(self, ref.Get()));
+}
+
+}  // namespace gc
+}  // namespace art
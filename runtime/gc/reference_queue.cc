@@ -52,6 +52,22 @@ void ReferenceQueue::EnqueueReference(mirror::Reference* ref) {
   list_->SetPendingNext(ref);
 }
 
+void ReferenceQueue::EnqueueQueue(ReferenceQueue* other) {
+  DCHECK(other != nullptr);
+  if (other->IsEmpty()) {
+    return;
+  }
+  if (IsEmpty()) {
+    list_ = other->list_;
+  } else {
+    // Swapping the successors of one reference of each cycle joins the two cycles.
+    mirror::Reference* head = list_->GetPendingNext();
+    list_->SetPendingNext(other->list_->GetPendingNext());
+    other->list_->SetPendingNext(head);
+  }
+  other->list_ = nullptr;
+}
+
 mirror::Reference* ReferenceQueue::DequeuePendingReference() {
   DCHECK(!IsEmpty());
   mirror::Reference* ref = list_->GetPendingNext();
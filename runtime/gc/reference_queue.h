@@ -61,6 +61,9 @@ class ReferenceQueue {
   // Not thread safe, used when mutators are paused to minimize lock overhead.
   void EnqueueReference(mirror::Reference* ref) SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Move all the references of `other` to this queue, leaving `other` empty. Not thread safe.
+  void EnqueueQueue(ReferenceQueue* other) SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Dequeue a reference from the queue and return that dequeued reference.
   mirror::Reference* DequeuePendingReference() SHARED_REQUIRES(Locks::mutator_lock_);
 
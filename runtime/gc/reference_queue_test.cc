@@ -59,6 +59,45 @@ TEST_F(ReferenceQueueTest, EnqueueDequeue) {
   ASSERT_EQ(refs, dequeued);
 }
 
+TEST_F(ReferenceQueueTest, EnqueueQueue) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<20> hs(self);
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue1(&lock);
+  ReferenceQueue queue2(&lock);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class.Get() != nullptr);
+  auto ref1(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref1.Get() != nullptr);
+  auto ref2(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref2.Get() != nullptr);
+  auto ref3(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref3.Get() != nullptr);
+
+  // Moving an empty queue is a no-op.
+  queue1.EnqueueQueue(&queue2);
+  ASSERT_TRUE(queue1.IsEmpty());
+  queue2.EnqueueReference(ref1.Get());
+  queue1.EnqueueQueue(&queue2);
+  ASSERT_TRUE(queue2.IsEmpty());
+  ASSERT_EQ(queue1.GetLength(), 1U);
+  queue2.EnqueueReference(ref2.Get());
+  queue2.EnqueueReference(ref3.Get());
+  queue1.EnqueueQueue(&queue2);
+  ASSERT_TRUE(queue2.IsEmpty());
+  ASSERT_EQ(queue1.GetLength(), 3U);
+
+  std::set<mirror::Reference*> refs = {ref1.Get(), ref2.Get(), ref3.Get()};
+  std::set<mirror::Reference*> dequeued;
+  while (!queue1.IsEmpty()) {
+    dequeued.insert(queue1.DequeuePendingReference());
+  }
+  ASSERT_EQ(refs, dequeued);
+}
+
 TEST_F(ReferenceQueueTest, Dump) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
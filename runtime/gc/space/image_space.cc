@@ -35,7 +35,9 @@
 #include "mirror/object-inl.h"
 #include "oat_file.h"
 #include "os.h"
+#include "scoped_thread_state_change.h"
 #include "space-inl.h"
+#include "thread_pool.h"
 #include "utils.h"
 
 namespace art {
@@ -939,14 +941,138 @@ class FixupArtFieldVisitor : public FixupVisitor, public ArtFieldVisitor {
   }
 };
 
+// Runs a function on a worker of the image loading thread pool.
+template <typename Function>
+class ImageLoadingTask FINAL : public Task {
+ public:
+  explicit ImageLoadingTask(Function function) : function_(function) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) OVERRIDE {
+    function_();
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  Function function_;
+};
+
+// Runs `function` on the image loading thread pool if there is one, or right away otherwise.
+template <typename Function>
+static void RunImageLoadingTask(ThreadPool* thread_pool, Function function) {
+  if (thread_pool == nullptr) {
+    function();
+  } else {
+    thread_pool->AddTask(Thread::Current(), new ImageLoadingTask<Function>(function));
+  }
+}
+
+// Borrows the runtime's image loading thread pool on first use, and gives it back when the image
+// is loaded.
+class ImageLoadingThreadPool {
+ public:
+  ImageLoadingThreadPool() : acquired_(false) {}
+
+  ~ImageLoadingThreadPool() {
+    if (thread_pool_ != nullptr) {
+      Runtime::Current()->ReleaseImageLoadingThreadPool(Thread::Current(), std::move(thread_pool_));
+    }
+  }
+
+  // Returns null if the workers cannot attach to the runtime yet, which is the case while loading
+  // the boot image, if another thread is loading an image with the pool, or if the pool is
+  // disabled with -XX:ImageLoadingThreads=0.
+  ThreadPool* Get() {
+    Thread* const self = Thread::Current();
+    if (!acquired_ && self != nullptr) {
+      acquired_ = true;
+      // Waiting for the workers to attach is not allowed while holding the mutator lock.
+      ScopedThreadStateChange tsc(self, kNative);
+      thread_pool_ = Runtime::Current()->AcquireImageLoadingThreadPool(self);
+    }
+    return thread_pool_.get();
+  }
+
+ private:
+  bool acquired_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImageLoadingThreadPool);
+};
+
+// Decompress an image stored with kStorageModeLZ4Blocks from the image file mapped at file_begin
+// into the image mapped at image_begin, one task per block.
+static bool DecompressImageBlocks(const ImageHeader& image_header,
+                                  uint8_t* image_begin,
+                                  const uint8_t* file_begin,
+                                  ImageLoadingThreadPool* thread_pool,
+                                  std::string* error_msg) {
+  if (!image_header.HasValidBlocks()) {
+    *error_msg = "Invalid image block index";
+    return false;
+  }
+  // The blocks must cover the image data without overlapping, and their stored data must be in
+  // the file.
+  const ImageBlock* const blocks = image_header.GetBlocks(file_begin);
+  const size_t blocks_count = image_header.GetBlocksCount();
+  const uint64_t data_end = sizeof(ImageHeader) + image_header.GetDataSize();
+  uint64_t image_offset = sizeof(ImageHeader);
+  for (size_t i = 0; i < blocks_count; ++i) {
+    const ImageBlock& block = blocks[i];
+    if (block.GetImageOffset() != image_offset ||
+        static_cast<uint64_t>(block.GetDataOffset()) + block.GetDataSize() > data_end) {
+      *error_msg = StringPrintf("Invalid image block %zu", i);
+      return false;
+    }
+    image_offset += block.GetImageSize();
+  }
+  if (image_offset != image_header.GetImageSize()) {
+    *error_msg = StringPrintf("Image blocks end at %" PRIu64 " instead of %zu",
+                              image_offset,
+                              image_header.GetImageSize());
+    return false;
+  }
+
+  // Decompression does not touch managed objects, let the GC run meanwhile.
+  Thread* const self = Thread::Current();
+  ScopedThreadStateChange tsc(self, kNative);
+  ThreadPool* const pool = (blocks_count > 1u) ? thread_pool->Get() : nullptr;
+  std::unique_ptr<std::string[]> block_error_msgs(new std::string[blocks_count]);
+  std::unique_ptr<bool[]> block_decompressed(new bool[blocks_count]);
+  for (size_t i = 0; i < blocks_count; ++i) {
+    RunImageLoadingTask(pool, [=, &block_error_msgs, &block_decompressed]() {
+      block_decompressed[i] = blocks[i].Decompress(image_begin, file_begin, &block_error_msgs[i]);
+    });
+  }
+  if (pool != nullptr) {
+    pool->StartWorkers(self);
+    pool->Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+    pool->StopWorkers(self);
+  }
+  for (size_t i = 0; i < blocks_count; ++i) {
+    if (!block_decompressed[i]) {
+      *error_msg = StringPrintf("Failed to decompress image block %zu: %s",
+                                i,
+                                block_error_msgs[i].c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
 // Relocate an image space mapped at target_base which possibly used to be at a different base
 // address. Only needs a single image space, not one for both source and destination.
 // In place means modifying a single ImageSpace in place rather than relocating from one ImageSpace
 // to another.
+// The native ArtMethods, ArtFields and IMTs are fixed up on the image loading thread pool, if
+// any, while the calling thread fixes up the objects.
 static bool RelocateInPlace(ImageHeader& image_header,
                             uint8_t* target_base,
                             accounting::ContinuousSpaceBitmap* bitmap,
                             const OatFile* app_oat_file,
+                            ImageLoadingThreadPool* thread_pool,
                             std::string* error_msg) {
   DCHECK(error_msg != nullptr);
   if (!image_header.IsPic()) {
@@ -1023,6 +1149,36 @@ static bool RelocateInPlace(ImageHeader& image_header,
   uintptr_t objects_begin = reinterpret_cast<uintptr_t>(target_base + objects_section.Offset());
   uintptr_t objects_end = reinterpret_cast<uintptr_t>(target_base + objects_section.End());
   FixupObjectAdapter fixup_adapter(boot_image, boot_oat, app_image, app_oat);
+  // The native sections do not overlap with the objects or with each other, and fixing them up
+  // does not read any object contents, so they are fixed up concurrently with the objects.
+  // The tasks do not record timings since the logger is not thread safe.
+  ThreadPool* const pool = thread_pool->Get();
+  FixupArtMethodVisitor method_visitor(fixup_image,
+                                       pointer_size,
+                                       boot_image,
+                                       boot_oat,
+                                       app_image,
+                                       app_oat);
+  FixupArtFieldVisitor field_visitor(boot_image, boot_oat, app_image, app_oat);
+  {
+    // Only touches objects in the app image, no need for mutator lock.
+    TimingLogger::ScopedTiming timing("Fixup native sections", &logger);
+    RunImageLoadingTask(pool, [&]() {
+      image_header.VisitPackedArtMethods(&method_visitor, target_base, pointer_size);
+    });
+    if (fixup_image) {
+      RunImageLoadingTask(pool, [&]() {
+        image_header.VisitPackedArtFields(&field_visitor, target_base);
+      });
+      RunImageLoadingTask(pool, [&]() {
+        image_header.VisitPackedImTables(fixup_adapter, target_base, pointer_size);
+        image_header.VisitPackedImtConflictTables(fixup_adapter, target_base, pointer_size);
+      });
+    }
+  }
+  if (pool != nullptr) {
+    pool->StartWorkers(Thread::Current());
+  }
   if (fixup_image) {
     // Two pass approach, fix up all classes first, then fix up non class-objects.
     // The visited bitmap is used to ensure that pointer arrays are not forwarded twice.
@@ -1099,32 +1255,13 @@ static bool RelocateInPlace(ImageHeader& image_header,
       }
     }
   }
-  {
-    // Only touches objects in the app image, no need for mutator lock.
-    TimingLogger::ScopedTiming timing("Fixup methods", &logger);
-    FixupArtMethodVisitor method_visitor(fixup_image,
-                                         pointer_size,
-                                         boot_image,
-                                         boot_oat,
-                                         app_image,
-                                         app_oat);
-    image_header.VisitPackedArtMethods(&method_visitor, target_base, pointer_size);
+  if (pool != nullptr) {
+    TimingLogger::ScopedTiming timing("Wait for native sections", &logger);
+    // The caller may hold the mutator lock, which the workers do not need.
+    pool->Wait(Thread::Current(), /* do_work */ true, /* may_hold_locks */ true);
+    pool->StopWorkers(Thread::Current());
   }
   if (fixup_image) {
-    {
-      // Only touches objects in the app image, no need for mutator lock.
-      TimingLogger::ScopedTiming timing("Fixup fields", &logger);
-      FixupArtFieldVisitor field_visitor(boot_image, boot_oat, app_image, app_oat);
-      image_header.VisitPackedArtFields(&field_visitor, target_base);
-    }
-    {
-      TimingLogger::ScopedTiming timing("Fixup imt", &logger);
-      image_header.VisitPackedImTables(fixup_adapter, target_base, pointer_size);
-    }
-    {
-      TimingLogger::ScopedTiming timing("Fixup conflict tables", &logger);
-      image_header.VisitPackedImtConflictTables(fixup_adapter, target_base, pointer_size);
-    }
     // In the app image case, the image methods are actually in the boot image.
     image_header.RelocateImageMethods(boot_image.Delta());
     const auto& class_table_section = image_header.GetImageSection(ImageHeader::kSectionClassTable);
@@ -1231,6 +1368,9 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
     addresses.push_back(nullptr);
   }
 
+  // Used to decompress blocks and relocate the image in parallel.
+  ImageLoadingThreadPool thread_pool;
+
   // Note: The image header is part of the image due to mmap page alignment required of offset.
   std::unique_ptr<MemMap> map;
   std::string temp_error_msg;
@@ -1253,7 +1393,8 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
                                          /*out*/out_error_msg));
     } else {
       if (storage_mode != ImageHeader::kStorageModeLZ4 &&
-          storage_mode != ImageHeader::kStorageModeLZ4HC) {
+          storage_mode != ImageHeader::kStorageModeLZ4HC &&
+          storage_mode != ImageHeader::kStorageModeLZ4Blocks) {
         *error_msg = StringPrintf("Invalid storage mode in image header %d",
                                   static_cast<int>(storage_mode));
         return nullptr;
@@ -1283,20 +1424,33 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
         }
         memcpy(map->Begin(), image_header, sizeof(ImageHeader));
         const uint64_t start = NanoTime();
-        // LZ4HC and LZ4 have same internal format, both use LZ4_decompress.
-        TimingLogger::ScopedTiming timing2("LZ4 decompress image", &logger);
-        const size_t decompressed_size = LZ4_decompress_safe(
-            reinterpret_cast<char*>(temp_map->Begin()) + sizeof(ImageHeader),
-            reinterpret_cast<char*>(map->Begin()) + decompress_offset,
-            stored_size,
-            map->Size() - decompress_offset);
-        VLOG(image) << "Decompressing image took " << PrettyDuration(NanoTime() - start);
-        if (decompressed_size + sizeof(ImageHeader) != image_header->GetImageSize()) {
-          *error_msg = StringPrintf(
-              "Decompressed size does not match expected image size %zu vs %zu",
-              decompressed_size + sizeof(ImageHeader),
-              image_header->GetImageSize());
-          return nullptr;
+        if (storage_mode == ImageHeader::kStorageModeLZ4Blocks) {
+          TimingLogger::ScopedTiming timing2("LZ4 decompress image blocks", &logger);
+          if (!DecompressImageBlocks(*image_header,
+                                     map->Begin(),
+                                     temp_map->Begin(),
+                                     &thread_pool,
+                                     error_msg)) {
+            return nullptr;
+          }
+          VLOG(image) << "Decompressing " << image_header->GetBlocksCount() << " image blocks took "
+                      << PrettyDuration(NanoTime() - start);
+        } else {
+          // LZ4HC and LZ4 have same internal format, both use LZ4_decompress.
+          TimingLogger::ScopedTiming timing2("LZ4 decompress image", &logger);
+          const size_t decompressed_size = LZ4_decompress_safe(
+              reinterpret_cast<char*>(temp_map->Begin()) + sizeof(ImageHeader),
+              reinterpret_cast<char*>(map->Begin()) + decompress_offset,
+              stored_size,
+              map->Size() - decompress_offset);
+          VLOG(image) << "Decompressing image took " << PrettyDuration(NanoTime() - start);
+          if (decompressed_size + sizeof(ImageHeader) != image_header->GetImageSize()) {
+            *error_msg = StringPrintf(
+                "Decompressed size does not match expected image size %zu vs %zu",
+                decompressed_size + sizeof(ImageHeader),
+                image_header->GetImageSize());
+            return nullptr;
+          }
         }
       }
     }
@@ -1356,6 +1510,7 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
                          map->Begin(),
                          bitmap.get(),
                          oat_file,
+                         &thread_pool,
                          error_msg)) {
       return nullptr;
     }
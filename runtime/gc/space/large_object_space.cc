@@ -255,7 +255,7 @@ bool LargeObjectMapSpace::Contains(const mirror::Object* obj) const {
 // allocation info pointer.
 class AllocationInfo {
  public:
-  AllocationInfo() : prev_free_(0), alloc_size_(0) {
+  AllocationInfo() : prev_free_(0), alloc_size_(0), next_free_slot_(0), prev_free_slot_(0) {
   }
   // Return the number of pages that the allocation info covers.
   size_t AlignSize() const {
@@ -315,6 +315,20 @@ class AllocationInfo {
     DCHECK_ALIGNED(bytes, FreeListSpace::kAlignment);
     prev_free_ = bytes / FreeListSpace::kAlignment;
   }
+  // Return the slot of the next and previous headers following a free block in the same size
+  // class, 0 if none. Slot 0 never follows a free block.
+  uint32_t GetNextFreeSlot() const {
+    return next_free_slot_;
+  }
+  uint32_t GetPrevFreeSlot() const {
+    return prev_free_slot_;
+  }
+  void SetNextFreeSlot(uint32_t slot) {
+    next_free_slot_ = slot;
+  }
+  void SetPrevFreeSlot(uint32_t slot) {
+    prev_free_slot_ = slot;
+  }
 
  private:
   static constexpr uint32_t kFlagFree = 0x80000000;  // If block is free.
@@ -326,6 +340,9 @@ class AllocationInfo {
   uint32_t prev_free_;
   // Allocation size of this object in kAlignment as the unit.
   uint32_t alloc_size_;
+  // Links of the free block size class list, only valid if prev_free_ is not 0.
+  uint32_t next_free_slot_;
+  uint32_t prev_free_slot_;
 };
 
 size_t FreeListSpace::GetSlotIndexForAllocationInfo(const AllocationInfo* info) const {
@@ -342,13 +359,16 @@ const AllocationInfo* FreeListSpace::GetAllocationInfoForAddress(uintptr_t addre
   return &allocation_info_[GetSlotIndexForAddress(address)];
 }
 
-inline bool FreeListSpace::SortByPrevFree::operator()(const AllocationInfo* a,
-                                                      const AllocationInfo* b) const {
-  if (a->GetPrevFree() < b->GetPrevFree()) return true;
-  if (a->GetPrevFree() > b->GetPrevFree()) return false;
-  if (a->AlignSize() < b->AlignSize()) return true;
-  if (a->AlignSize() > b->AlignSize()) return false;
-  return reinterpret_cast<uintptr_t>(a) < reinterpret_cast<uintptr_t>(b);
+inline void FreeListSpace::GetFreeListClass(size_t pages, size_t* fl, size_t* sl) {
+  DCHECK_NE(pages, 0U);
+  if (pages < kNumFreeListSubclasses) {
+    *fl = 0;
+    *sl = pages;
+  } else {
+    const size_t msb = MostSignificantBit(pages);
+    *fl = msb - kFreeListSubclassBits + 1;
+    *sl = (pages >> (msb - kFreeListSubclassBits)) - kNumFreeListSubclasses;
+  }
 }
 
 FreeListSpace* FreeListSpace::Create(const std::string& name, uint8_t* requested_begin, size_t size) {
@@ -363,7 +383,10 @@ FreeListSpace* FreeListSpace::Create(const std::string& name, uint8_t* requested
 FreeListSpace::FreeListSpace(const std::string& name, MemMap* mem_map, uint8_t* begin, uint8_t* end)
     : LargeObjectSpace(name, begin, end),
       mem_map_(mem_map),
-      lock_("free list space lock", kAllocSpaceLock) {
+      lock_("free list space lock", kAllocSpaceLock),
+      free_list_bitmap_(0),
+      free_list_subclass_bitmaps_(),
+      free_list_heads_() {
   const size_t space_capacity = end - begin;
   free_end_ = space_capacity;
   CHECK_ALIGNED(space_capacity, kAlignment);
@@ -398,12 +421,72 @@ void FreeListSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg) {
   CHECK_EQ(cur_info, end_info);
 }
 
+void FreeListSpace::InsertFreePrev(AllocationInfo* info) {
+  DCHECK_GT(info->GetPrevFree(), 0U);
+  size_t fl, sl;
+  GetFreeListClass(info->GetPrevFree(), &fl, &sl);
+  const uint32_t slot = GetSlotIndexForAllocationInfo(info);
+  DCHECK_NE(slot, 0U);
+  const uint32_t head = free_list_heads_[fl][sl];
+  info->SetPrevFreeSlot(0);
+  info->SetNextFreeSlot(head);
+  if (head != 0) {
+    allocation_info_[head].SetPrevFreeSlot(slot);
+  }
+  free_list_heads_[fl][sl] = slot;
+  free_list_subclass_bitmaps_[fl] |= 1u << sl;
+  free_list_bitmap_ |= 1u << fl;
+}
+
 void FreeListSpace::RemoveFreePrev(AllocationInfo* info) {
   CHECK_GT(info->GetPrevFree(), 0U);
-  auto it = free_blocks_.lower_bound(info);
-  CHECK(it != free_blocks_.end());
-  CHECK_EQ(*it, info);
-  free_blocks_.erase(it);
+  size_t fl, sl;
+  GetFreeListClass(info->GetPrevFree(), &fl, &sl);
+  const uint32_t prev = info->GetPrevFreeSlot();
+  const uint32_t next = info->GetNextFreeSlot();
+  if (prev != 0) {
+    allocation_info_[prev].SetNextFreeSlot(next);
+  } else {
+    DCHECK_EQ(free_list_heads_[fl][sl], GetSlotIndexForAllocationInfo(info));
+    free_list_heads_[fl][sl] = next;
+    if (next == 0) {
+      free_list_subclass_bitmaps_[fl] &= ~(1u << sl);
+      if (free_list_subclass_bitmaps_[fl] == 0) {
+        free_list_bitmap_ &= ~(1u << fl);
+      }
+    }
+  }
+  if (next != 0) {
+    allocation_info_[next].SetPrevFreeSlot(prev);
+  }
+}
+
+AllocationInfo* FreeListSpace::FindFreePrev(size_t pages) {
+  // Round the request up to the next size class, so that any free block of the class found fits.
+  size_t rounded_pages = pages;
+  if (pages >= kNumFreeListSubclasses) {
+    rounded_pages += (static_cast<size_t>(1) << (MostSignificantBit(pages) -
+                                                 kFreeListSubclassBits)) - 1;
+  }
+  size_t fl, sl;
+  GetFreeListClass(rounded_pages, &fl, &sl);
+  if (fl < kNumFreeListClasses) {
+    uint32_t subclasses = free_list_subclass_bitmaps_[fl] & (~0u << sl);
+    if (subclasses == 0) {
+      const uint32_t classes = free_list_bitmap_ & (~0u << (fl + 1));
+      if (classes != 0) {
+        fl = CTZ(classes);
+        subclasses = free_list_subclass_bitmaps_[fl];
+      }
+    }
+    if (subclasses != 0) {
+      sl = CTZ(subclasses);
+      AllocationInfo* info = &allocation_info_[free_list_heads_[fl][sl]];
+      DCHECK_GE(info->GetPrevFree(), pages);
+      return info;
+    }
+  }
+  return nullptr;
 }
 
 size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
@@ -450,7 +533,7 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
       new_free_info = next_info;
     }
     new_free_info->SetPrevFreeBytes(new_free_size);
-    free_blocks_.insert(new_free_info);
+    InsertFreePrev(new_free_info);
     info->SetByteSize(new_free_size, true);
     DCHECK_EQ(info->GetNextInfo(), new_free_info);
   }
@@ -480,15 +563,27 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
                                      size_t* usable_size, size_t* bytes_tl_bulk_allocated) {
   MutexLock mu(self, lock_);
   const size_t allocation_size = RoundUp(num_bytes, kAlignment);
-  AllocationInfo temp_info;
-  temp_info.SetPrevFreeBytes(allocation_size);
-  temp_info.SetByteSize(0, false);
+  const size_t allocation_pages = allocation_size / kAlignment;
   AllocationInfo* new_info;
-  // Find the smallest chunk at least num_bytes in size.
-  auto it = free_blocks_.lower_bound(&temp_info);
-  if (it != free_blocks_.end()) {
-    AllocationInfo* info = *it;
-    free_blocks_.erase(it);
+  // Find a free chunk of the smallest size class that is guaranteed to fit num_bytes. If there is
+  // none, free chunks of the size class of num_bytes may still fit, but are only searched once the
+  // free space at the end of the space is exhausted.
+  AllocationInfo* info = FindFreePrev(allocation_pages);
+  if (info == nullptr && free_end_ < allocation_size) {
+    size_t fl, sl;
+    GetFreeListClass(allocation_pages, &fl, &sl);
+    if (fl < kNumFreeListClasses) {
+      for (uint32_t slot = free_list_heads_[fl][sl]; slot != 0;
+           slot = allocation_info_[slot].GetNextFreeSlot()) {
+        if (allocation_info_[slot].GetPrevFree() >= allocation_pages) {
+          info = &allocation_info_[slot];
+          break;
+        }
+      }
+    }
+  }
+  if (info != nullptr) {
+    RemoveFreePrev(info);
     // Fit our object in the previous allocation info free space.
     new_info = info->GetPrevFreeInfo();
     // Remove the newly allocated block from the info and update the prev_free_.
@@ -497,8 +592,8 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
       AllocationInfo* new_free = info - info->GetPrevFree();
       new_free->SetPrevFreeBytes(0);
       new_free->SetByteSize(info->GetPrevFreeBytes(), true);
-      // If there is remaining space, insert back into the free set.
-      free_blocks_.insert(info);
+      // If there is remaining space, insert back into the free block index.
+      InsertFreePrev(info);
     }
   } else {
     // Try to steal some memory from the free space at the end of the space.
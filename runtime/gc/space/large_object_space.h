@@ -22,7 +22,6 @@
 #include "safe_map.h"
 #include "space.h"
 
-#include <set>
 #include <vector>
 
 namespace art {
@@ -187,17 +186,25 @@ class FreeListSpace FINAL : public LargeObjectSpace {
   uintptr_t GetAddressForAllocationInfo(const AllocationInfo* info) const {
     return GetAllocationAddressForSlot(GetSlotIndexForAllocationInfo(info));
   }
-  // Removes header from the free blocks set by finding the corresponding iterator and erasing it.
+  // Adds the header following a free block to the free block index.
+  void InsertFreePrev(AllocationInfo* info) REQUIRES(lock_);
+  // Removes the header following a free block from the free block index. Must be called before
+  // the size of the free block changes.
   void RemoveFreePrev(AllocationInfo* info) REQUIRES(lock_);
+  // Returns the header following a free block of at least `pages` pages, or null if there is none.
+  AllocationInfo* FindFreePrev(size_t pages) REQUIRES(lock_);
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const OVERRIDE;
   void SetAllLargeObjectsAsZygoteObjects(Thread* self) OVERRIDE REQUIRES(!lock_);
 
-  class SortByPrevFree {
-   public:
-    bool operator()(const AllocationInfo* a, const AllocationInfo* b) const;
-  };
-  typedef std::set<AllocationInfo*, SortByPrevFree,
-                   TrackingAllocator<AllocationInfo*, kAllocatorTagLOSFreeList>> FreeBlocks;
+  // Free blocks are segregated by size, as in TLSF: the first level index is the power of two of
+  // the size of the block in pages, and the second level splits each power of two range linearly
+  // in kNumFreeListSubclasses. Each size class keeps a list of its free blocks, and bitmaps of the
+  // non-empty classes make finding a free block of a given size constant time.
+  static constexpr size_t kFreeListSubclassBits = 3;
+  static constexpr size_t kNumFreeListSubclasses = 1u << kFreeListSubclassBits;
+  // Enough classes for the largest size an AllocationInfo can hold, 2^30 - 1 pages.
+  static constexpr size_t kNumFreeListClasses = 28;
+  static void GetFreeListClass(size_t pages, size_t* fl, size_t* sl);
 
   // There is not footer for any allocations at the end of the space, so we keep track of how much
   // free space there is at the end manually.
@@ -209,7 +216,12 @@ class FreeListSpace FINAL : public LargeObjectSpace {
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   // Free bytes at the end of the space.
   size_t free_end_ GUARDED_BY(lock_);
-  FreeBlocks free_blocks_ GUARDED_BY(lock_);
+  // Bit fl is set if there are free blocks in first level class fl, and bit sl of
+  // free_list_subclass_bitmaps_[fl] if there are free blocks in class (fl, sl).
+  uint32_t free_list_bitmap_ GUARDED_BY(lock_);
+  uint32_t free_list_subclass_bitmaps_[kNumFreeListClasses] GUARDED_BY(lock_);
+  // Slot of the first header following a free block of each class, 0 if the class is empty.
+  uint32_t free_list_heads_[kNumFreeListClasses][kNumFreeListSubclasses] GUARDED_BY(lock_);
 };
 
 }  // namespace space
@@ -29,6 +29,8 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
   void RaceTest();
+
+  void BufferChurnTest();
 };
 
 
@@ -164,6 +166,54 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+// Keep replacing randomly chosen live objects of 12KB to 1MB, like services allocating byte[]
+// buffers do. The replacements allocate many times the capacity of the free list space, so the
+// freed memory has to be reused, and it has to be coalesced again once all objects are freed.
+void LargeObjectSpaceTest::BufferChurnTest() {
+  static constexpr size_t kNumLiveObjects = 64;
+  static constexpr size_t kNumReplacements = 20000;
+  static constexpr size_t kMinAllocationSize = 12 * KB;
+  static constexpr size_t kMaxAllocationSize = 1 * MB;
+  size_t rand_seed = 0;
+  Thread* const self = Thread::Current();
+  for (size_t los_type = 0; los_type < 2; ++los_type) {
+    std::unique_ptr<LargeObjectSpace> los;
+    if (los_type == 0) {
+      los.reset(space::LargeObjectMapSpace::Create("large object space"));
+    } else {
+      los.reset(space::FreeListSpace::Create("large object space", nullptr, 128 * MB));
+    }
+
+    std::vector<mirror::Object*> objects(kNumLiveObjects, nullptr);
+    for (size_t i = 0; i < kNumReplacements; ++i) {
+      mirror::Object*& obj = objects[test_rand(&rand_seed) % kNumLiveObjects];
+      if (obj != nullptr) {
+        los->Free(self, obj);
+      }
+      size_t request_size = kMinAllocationSize +
+          test_rand(&rand_seed) % (kMaxAllocationSize - kMinAllocationSize);
+      size_t allocation_size, bytes_tl_bulk_allocated;
+      obj = los->Alloc(self, request_size, &allocation_size, nullptr, &bytes_tl_bulk_allocated);
+      ASSERT_TRUE(obj != nullptr);
+      ASSERT_GE(allocation_size, request_size);
+    }
+
+    for (mirror::Object* obj : objects) {
+      if (obj != nullptr) {
+        los->Free(self, obj);
+      }
+    }
+    EXPECT_EQ(0U, los->GetBytesAllocated());
+    EXPECT_EQ(0U, los->GetObjectsAllocated());
+    // Checks that all the free blocks were coalesced.
+    size_t bytes_allocated, bytes_tl_bulk_allocated;
+    mirror::Object* obj = los->Alloc(self, 100 * MB, &bytes_allocated, nullptr,
+                                     &bytes_tl_bulk_allocated);
+    EXPECT_TRUE(obj != nullptr);
+    los->Free(self, obj);
+  }
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
@@ -172,6 +222,10 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, BufferChurnTest) {
+  BufferChurnTest();
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -92,6 +92,8 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes, size_t* by
         Region* r = &regions_[i];
         if (r->IsFree()) {
           r->Unfree(time_);
+          // The objects evacuated into the region are promoted.
+          r->SetOld();
           ++num_non_free_regions_;
           obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
           CHECK(obj != nullptr);
@@ -222,7 +224,7 @@ uint64_t RegionSpace::GetObjectsAllocatedInternal() {
   return bytes;
 }
 
-template<bool kToSpaceOnly>
+template<bool kToSpaceOnly, bool kNewOnly>
 void RegionSpace::WalkInternal(ObjectCallback* callback, void* arg) {
   // TODO: MutexLock on region_lock_ won't work due to lock order
   // issues (the classloader classes lock and the monitor lock). We
@@ -230,7 +232,8 @@ void RegionSpace::WalkInternal(ObjectCallback* callback, void* arg) {
   Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
   for (size_t i = 0; i < num_regions_; ++i) {
     Region* r = &regions_[i];
-    if (r->IsFree() || (kToSpaceOnly && !r->IsInToSpace())) {
+    if (r->IsFree() || (kToSpaceOnly && !r->IsInToSpace()) ||
+        (kNewOnly && r->AllocTime() != time_)) {
       continue;
     }
     if (r->IsLarge()) {
@@ -299,12 +302,18 @@ mirror::Object* RegionSpace::AllocLarge(size_t num_bytes, size_t* bytes_allocate
       Region* first_reg = &regions_[left];
       DCHECK(first_reg->IsFree());
       first_reg->UnfreeLarge(time_);
+      if (kForEvac) {
+        first_reg->SetOld();
+      }
       ++num_non_free_regions_;
       first_reg->SetTop(first_reg->Begin() + num_bytes);
       for (size_t p = left + 1; p < right; ++p) {
         DCHECK_LT(p, num_regions_);
         DCHECK(regions_[p].IsFree());
         regions_[p].UnfreeLargeTail(time_);
+        if (kForEvac) {
+          regions_[p].SetOld();
+        }
         ++num_non_free_regions_;
       }
       *bytes_allocated = num_bytes;
@@ -24,12 +24,9 @@ namespace art {
 namespace gc {
 namespace space {
 
-// If a region has live objects whose size is less than this percent
-// value of the region size, evaculate the region.
-static constexpr uint kEvaculateLivePercentThreshold = 75U;
-
 RegionSpace* RegionSpace::Create(const std::string& name, size_t capacity,
-                                 uint8_t* requested_begin) {
+                                 uint8_t* requested_begin,
+                                 uint32_t evacuate_live_percent_threshold) {
   capacity = RoundUp(capacity, kRegionSize);
   std::string error_msg;
   std::unique_ptr<MemMap> mem_map(MemMap::MapAnonymous(name.c_str(), requested_begin, capacity,
@@ -41,13 +38,16 @@ RegionSpace* RegionSpace::Create(const std::string& name, size_t capacity,
     MemMap::DumpMaps(LOG(ERROR));
     return nullptr;
   }
-  return new RegionSpace(name, mem_map.release());
+  return new RegionSpace(name, mem_map.release(), evacuate_live_percent_threshold);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap* mem_map)
+RegionSpace::RegionSpace(const std::string& name, MemMap* mem_map,
+                         uint32_t evacuate_live_percent_threshold)
     : ContinuousMemMapAllocSpace(name, mem_map, mem_map->Begin(), mem_map->End(), mem_map->End(),
                                  kGcRetentionPolicyAlwaysCollect),
-      region_lock_("Region lock", kRegionSpaceRegionLock), time_(1U) {
+      region_lock_("Region lock", kRegionSpaceRegionLock),
+      evacuate_live_percent_threshold_(evacuate_live_percent_threshold), time_(1U) {
+  CHECK_LE(evacuate_live_percent_threshold, 100U);
   size_t mem_map_size = mem_map->Size();
   CHECK_ALIGNED(mem_map_size, kRegionSize);
   CHECK_ALIGNED(mem_map->Begin(), kRegionSize);
@@ -115,7 +115,30 @@ size_t RegionSpace::ToSpaceSize() {
   return num_regions * kRegionSize;
 }
 
-inline bool RegionSpace::Region::ShouldBeEvacuated() {
+size_t RegionSpace::OldSpaceSize() {
+  uint64_t num_regions = 0;
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (!r->IsFree() && r->IsOld()) {
+      ++num_regions;
+    }
+  }
+  return num_regions * kRegionSize;
+}
+
+void RegionSpace::GetOldRegionRanges(std::vector<std::pair<uint8_t*, uint8_t*>>* ranges) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree() || !r->IsOld() || r->IsLargeTail()) {
+      continue;
+    }
+    ranges->push_back(std::make_pair(r->Begin(), r->Top()));
+  }
+}
+
+inline bool RegionSpace::Region::ShouldBeEvacuated(uint32_t evacuate_live_percent_threshold) {
   DCHECK((IsAllocated() || IsLarge()) && IsInToSpace());
   // if the region was allocated after the start of the
   // previous GC or the live ratio is below threshold, evacuate
@@ -131,7 +154,7 @@ inline bool RegionSpace::Region::ShouldBeEvacuated() {
         // Side node: live_percent == 0 does not necessarily mean
         // there's no live objects due to rounding (there may be a
         // few).
-        result = live_percent < kEvaculateLivePercentThreshold;
+        result = live_percent < evacuate_live_percent_threshold;
       } else {
         DCHECK(IsLarge());
         result = live_percent == 0U;
@@ -145,7 +168,9 @@ inline bool RegionSpace::Region::ShouldBeEvacuated() {
 
 // Determine which regions to evacuate and mark them as
 // from-space. Mark the rest as unevacuated from-space.
-void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all) {
+void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all,
+                               bool young_gen) {
+  DCHECK(!(force_evacuate_all && young_gen));
   ++time_;
   if (kUseTableLookupReadBarrier) {
     DCHECK(rb_table->IsAllCleared());
@@ -160,11 +185,26 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
     RegionType type = r->Type();
     if (!r->IsFree()) {
       DCHECK(r->IsInToSpace());
+      if (young_gen) {
+        // Evacuate all the young regions, large tails included, as the references to their live
+        // objects from the old regions are only known through the card table. The old regions
+        // stay in the to-space and are not traced.
+        if (r->IsOld()) {
+          if (kUseTableLookupReadBarrier) {
+            rb_table->Clear(r->Begin(), r->End());
+          }
+        } else {
+          r->SetAsFromSpace();
+          DCHECK(r->IsInFromSpace());
+        }
+        continue;
+      }
       if (LIKELY(num_expected_large_tails == 0U)) {
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = force_evacuate_all || r->ShouldBeEvacuated();
+        bool should_evacuate = force_evacuate_all ||
+            r->ShouldBeEvacuated(evacuate_live_percent_threshold_);
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
@@ -202,15 +242,35 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
   evac_region_ = &full_region_;
 }
 
-void RegionSpace::ClearFromSpace() {
+void RegionSpace::ClearFromSpace(uint64_t* cleared_bytes, uint64_t* cleared_objects) {
+  DCHECK(cleared_bytes != nullptr);
+  DCHECK(cleared_objects != nullptr);
+  *cleared_bytes = 0;
+  *cleared_objects = 0;
   MutexLock mu(Thread::Current(), region_lock_);
+  bool prev_large_cleared = false;
   for (size_t i = 0; i < num_regions_; ++i) {
     Region* r = &regions_[i];
     if (r->IsInFromSpace()) {
       r->Clear();
       --num_non_free_regions_;
     } else if (r->IsInUnevacFromSpace()) {
-      r->SetUnevacFromSpaceAsToSpace();
+      // The live bytes of a large object are recorded in its first region only, so the large
+      // tails follow it.
+      bool has_no_live_objects = r->IsLargeTail() ? prev_large_cleared : r->LiveBytes() == 0U;
+      if (r->IsLarge()) {
+        prev_large_cleared = has_no_live_objects;
+      }
+      if (has_no_live_objects) {
+        // Nothing survived in this region, free it now rather than evacuating it next time.
+        *cleared_bytes += r->BytesAllocated();
+        *cleared_objects += r->ObjectsAllocated();
+        r->Clear();
+        --num_non_free_regions_;
+      } else {
+        r->SetUnevacFromSpaceAsToSpace();
+        r->SetOld();
+      }
     }
   }
   evac_region_ = nullptr;
@@ -413,7 +473,8 @@ void RegionSpace::Region::Dump(std::ostream& os) const {
      << " state=" << static_cast<uint>(state_) << " type=" << static_cast<uint>(type_)
      << " objects_allocated=" << objects_allocated_
      << " alloc_time=" << alloc_time_ << " live_bytes=" << live_bytes_
-     << " is_newly_allocated=" << is_newly_allocated_ << " is_a_tlab=" << is_a_tlab_ << " thread=" << thread_ << "\n";
+     << " is_newly_allocated=" << is_newly_allocated_ << " is_old=" << is_old_
+     << " is_a_tlab=" << is_a_tlab_ << " thread=" << thread_ << "\n";
 }
 
 }  // namespace space
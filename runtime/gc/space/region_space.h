@@ -38,7 +38,10 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   // Create a region space with the requested sizes. The requested base address is not
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
-  static RegionSpace* Create(const std::string& name, size_t capacity, uint8_t* requested_begin);
+  // Regions whose live objects take less than evacuate_live_percent_threshold percent of the
+  // region size are evacuated. The others are left in place as unevacuated from-space.
+  static RegionSpace* Create(const std::string& name, size_t capacity, uint8_t* requested_begin,
+                             uint32_t evacuate_live_percent_threshold);
 
   // Allocate num_bytes, returns null if the space is full.
   mirror::Object* Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
@@ -151,12 +154,19 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   // Go through all of the blocks and visit the continuous objects.
   void Walk(ObjectCallback* callback, void* arg)
       REQUIRES(Locks::mutator_lock_) {
-    WalkInternal<false>(callback, arg);
+    WalkInternal<false, false>(callback, arg);
   }
 
   void WalkToSpace(ObjectCallback* callback, void* arg)
       REQUIRES(Locks::mutator_lock_) {
-    WalkInternal<true>(callback, arg);
+    WalkInternal<true, false>(callback, arg);
+  }
+
+  // Walk the to-space regions allocated since the last SetFromSpace(), that is, skip the old
+  // regions that a young collection leaves in the to-space without tracing them.
+  void WalkNewToSpace(ObjectCallback* callback, void* arg)
+      REQUIRES(Locks::mutator_lock_) {
+    WalkInternal<true, true>(callback, arg);
   }
 
   accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() OVERRIDE {
@@ -202,13 +212,26 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     return RegionType::kRegionTypeNone;
   }
 
-  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all)
+  // If young_gen is true, only the regions that are not old are evacuated and the old regions
+  // stay in the to-space.
+  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all,
+                    bool young_gen)
       REQUIRES(!region_lock_);
 
   size_t FromSpaceSize() REQUIRES(!region_lock_);
   size_t UnevacFromSpaceSize() REQUIRES(!region_lock_);
   size_t ToSpaceSize() REQUIRES(!region_lock_);
-  void ClearFromSpace() REQUIRES(!region_lock_);
+  size_t OldSpaceSize() REQUIRES(!region_lock_);
+  // Free the from-space regions and the unevacuated from-space regions that have no live objects,
+  // and return the bytes and objects allocated in the latter. The other unevacuated from-space
+  // regions become to-space regions.
+  void ClearFromSpace(uint64_t* cleared_bytes, uint64_t* cleared_objects)
+      REQUIRES(!region_lock_);
+
+  // Append the allocated [begin, top) range of each old region to ranges. A large region's range
+  // covers its large tails.
+  void GetOldRegionRanges(std::vector<std::pair<uint8_t*, uint8_t*>>* ranges)
+      REQUIRES(!region_lock_);
 
   void AddLiveBytes(mirror::Object* ref, size_t alloc_size) {
     Region* reg = RefToRegionUnlocked(ref);
@@ -225,9 +248,9 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   }
 
  private:
-  RegionSpace(const std::string& name, MemMap* mem_map);
+  RegionSpace(const std::string& name, MemMap* mem_map, uint32_t evacuate_live_percent_threshold);
 
-  template<bool kToSpaceOnly>
+  template<bool kToSpaceOnly, bool kNewOnly>
   void WalkInternal(ObjectCallback* callback, void* arg) NO_THREAD_SAFETY_ANALYSIS;
 
   class Region {
@@ -237,13 +260,13 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
           begin_(nullptr), top_(nullptr), end_(nullptr),
           state_(RegionState::kRegionStateAllocated), type_(RegionType::kRegionTypeToSpace),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {}
+          is_newly_allocated_(false), is_old_(false), is_a_tlab_(false), thread_(nullptr) {}
 
     Region(size_t idx, uint8_t* begin, uint8_t* end)
         : idx_(idx), begin_(begin), top_(begin), end_(end),
           state_(RegionState::kRegionStateFree), type_(RegionType::kRegionTypeNone),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {
+          is_newly_allocated_(false), is_old_(false), is_a_tlab_(false), thread_(nullptr) {
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
     }
@@ -268,6 +291,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       }
       madvise(begin_, end_ - begin_, MADV_DONTNEED);
       is_newly_allocated_ = false;
+      is_old_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
     }
@@ -312,6 +336,21 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       is_newly_allocated_ = true;
     }
 
+    // Old regions hold objects that survived a collection, either evacuated into the region or
+    // left in an unevacuated region.
+    bool IsOld() const {
+      return is_old_;
+    }
+
+    void SetOld() {
+      DCHECK(!IsFree());
+      is_old_ = true;
+    }
+
+    uint32_t AllocTime() const {
+      return alloc_time_;
+    }
+
     // Non-large, non-large-tail allocated.
     bool IsAllocated() const {
       return state_ == RegionState::kRegionStateAllocated;
@@ -372,7 +411,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       type_ = RegionType::kRegionTypeToSpace;
     }
 
-    ALWAYS_INLINE bool ShouldBeEvacuated();
+    ALWAYS_INLINE bool ShouldBeEvacuated(uint32_t evacuate_live_percent_threshold);
 
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(IsInUnevacFromSpace());
@@ -472,6 +511,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     uint32_t alloc_time_;          // The allocation time of the region.
     size_t live_bytes_;            // The live bytes. Used to compute the live percent.
     bool is_newly_allocated_;      // True if it's allocated after the last collection.
+    bool is_old_;                  // True if it holds survivors of a collection.
     bool is_a_tlab_;               // True if it's a tlab.
     Thread* thread_;               // The owning thread if it's a tlab.
 
@@ -510,6 +550,8 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
 
   Mutex region_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
+  // Regions whose live percent is below this are evacuated.
+  const uint32_t evacuate_live_percent_threshold_;
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   size_t num_non_free_regions_;    // The number of non-free regions in this space.
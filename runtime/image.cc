@@ -16,7 +16,10 @@
 
 #include "image.h"
 
+#include <lz4.h>
+
 #include "base/bit_utils.h"
+#include "base/stringprintf.h"
 #include "mirror/object_array.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object-inl.h"
@@ -24,7 +27,7 @@
 namespace art {
 
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-const uint8_t ImageHeader::kImageVersion[] = { '0', '3', '0', '\0' };
+const uint8_t ImageHeader::kImageVersion[] = { '0', '3', '1', '\0' };
 
 ImageHeader::ImageHeader(uint32_t image_begin,
                          uint32_t image_size,
@@ -61,7 +64,9 @@ ImageHeader::ImageHeader(uint32_t image_begin,
     compile_pic_(compile_pic),
     is_pic_(is_pic),
     storage_mode_(storage_mode),
-    data_size_(data_size) {
+    data_size_(data_size),
+    blocks_offset_(0),
+    blocks_count_(0) {
   CHECK_EQ(image_begin, RoundUp(image_begin, kPageSize));
   CHECK_EQ(oat_file_begin, RoundUp(oat_file_begin, kPageSize));
   CHECK_EQ(oat_data_begin, RoundUp(oat_data_begin, kPageSize));
@@ -123,6 +128,12 @@ bool ImageHeader::IsValid() const {
   return true;
 }
 
+bool ImageHeader::HasValidBlocks() const {
+  const uint64_t blocks_end =
+      blocks_offset_ + static_cast<uint64_t>(blocks_count_) * sizeof(ImageBlock);
+  return blocks_offset_ >= sizeof(ImageHeader) && blocks_end <= sizeof(ImageHeader) + data_size_;
+}
+
 const char* ImageHeader::GetMagic() const {
   CHECK(IsValid());
   return reinterpret_cast<const char*>(magic_);
@@ -179,4 +190,21 @@ void ImageHeader::VisitPackedArtMethods(ArtMethodVisitor* visitor,
   }
 }
 
+bool ImageBlock::Decompress(uint8_t* image_begin,
+                            const uint8_t* file_begin,
+                            std::string* error_msg) const {
+  const int decompressed_size = LZ4_decompress_safe(
+      reinterpret_cast<const char*>(file_begin) + data_offset_,
+      reinterpret_cast<char*>(image_begin) + image_offset_,
+      data_size_,
+      image_size_);
+  if (decompressed_size < 0 || static_cast<uint32_t>(decompressed_size) != image_size_) {
+    *error_msg = StringPrintf("Decompressed size does not match expected block size %d vs %u",
+                              decompressed_size,
+                              image_size_);
+    return false;
+  }
+  return true;
+}
+
 }  // namespace art
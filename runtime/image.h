@@ -69,6 +69,46 @@ class PACKED(4) ImageSection {
   uint32_t size_;
 };
 
+// A part of the image data compressed independently from the others, so that blocks can be
+// decompressed in parallel. Data offsets are relative to the start of the image file, image
+// offsets to the start of the uncompressed image.
+class PACKED(4) ImageBlock {
+ public:
+  ImageBlock() : data_offset_(0), data_size_(0), image_offset_(0), image_size_(0) { }
+  ImageBlock(uint32_t data_offset, uint32_t data_size, uint32_t image_offset, uint32_t image_size)
+      : data_offset_(data_offset),
+        data_size_(data_size),
+        image_offset_(image_offset),
+        image_size_(image_size) { }
+  ImageBlock(const ImageBlock& block) = default;
+  ImageBlock& operator=(const ImageBlock& block) = default;
+
+  uint32_t GetDataOffset() const {
+    return data_offset_;
+  }
+
+  uint32_t GetDataSize() const {
+    return data_size_;
+  }
+
+  uint32_t GetImageOffset() const {
+    return image_offset_;
+  }
+
+  uint32_t GetImageSize() const {
+    return image_size_;
+  }
+
+  // Decompress the block from the image file mapped at file_begin into the image at image_begin.
+  bool Decompress(uint8_t* image_begin, const uint8_t* file_begin, std::string* error_msg) const;
+
+ private:
+  uint32_t data_offset_;
+  uint32_t data_size_;
+  uint32_t image_offset_;
+  uint32_t image_size_;
+};
+
 // header of image files written by ImageWriter, read and validated by Space.
 class PACKED(4) ImageHeader {
  public:
@@ -76,10 +116,14 @@ class PACKED(4) ImageHeader {
     kStorageModeUncompressed,
     kStorageModeLZ4,
     kStorageModeLZ4HC,
+    kStorageModeLZ4Blocks,  // LZ4 compressed blocks of kBlockSize, see ImageBlock.
     kStorageModeCount,  // Number of elements in enum.
   };
   static constexpr StorageMode kDefaultStorageMode = kStorageModeUncompressed;
 
+  // Size of the uncompressed image data in each block for kStorageModeLZ4Blocks.
+  static constexpr size_t kBlockSize = 256 * KB;
+
   ImageHeader()
       : image_begin_(0U),
         image_size_(0U),
@@ -98,7 +142,9 @@ class PACKED(4) ImageHeader {
         compile_pic_(0),
         is_pic_(0),
         storage_mode_(kDefaultStorageMode),
-        data_size_(0) {}
+        data_size_(0),
+        blocks_offset_(0),
+        blocks_count_(0) {}
 
   ImageHeader(uint32_t image_begin,
               uint32_t image_size,
@@ -265,6 +311,19 @@ class PACKED(4) ImageHeader {
     return data_size_;
   }
 
+  uint32_t GetBlocksCount() const {
+    return blocks_count_;
+  }
+
+  // Returns the block index of an image stored with kStorageModeLZ4Blocks, read from the image
+  // file mapped at file_begin.
+  const ImageBlock* GetBlocks(const uint8_t* file_begin) const {
+    return reinterpret_cast<const ImageBlock*>(file_begin + blocks_offset_);
+  }
+
+  // Returns whether the block index is within the stored data.
+  bool HasValidBlocks() const;
+
   bool IsAppImage() const {
     // App images currently require a boot image, if the size is non zero then it is an app image
     // header.
@@ -358,6 +417,11 @@ class PACKED(4) ImageHeader {
   // is the compressed size in the file.
   uint32_t data_size_;
 
+  // File offset and number of entries of the block index, for kStorageModeLZ4Blocks. The index is
+  // part of the stored data, before the compressed blocks.
+  uint32_t blocks_offset_;
+  uint32_t blocks_count_;
+
   friend class ImageWriter;
 };
 
@@ -62,6 +62,9 @@ void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   if ((flags & kVisitRootFlagAllRoots) != 0) {
     strong_interns_.VisitRoots(visitor);
+    for (GcRoot<mirror::String>& root : strong_cache_) {
+      root.VisitRootIfNonNull(visitor, RootInfo(kRootInternedString));
+    }
   } else if ((flags & kVisitRootFlagNewRoots) != 0) {
     for (auto& root : new_strong_intern_roots_) {
       mirror::String* old_ref = root.Read<kWithoutReadBarrier>();
@@ -73,6 +76,8 @@ void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
         // concurrent moving GC.
         strong_interns_.Remove(old_ref);
         strong_interns_.Insert(new_ref);
+        // The cache may still refer to the old location.
+        ClearStrongCache();
       }
     }
   }
@@ -87,14 +92,51 @@ void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
   // Note: we deliberately don't visit the weak_interns_ table and the immutable image roots.
 }
 
+template <typename Key>
+mirror::String* InternTable::LookupStrongCached(const Key& key, int32_t hash) {
+  const size_t index = static_cast<uint32_t>(hash) & (kStrongCacheSize - 1);
+  // Read the entry once, as it may be replaced concurrently.
+  mirror::String* cached = strong_cache_[index].Read();
+  if (cached == nullptr) {
+    return nullptr;
+  }
+  // Pairs with the release fence in AddToStrongCache(), so that the contents of the string
+  // are visible.
+  QuasiAtomic::ThreadFenceAcquire();
+  if (cached->GetHashCode() != hash || !StringHashEquals()(GcRoot<mirror::String>(cached), key)) {
+    return nullptr;
+  }
+  return cached;
+}
+
+void InternTable::AddToStrongCache(mirror::String* s) {
+  QuasiAtomic::ThreadFenceRelease();
+  strong_cache_[static_cast<uint32_t>(s->GetHashCode()) & (kStrongCacheSize - 1)] =
+      GcRoot<mirror::String>(s);
+}
+
+void InternTable::ClearStrongCache() {
+  for (GcRoot<mirror::String>& root : strong_cache_) {
+    root = GcRoot<mirror::String>();
+  }
+}
+
 mirror::String* InternTable::LookupWeak(Thread* self, mirror::String* s) {
   MutexLock mu(self, *Locks::intern_table_lock_);
   return LookupWeakLocked(s);
 }
 
 mirror::String* InternTable::LookupStrong(Thread* self, mirror::String* s) {
+  mirror::String* cached = LookupStrongCached(GcRoot<mirror::String>(s), s->GetHashCode());
+  if (cached != nullptr) {
+    return cached;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return LookupStrongLocked(s);
+  mirror::String* strong = LookupStrongLocked(s);
+  if (strong != nullptr) {
+    AddToStrongCache(strong);
+  }
+  return strong;
 }
 
 mirror::String* InternTable::LookupStrong(Thread* self,
@@ -104,8 +146,16 @@ mirror::String* InternTable::LookupStrong(Thread* self,
   Utf8String string(utf16_length,
                     utf8_data,
                     ComputeUtf16HashFromModifiedUtf8(utf8_data, utf16_length));
+  mirror::String* cached = LookupStrongCached(string, string.GetHash());
+  if (cached != nullptr) {
+    return cached;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(string);
+  mirror::String* strong = strong_interns_.Find(string);
+  if (strong != nullptr) {
+    AddToStrongCache(strong);
+  }
+  return strong;
 }
 
 mirror::String* InternTable::LookupWeakLocked(mirror::String* s) {
@@ -145,6 +195,7 @@ mirror::String* InternTable::InsertWeak(mirror::String* s) {
 
 void InternTable::RemoveStrong(mirror::String* s) {
   strong_interns_.Remove(s);
+  ClearStrongCache();
 }
 
 void InternTable::RemoveWeak(mirror::String* s) {
@@ -257,6 +308,11 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool hold
   if (s == nullptr) {
     return nullptr;
   }
+  // Most strings being interned are already strong interns. Look them up without the lock.
+  mirror::String* cached = LookupStrongCached(GcRoot<mirror::String>(s), s->GetHashCode());
+  if (cached != nullptr) {
+    return cached;
+  }
   Thread* const self = Thread::Current();
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking && !holding_locks) {
@@ -274,6 +330,7 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool hold
     // Check the strong table for a match.
     mirror::String* strong = LookupStrongLocked(s);
     if (strong != nullptr) {
+      AddToStrongCache(strong);
       return strong;
     }
     if ((!kUseReadBarrier && weak_root_state_ != gc::kWeakRootStateNoReadsOrWrites) ||
@@ -260,6 +260,14 @@ class InternTable {
   void WaitUntilAccessible(Thread* self)
       REQUIRES(Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Lock-free lookups in the cache of strong interns. Return null if not cached.
+  template <typename Key>
+  mirror::String* LookupStrongCached(const Key& key, int32_t hash)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  void AddToStrongCache(mirror::String* s)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+  void ClearStrongCache() REQUIRES(Locks::intern_table_lock_);
+
   bool images_added_to_intern_table_ GUARDED_BY(Locks::intern_table_lock_);
   bool log_new_roots_ GUARDED_BY(Locks::intern_table_lock_);
   ConditionVariable weak_intern_condition_ GUARDED_BY(Locks::intern_table_lock_);
@@ -277,6 +285,14 @@ class InternTable {
   // Weak root state, used for concurrent system weak processing and more.
   gc::WeakRootState weak_root_state_ GUARDED_BY(Locks::intern_table_lock_);
 
+  // Direct-mapped cache of strong interns, indexed by string hash, which is looked up without
+  // holding the intern table lock so that interning strings which are already strongly
+  // interned does not contend on it. Strong interns are only removed when rolling back a
+  // transaction, so a cached string stays the intern of its value. Entries are published with
+  // the intern table lock held, and are roots so that moving collectors update them.
+  static constexpr size_t kStrongCacheSize = 1024;
+  GcRoot<mirror::String> strong_cache_[kStrongCacheSize];
+
   friend class Transaction;
   DISALLOW_COPY_AND_ASSIGN(InternTable);
 };
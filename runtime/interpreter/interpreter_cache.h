@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/direct_mapped_cache.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class Instruction;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+namespace interpreter {
+
+// Inline caches for the virtual and interface invokes executed by the interpreter on one
+// thread, keyed by the address of the invoke instruction. Each entry remembers the receiver
+// class last seen at the invoke and the method it dispatched to, so that a monomorphic call
+// site can skip the vtable or IMT lookup.
+//
+// Since the receiver classes are not reported as roots, Thread::VisitRoots empties the cache
+// of its thread, before the GC gets a chance to move or unload them.
+class InterpreterCache {
+ public:
+  InterpreterCache() {}
+
+  // Return the method the invoke at `inst` dispatches to for receivers of class
+  // `klass`, or null if not cached.
+  ArtMethod* Get(const Instruction* inst, mirror::Class* klass) const {
+    const Entry& entry = cache_.GetEntry(IndexOf(inst));
+    return (entry.inst == inst && entry.klass == klass) ? entry.method : nullptr;
+  }
+
+  // Return the receiver class last cached for the invoke at `inst`, or null.
+  mirror::Class* GetClass(const Instruction* inst) const {
+    const Entry& entry = cache_.GetEntry(IndexOf(inst));
+    return (entry.inst == inst) ? entry.klass : nullptr;
+  }
+
+  void Set(const Instruction* inst, mirror::Class* klass, ArtMethod* method) {
+    Entry& entry = cache_.GetEntry(IndexOf(inst));
+    entry.inst = inst;
+    entry.klass = klass;
+    entry.method = method;
+  }
+
+  void Clear() {
+    cache_.Clear();
+  }
+
+  static constexpr size_t kSize = 256;
+
+ private:
+  struct Entry {
+    const Instruction* inst;
+    mirror::Class* klass;
+    ArtMethod* method;
+  };
+
+  static size_t IndexOf(const Instruction* inst) {
+    // Instructions are aligned on 16-bit code units.
+    return reinterpret_cast<uintptr_t>(inst) >> 1;
+  }
+
+  DirectMappedCache<Entry, kSize> cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterpreterCache);
+};
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
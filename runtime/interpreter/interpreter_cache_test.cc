@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter_cache.h"
+
+#include "art_method-inl.h"
+#include "common_runtime_test.h"
+#include "dex_instruction.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change.h"
+#include "thread-inl.h"
+
+namespace art {
+namespace interpreter {
+
+class InterpreterCacheTest : public CommonRuntimeTest {
+ protected:
+  class NoopRootVisitor : public SingleRootVisitor {
+   public:
+    void VisitRoot(mirror::Object* root ATTRIBUTE_UNUSED,
+                   const RootInfo& info ATTRIBUTE_UNUSED) OVERRIDE {}
+  };
+};
+
+TEST_F(InterpreterCacheTest, ReceiverClasses) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::Class* object_class = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  mirror::Class* string_class = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/String;");
+  ASSERT_TRUE(object_class != nullptr);
+  ASSERT_TRUE(string_class != nullptr);
+  ArtMethod* object_to_string =
+      object_class->FindVirtualMethod("toString", "()Ljava/lang/String;", sizeof(void*));
+  ASSERT_TRUE(object_to_string != nullptr);
+  ArtMethod* string_to_string =
+      string_class->FindVirtualMethod("toString", "()Ljava/lang/String;", sizeof(void*));
+  ASSERT_TRUE(string_to_string != nullptr);
+
+  InterpreterCache cache;
+  uint16_t code[InterpreterCache::kSize + 1] = {};
+  const Instruction* invoke = Instruction::At(code);
+  EXPECT_TRUE(cache.Get(invoke, object_class) == nullptr);
+
+  // The cache follows the last receiver class seen at the invoke.
+  cache.Set(invoke, object_class, object_to_string);
+  EXPECT_EQ(object_to_string, cache.Get(invoke, object_class));
+  EXPECT_TRUE(cache.Get(invoke, string_class) == nullptr);
+  cache.Set(invoke, string_class, string_to_string);
+  EXPECT_EQ(string_to_string, cache.Get(invoke, string_class));
+  EXPECT_TRUE(cache.Get(invoke, object_class) == nullptr);
+  EXPECT_EQ(string_class, cache.GetClass(invoke));
+
+  // An invoke sharing the entry replaces it.
+  const Instruction* other_invoke = Instruction::At(code + InterpreterCache::kSize);
+  cache.Set(other_invoke, object_class, object_to_string);
+  EXPECT_TRUE(cache.GetClass(invoke) == nullptr);
+  EXPECT_EQ(object_to_string, cache.Get(other_invoke, object_class));
+}
+
+TEST_F(InterpreterCacheTest, ClearedWhenThreadRootsAreVisited) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  mirror::Class* object_class = class_linker_->FindSystemClass(self, "Ljava/lang/Object;");
+  ASSERT_TRUE(object_class != nullptr);
+  ArtMethod* to_string =
+      object_class->FindVirtualMethod("toString", "()Ljava/lang/String;", sizeof(void*));
+  ASSERT_TRUE(to_string != nullptr);
+
+  uint16_t code[1] = {};
+  const Instruction* invoke = Instruction::At(code);
+  InterpreterCache* cache = self->GetInterpreterCache();
+  cache->Set(invoke, object_class, to_string);
+  ASSERT_EQ(to_string, cache->Get(invoke, object_class));
+
+  // The receiver class is not a root, so it must be gone once the GC visited the thread.
+  NoopRootVisitor visitor;
+  self->VisitRoots(&visitor);
+  EXPECT_TRUE(cache->Get(invoke, object_class) == nullptr);
+  EXPECT_TRUE(cache->GetClass(invoke) == nullptr);
+}
+
+}  // namespace interpreter
+}  // namespace art
@@ -631,8 +631,20 @@ static inline bool DoInvoke(Thread* self, ShadowFrame& shadow_frame, const Instr
   const uint32_t vregC = (is_range) ? inst->VRegC_3rc() : inst->VRegC_35c();
   Object* receiver = (type == kStatic) ? nullptr : shadow_frame.GetVRegReference(vregC);
   ArtMethod* sf_method = shadow_frame.GetMethod();
-  ArtMethod* const called_method = FindMethodFromCode<type, do_access_check>(
-      method_idx, &receiver, sf_method, self);
+  // Virtual and interface invokes first look for the receiver class in the inline cache.
+  // Calls with access checks are rare, so they do not use the cache.
+  constexpr bool use_inline_cache = (type == kVirtual || type == kInterface) && !do_access_check;
+  ArtMethod* called_method = nullptr;
+  if (use_inline_cache && LIKELY(receiver != nullptr)) {
+    called_method = self->GetInterpreterCache()->Get(inst, receiver->GetClass());
+  }
+  if (called_method == nullptr) {
+    called_method = FindMethodFromCode<type, do_access_check>(
+        method_idx, &receiver, sf_method, self);
+    if (use_inline_cache && called_method != nullptr && called_method->IsInvokable()) {
+      self->GetInterpreterCache()->Set(inst, receiver->GetClass(), called_method);
+    }
+  }
   // The shadow frame should already be pushed, so we don't need to update it.
   if (UNLIKELY(called_method == nullptr)) {
     CHECK(self->IsExceptionPending());
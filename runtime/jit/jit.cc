@@ -19,6 +19,8 @@
 #include <dlfcn.h>
 
 #include "art_method-inl.h"
+#include "base/casts.h"
+#include "base/time_utils.h"
 #include "debugger.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "interpreter/interpreter.h"
@@ -45,7 +47,7 @@ void* Jit::jit_library_handle_= nullptr;
 void* Jit::jit_compiler_handle_ = nullptr;
 void* (*Jit::jit_load_)(bool*) = nullptr;
 void (*Jit::jit_unload_)(void*) = nullptr;
-bool (*Jit::jit_compile_method_)(void*, ArtMethod*, Thread*, bool) = nullptr;
+bool (*Jit::jit_compile_method_)(void*, ArtMethod*, Thread*, bool, bool) = nullptr;
 void (*Jit::jit_types_loaded_)(void*, mirror::Class**, size_t count) = nullptr;
 bool Jit::generate_debug_info_ = false;
 
@@ -88,6 +90,17 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
     }
   }
 
+  if (options.Exists(RuntimeArgumentMap::JITOptimizeThreshold)) {
+    jit_options->optimize_threshold_ = *options.Get(RuntimeArgumentMap::JITOptimizeThreshold);
+    if (jit_options->optimize_threshold_ > std::numeric_limits<uint16_t>::max()) {
+      LOG(FATAL) << "Method optimize threshold is above its internal limit.";
+    } else if (jit_options->optimize_threshold_ <= jit_options->compile_threshold_) {
+      LOG(FATAL) << "Method optimize threshold must be above the compile threshold.";
+    }
+  } else {
+    jit_options->optimize_threshold_ = 0;
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
@@ -116,6 +129,11 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
         static_cast<size_t>(1));;
   }
 
+  jit_options->thread_pool_size_ = options.GetOrDefault(RuntimeArgumentMap::JITThreadPoolSize);
+  if (jit_options->thread_pool_size_ == 0) {
+    LOG(FATAL) << "JIT thread pool size cannot be 0.";
+  }
+
   return jit_options;
 }
 
@@ -126,6 +144,9 @@ bool Jit::ShouldUsePriorityThreadWeight() {
 
 void Jit::DumpInfo(std::ostream& os) {
   code_cache_->Dump(os);
+  if (thread_pool_ != nullptr) {
+    thread_pool_->DumpInfo(os);
+  }
   cumulative_timings_.Dump(os);
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
@@ -145,7 +166,8 @@ Jit::Jit() : dump_info_on_shutdown_(false),
              memory_use_("Memory used for compilation", 16),
              lock_("JIT memory use lock"),
              use_jit_compilation_(true),
-             save_profiling_info_(false) {}
+             save_profiling_info_(false),
+             thread_pool_size_(kDefaultThreadPoolSize) {}
 
 Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
   DCHECK(options->UseJitCompilation() || options->GetSaveProfilingInfo());
@@ -168,14 +190,20 @@ Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
       << PrettySize(options->GetCodeCacheInitialCapacity())
       << ", max_capacity=" << PrettySize(options->GetCodeCacheMaxCapacity())
       << ", compile_threshold=" << options->GetCompileThreshold()
+      << ", optimize_threshold=" << options->GetOptimizeThreshold()
+      << ", thread_pool_size=" << options->GetThreadPoolSize()
       << ", save_profiling_info=" << options->GetSaveProfilingInfo();
 
 
   jit->hot_method_threshold_ = options->GetCompileThreshold();
   jit->warm_method_threshold_ = options->GetWarmupThreshold();
   jit->osr_method_threshold_ = options->GetOsrThreshold();
+  jit->optimize_method_threshold_ = options->GetOptimizeThreshold();
   jit->priority_thread_weight_ = options->GetPriorityThreadWeight();
   jit->invoke_transition_weight_ = options->GetInvokeTransitionWeight();
+  // The compiler writes the perf map without synchronization, so only use one compiler
+  // thread when generating debug info.
+  jit->thread_pool_size_ = generate_debug_info_ ? 1u : options->GetThreadPoolSize();
 
   jit->CreateThreadPool();
 
@@ -206,7 +234,7 @@ bool Jit::LoadCompilerLibrary(std::string* error_msg) {
     *error_msg = "JIT couldn't find jit_unload entry point";
     return false;
   }
-  jit_compile_method_ = reinterpret_cast<bool (*)(void*, ArtMethod*, Thread*, bool)>(
+  jit_compile_method_ = reinterpret_cast<bool (*)(void*, ArtMethod*, Thread*, bool, bool)>(
       dlsym(jit_library_handle_, "jit_compile_method"));
   if (jit_compile_method_ == nullptr) {
     dlclose(jit_library_handle_);
@@ -240,7 +268,12 @@ bool Jit::LoadCompiler(std::string* error_msg) {
   return true;
 }
 
-bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
+static bool IsBaselineCompiled(ArtMethod* method) SHARED_REQUIRES(Locks::mutator_lock_) {
+  ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+  return info != nullptr && info->IsBaselineCompiled();
+}
+
+bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr) {
   DCHECK(Runtime::Current()->UseJitCompilation());
   DCHECK(!method->IsRuntimeMethod());
 
@@ -260,27 +293,190 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
   // If we get a request to compile a proxy method, we pass the actual Java method
   // of that proxy method, as the compiler does not expect a proxy method.
   ArtMethod* method_to_compile = method->GetInterfaceMethodIfProxy(sizeof(void*));
-  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, osr)) {
+  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, baseline, osr)) {
     return false;
   }
 
   VLOG(jit) << "Compiling method "
             << PrettyMethod(method_to_compile)
+            << " baseline=" << std::boolalpha << baseline
             << " osr=" << std::boolalpha << osr;
-  bool success = jit_compile_method_(jit_compiler_handle_, method_to_compile, self, osr);
+  bool success =
+      jit_compile_method_(jit_compiler_handle_, method_to_compile, self, baseline, osr);
   code_cache_->DoneCompiling(method_to_compile, self, osr);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << PrettyMethod(method_to_compile)
+              << " baseline=" << std::boolalpha << baseline
               << " osr=" << std::boolalpha << osr;
+  } else if (baseline && IsBaselineCompiled(method_to_compile)) {
+    // Baseline code increments the hotness counter on entry and requests an optimized
+    // compilation when the counter wraps around to zero. Set it so that this happens
+    // after `optimize_method_threshold_ - hot_method_threshold_` invocations.
+    // Architectures without hotness counting compile optimized code right away.
+    method_to_compile->SetCounter(
+        static_cast<int16_t>(hot_method_threshold_ - optimize_method_threshold_));
   }
   return success;
 }
 
+class JitCompileTask FINAL : public Task {
+ public:
+  enum TaskKind {
+    kAllocateProfile,
+    kCompileBaseline,
+    kCompile,
+    kCompileOsr
+  };
+
+  JitCompileTask(ArtMethod* method, TaskKind kind, int32_t priority = 0)
+      : method_(method), kind_(kind), priority_(priority), enqueue_time_ns_(0) {
+    ScopedObjectAccess soa(Thread::Current());
+    // Add a global ref to the class to prevent class unloading until compilation is done.
+    klass_ = soa.Vm()->AddGlobalRef(soa.Self(), method_->GetDeclaringClass());
+    CHECK(klass_ != nullptr);
+  }
+
+  ~JitCompileTask() {
+    ScopedObjectAccess soa(Thread::Current());
+    soa.Vm()->DeleteGlobalRef(soa.Self(), klass_);
+  }
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    if (kind_ == kCompileBaseline) {
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* baseline */ true, /* osr */ false);
+    } else if (kind_ == kCompile) {
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* baseline */ false, /* osr */ false);
+    } else if (kind_ == kCompileOsr) {
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* baseline */ false, /* osr */ true);
+    } else {
+      DCHECK(kind_ == kAllocateProfile);
+      if (ProfilingInfo::Create(self, method_, /* retry_allocation */ true)) {
+        VLOG(jit) << "Start profiling " << PrettyMethod(method_);
+      }
+    }
+    ProfileSaver::NotifyJitActivity();
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+  // Whether `other` asks for the same work as this task.
+  bool IsSameRequestAs(const JitCompileTask& other) const {
+    return method_ == other.method_ && kind_ == other.kind_;
+  }
+
+  int32_t GetPriority() const {
+    return priority_;
+  }
+
+  uint64_t GetEnqueueTime() const {
+    return enqueue_time_ns_;
+  }
+
+  void SetEnqueueTime(uint64_t time_ns) {
+    enqueue_time_ns_ = time_ns;
+  }
+
+ private:
+  ArtMethod* const method_;
+  const TaskKind kind_;
+  // The hotness of the method when the task was created. Higher priority tasks run first.
+  const int32_t priority_;
+  uint64_t enqueue_time_ns_;
+  jobject klass_;
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
+};
+
+// Thread pool running the JIT compile tasks. The queue is kept sorted by decreasing task
+// priority so that the hottest methods (and OSR requests, whose counters are past the OSR
+// threshold) are compiled before lukewarm ones. A request for a method already waiting in
+// the queue with the same kind is dropped; requests already running are filtered out by
+// JitCodeCache::NotifyCompilationOf.
+class JitThreadPool FINAL : public ThreadPool {
+ public:
+  JitThreadPool(const char* name, size_t num_threads)
+      : ThreadPool(name, num_threads),
+        wait_time_us_("JIT compile task wait time", 16),
+        max_queue_depth_(0),
+        dropped_tasks_(0) {}
+
+  // Takes ownership of `task`.
+  void AddTask(Thread* self, JitCompileTask* task) REQUIRES(!task_queue_lock_) {
+    bool dropped = false;
+    {
+      MutexLock mu(self, task_queue_lock_);
+      auto insert_pos = tasks_.end();
+      for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+        JitCompileTask* queued = down_cast<JitCompileTask*>(*it);
+        if (queued->IsSameRequestAs(*task)) {
+          dropped = true;
+          break;
+        }
+        if (insert_pos == tasks_.end() && queued->GetPriority() < task->GetPriority()) {
+          insert_pos = it;
+        }
+      }
+      if (!dropped) {
+        task->SetEnqueueTime(NanoTime());
+        tasks_.insert(insert_pos, task);
+        max_queue_depth_ = std::max(max_queue_depth_, tasks_.size());
+        // If we have any waiters, signal one.
+        if (started_ && waiting_count_ != 0) {
+          task_queue_condition_.Signal(self);
+        }
+      } else {
+        ++dropped_tasks_;
+      }
+    }
+    if (dropped) {
+      // Deleting the task releases its global reference, do it outside of the queue lock.
+      delete task;
+    }
+  }
+
+  void DumpInfo(std::ostream& os) REQUIRES(!task_queue_lock_) {
+    MutexLock mu(Thread::Current(), task_queue_lock_);
+    os << "JIT thread pool: " << GetThreadCount() << " threads"
+       << ", queue depth " << tasks_.size() << " (max " << max_queue_depth_ << ")"
+       << ", duplicate requests dropped " << dropped_tasks_ << "\n";
+    if (wait_time_us_.SampleSize() != 0) {
+      os << wait_time_us_.Name()
+         << ": Avg: " << PrettyDuration(static_cast<uint64_t>(wait_time_us_.Mean()) * 1000)
+         << " Max: " << PrettyDuration(wait_time_us_.Max() * 1000)
+         << " Min: " << PrettyDuration(wait_time_us_.Min() * 1000) << "\n";
+    }
+  }
+
+ protected:
+  Task* GetTask(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_) {
+    Task* task = ThreadPool::GetTask(self);
+    if (task != nullptr) {
+      uint64_t wait_time_ns = NanoTime() - down_cast<JitCompileTask*>(task)->GetEnqueueTime();
+      MutexLock mu(self, task_queue_lock_);
+      wait_time_us_.AddValue(wait_time_ns / 1000);
+    }
+    return task;
+  }
+
+ private:
+  Histogram<uint64_t> wait_time_us_ GUARDED_BY(task_queue_lock_);
+  size_t max_queue_depth_ GUARDED_BY(task_queue_lock_);
+  size_t dropped_tasks_ GUARDED_BY(task_queue_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitThreadPool);
+};
+
 void Jit::CreateThreadPool() {
   // There is a DCHECK in the 'AddSamples' method to ensure the tread pool
   // is not null when we instrument.
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1));
+  thread_pool_.reset(new JitThreadPool("Jit thread pool", thread_pool_size_));
   thread_pool_->SetPthreadPriority(kJitPoolThreadPthreadPriority);
   thread_pool_->StartWorkers(Thread::Current());
 }
@@ -289,7 +485,7 @@ void Jit::DeleteThreadPool() {
   Thread* self = Thread::Current();
   DCHECK(Runtime::Current()->IsShuttingDown(self));
   if (thread_pool_ != nullptr) {
-    ThreadPool* cache = nullptr;
+    JitThreadPool* cache = nullptr;
     {
       ScopedSuspendAll ssa(__FUNCTION__);
       // Clear thread_pool_ field while the threads are suspended.
@@ -540,53 +736,6 @@ void Jit::AddMemoryUsage(ArtMethod* method, size_t bytes) {
   memory_use_.AddValue(bytes);
 }
 
-class JitCompileTask FINAL : public Task {
- public:
-  enum TaskKind {
-    kAllocateProfile,
-    kCompile,
-    kCompileOsr
-  };
-
-  JitCompileTask(ArtMethod* method, TaskKind kind) : method_(method), kind_(kind) {
-    ScopedObjectAccess soa(Thread::Current());
-    // Add a global ref to the class to prevent class unloading until compilation is done.
-    klass_ = soa.Vm()->AddGlobalRef(soa.Self(), method_->GetDeclaringClass());
-    CHECK(klass_ != nullptr);
-  }
-
-  ~JitCompileTask() {
-    ScopedObjectAccess soa(Thread::Current());
-    soa.Vm()->DeleteGlobalRef(soa.Self(), klass_);
-  }
-
-  void Run(Thread* self) OVERRIDE {
-    ScopedObjectAccess soa(self);
-    if (kind_ == kCompile) {
-      Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ false);
-    } else if (kind_ == kCompileOsr) {
-      Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ true);
-    } else {
-      DCHECK(kind_ == kAllocateProfile);
-      if (ProfilingInfo::Create(self, method_, /* retry_allocation */ true)) {
-        VLOG(jit) << "Start profiling " << PrettyMethod(method_);
-      }
-    }
-    ProfileSaver::NotifyJitActivity();
-  }
-
-  void Finalize() OVERRIDE {
-    delete this;
-  }
-
- private:
-  ArtMethod* const method_;
-  const TaskKind kind_;
-  jobject klass_;
-
-  DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
-};
-
 void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_backedges) {
   if (thread_pool_ == nullptr) {
     // Should only see this when shutting down.
@@ -628,7 +777,8 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
       if (!success) {
         // We failed allocating. Instead of doing the collection on the Java thread, we push
         // an allocation to a compiler thread, that will do the collection.
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kAllocateProfile));
+        thread_pool_->AddTask(
+            self, new JitCompileTask(method, JitCompileTask::kAllocateProfile, new_count));
       }
     }
     // Avoid jumping more than one state at a time.
@@ -638,7 +788,10 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
       if ((new_count >= hot_method_threshold_) &&
           !code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
         DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kCompile));
+        JitCompileTask::TaskKind kind = UseTieredCompilation()
+            ? JitCompileTask::kCompileBaseline
+            : JitCompileTask::kCompile;
+        thread_pool_->AddTask(self, new JitCompileTask(method, kind, new_count));
       }
       // Avoid jumping more than one state at a time.
       new_count = std::min(new_count, osr_method_threshold_ - 1);
@@ -649,7 +802,8 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
       }
       if ((new_count >= osr_method_threshold_) &&  !code_cache_->IsOsrCompiled(method)) {
         DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kCompileOsr));
+        thread_pool_->AddTask(
+            self, new JitCompileTask(method, JitCompileTask::kCompileOsr, new_count));
       }
     }
   }
@@ -657,6 +811,19 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
   method->SetCounter(new_count);
 }
 
+void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
+  if (thread_pool_ == nullptr) {
+    // Should only see this when shutting down.
+    DCHECK(Runtime::Current()->IsShuttingDown(self));
+    return;
+  }
+  DCHECK(UseTieredCompilation());
+  // The counter has just wrapped around; optimized compilations are as important as
+  // requests for methods reaching the optimize threshold in the interpreter.
+  thread_pool_->AddTask(
+      self, new JitCompileTask(method, JitCompileTask::kCompile, optimize_method_threshold_));
+}
+
 void Jit::MethodEntered(Thread* thread, ArtMethod* method) {
   Runtime* runtime = Runtime::Current();
   if (UNLIKELY(runtime->UseJitCompilation() && runtime->GetJit()->JitAtFirstUse())) {
@@ -35,6 +35,7 @@ namespace jit {
 
 class JitCodeCache;
 class JitOptions;
+class JitThreadPool;
 
 static constexpr int16_t kJitCheckForOSR = -1;
 static constexpr int16_t kJitHotnessDisabled = -2;
@@ -45,10 +46,14 @@ class Jit {
   static constexpr size_t kDefaultCompileThreshold = kStressMode ? 2 : 10000;
   static constexpr size_t kDefaultPriorityThreadWeightRatio = 1000;
   static constexpr size_t kDefaultInvokeTransitionWeightRatio = 500;
+  static constexpr size_t kDefaultThreadPoolSize = 1;
 
   virtual ~Jit();
   static Jit* Create(JitOptions* options, std::string* error_msg);
-  bool CompileMethod(ArtMethod* method, Thread* self, bool osr)
+  // Compile `method`. If `baseline` is true, the compiler is asked for quickly generated
+  // code that requests an optimized compilation once it becomes hot, see
+  // EnqueueOptimizedCompilation.
+  bool CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr)
       SHARED_REQUIRES(Locks::mutator_lock_);
   void CreateThreadPool();
 
@@ -83,10 +88,24 @@ class Jit {
     return warm_method_threshold_;
   }
 
+  size_t OptimizeMethodThreshold() const {
+    return optimize_method_threshold_;
+  }
+
+  // Whether hot methods are first compiled with the baseline compiler, and recompiled
+  // with all optimizations once they reach the optimize threshold.
+  bool UseTieredCompilation() const {
+    return optimize_method_threshold_ != 0;
+  }
+
   uint16_t PriorityThreadWeight() const {
     return priority_thread_weight_;
   }
 
+  size_t ThreadPoolSize() const {
+    return thread_pool_size_;
+  }
+
   // Returns false if we only need to save profile information and not compile methods.
   bool UseJitCompilation() const {
     return use_jit_compilation_;
@@ -106,6 +125,11 @@ class Jit {
   void AddSamples(Thread* self, ArtMethod* method, uint16_t samples, bool with_backedges)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Called by baseline compiled code of `method` when it reaches the optimize threshold.
+  // Does not suspend.
+  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   void InvokeVirtualOrInterface(Thread* thread,
                                 mirror::Object* this_object,
                                 ArtMethod* caller,
@@ -177,7 +201,7 @@ class Jit {
   static void* jit_compiler_handle_;
   static void* (*jit_load_)(bool*);
   static void (*jit_unload_)(void*);
-  static bool (*jit_compile_method_)(void*, ArtMethod*, Thread*, bool);
+  static bool (*jit_compile_method_)(void*, ArtMethod*, Thread*, bool, bool);
   static void (*jit_types_loaded_)(void*, mirror::Class**, size_t count);
 
   // Performance monitoring.
@@ -194,9 +218,13 @@ class Jit {
   uint16_t hot_method_threshold_;
   uint16_t warm_method_threshold_;
   uint16_t osr_method_threshold_;
+  // Zero if tiered compilation is disabled.
+  uint16_t optimize_method_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
-  std::unique_ptr<ThreadPool> thread_pool_;
+  size_t thread_pool_size_;
+  // Compile tasks are ordered by hotness, see JitThreadPool in jit.cc.
+  std::unique_ptr<JitThreadPool> thread_pool_;
 
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
@@ -213,12 +241,18 @@ class JitOptions {
   size_t GetOsrThreshold() const {
     return osr_threshold_;
   }
+  size_t GetOptimizeThreshold() const {
+    return optimize_threshold_;
+  }
   uint16_t GetPriorityThreadWeight() const {
     return priority_thread_weight_;
   }
   size_t GetInvokeTransitionWeight() const {
     return invoke_transition_weight_;
   }
+  size_t GetThreadPoolSize() const {
+    return thread_pool_size_;
+  }
   size_t GetCodeCacheInitialCapacity() const {
     return code_cache_initial_capacity_;
   }
@@ -252,8 +286,10 @@ class JitOptions {
   size_t compile_threshold_;
   size_t warmup_threshold_;
   size_t osr_threshold_;
+  size_t optimize_threshold_;
   uint16_t priority_thread_weight_;
   size_t invoke_transition_weight_;
+  size_t thread_pool_size_;
   bool dump_info_on_shutdown_;
   bool save_profiling_info_;
 
@@ -262,6 +298,8 @@ class JitOptions {
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
         compile_threshold_(0),
+        optimize_threshold_(0),
+        thread_pool_size_(Jit::kDefaultThreadPoolSize),
         dump_info_on_shutdown_(false),
         save_profiling_info_(false) { }
 
@@ -27,6 +27,7 @@
 #include "gc/accounting/bitmap-inl.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "jit/jit.h"
+#include "jit/offline_profiling_info.h"
 #include "jit/profiling_info.h"
 #include "linear_alloc.h"
 #include "mem_map.h"
@@ -202,6 +203,7 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                   size_t fp_spill_mask,
                                   const uint8_t* code,
                                   size_t code_size,
+                                  bool baseline,
                                   bool osr) {
   uint8_t* result = CommitCodeInternal(self,
                                        method,
@@ -211,6 +213,7 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                        fp_spill_mask,
                                        code,
                                        code_size,
+                                       baseline,
                                        osr);
   if (result == nullptr) {
     // Retry.
@@ -223,6 +226,7 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                 fp_spill_mask,
                                 code,
                                 code_size,
+                                baseline,
                                 osr);
   }
   return result;
@@ -313,6 +317,7 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
                                           size_t fp_spill_mask,
                                           const uint8_t* code,
                                           size_t code_size,
+                                          bool baseline,
                                           bool osr) {
   size_t alignment = GetInstructionSetAlignment(kRuntimeISA);
   // Ensure the header ends up at expected instruction alignment.
@@ -356,6 +361,10 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
       number_of_osr_compilations_++;
       osr_code_map_.Put(method, code_ptr);
     } else {
+      ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+      if (info != nullptr) {
+        info->SetBaselineCompiled(baseline);
+      }
       Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
           method, method_header->GetEntryPoint());
     }
@@ -366,7 +375,8 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
     }
     last_update_time_ns_.StoreRelease(NanoTime());
     VLOG(jit)
-        << "JIT added (osr=" << std::boolalpha << osr << std::noboolalpha << ") "
+        << "JIT added (baseline=" << std::boolalpha << baseline
+        << ", osr=" << osr << std::noboolalpha << ") "
         << PrettyMethod(method) << "@" << method
         << " ccache_size=" << PrettySize(CodeCacheSizeLocked()) << ": "
         << " dcache_size=" << PrettySize(DataCacheSizeLocked()) << ": "
@@ -891,15 +901,54 @@ void* JitCodeCache::MoreCore(const void* mspace, intptr_t increment) NO_THREAD_S
   }
 }
 
+// Returns the index of `cls` in the type ids of `dex_file`, or DexFile::kDexNoIndex16
+// if `dex_file` does not reference it.
+static uint16_t FindTypeIndexIn(mirror::Class* cls, const DexFile* dex_file)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  if (cls->GetDexCache() != nullptr && cls->GetDexCache()->GetDexFile() == dex_file) {
+    return cls->GetDexTypeIndex();
+  }
+  std::string temp;
+  const DexFile::TypeId* type_id = dex_file->FindTypeId(cls->GetDescriptor(&temp));
+  return (type_id == nullptr) ? DexFile::kDexNoIndex16 : dex_file->GetIndexForTypeId(*type_id);
+}
+
 void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_locations,
-                                      std::vector<MethodReference>& methods) {
+                                      std::vector<ProfileMethodInfo>& methods) {
   ScopedTrace trace(__FUNCTION__);
   MutexLock mu(Thread::Current(), lock_);
   for (const ProfilingInfo* info : profiling_infos_) {
     ArtMethod* method = info->GetMethod();
     const DexFile* dex_file = method->GetDexFile();
-    if (ContainsElement(dex_base_locations, dex_file->GetBaseLocation())) {
-      methods.emplace_back(dex_file,  method->GetDexMethodIndex());
+    if (!ContainsElement(dex_base_locations, dex_file->GetBaseLocation())) {
+      continue;
+    }
+    methods.emplace_back(dex_file, method->GetDexMethodIndex());
+    std::vector<ProfileMethodInfo::ProfileInlineCache>& inline_caches =
+        methods.back().inline_caches;
+    for (size_t i = 0; i < info->GetNumberOfInlineCaches(); ++i) {
+      const InlineCache& cache = info->GetInlineCacheAt(i);
+      if (cache.IsUninitialized()) {
+        continue;
+      }
+      bool is_megamorphic = cache.IsMegamorphic();
+      bool is_missing_types = false;
+      std::vector<uint16_t> classes;
+      for (size_t j = 0; !is_megamorphic && j < InlineCache::kIndividualCacheSize; ++j) {
+        mirror::Class* cls = cache.GetTypeAt(j);
+        if (cls == nullptr) {
+          break;
+        }
+        // Receiver types are recorded as type indices of the caller's dex file, which
+        // is what the AOT compiler uses to load them.
+        uint16_t type_idx = FindTypeIndexIn(cls, dex_file);
+        if (type_idx == DexFile::kDexNoIndex16) {
+          is_missing_types = true;
+          break;
+        }
+        classes.push_back(type_idx);
+      }
+      inline_caches.emplace_back(cache.GetDexPc(), is_megamorphic, is_missing_types, classes);
     }
   }
 }
@@ -913,8 +962,12 @@ bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
   return osr_code_map_.find(method) != osr_code_map_.end();
 }
 
-bool JitCodeCache::NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr) {
-  if (!osr && ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
+                                       Thread* self,
+                                       bool baseline,
+                                       bool osr) {
+  bool has_compiled_code = !osr && ContainsPc(method->GetEntryPointFromQuickCompiledCode());
+  if (has_compiled_code && baseline) {
     return false;
   }
 
@@ -924,6 +977,10 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr
   }
 
   ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+  if (has_compiled_code && (info == nullptr || !info->IsBaselineCompiled())) {
+    // Only baseline code gets replaced by optimized code.
+    return false;
+  }
   if (info == nullptr) {
     VLOG(jit) << PrettyMethod(method) << " needs a ProfilingInfo to be compiled";
     // Because the counter is not atomic, there are some rare cases where we may not
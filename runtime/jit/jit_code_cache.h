@@ -37,6 +37,7 @@ namespace art {
 class ArtMethod;
 class LinearAlloc;
 class ProfilingInfo;
+struct ProfileMethodInfo;
 
 namespace jit {
 
@@ -69,7 +70,9 @@ class JitCodeCache {
   // Number of bytes allocated in the data cache.
   size_t DataCacheSize() REQUIRES(!lock_);
 
-  bool NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr)
+  // Return whether `method` should be compiled. A method that already has compiled code
+  // is only recompiled if that code is baseline code and `baseline` is false.
+  bool NotifyCompilationOf(ArtMethod* method, Thread* self, bool baseline, bool osr)
       SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!lock_);
 
@@ -98,6 +101,7 @@ class JitCodeCache {
                       size_t fp_spill_mask,
                       const uint8_t* code,
                       size_t code_size,
+                      bool baseline,
                       bool osr)
       SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!lock_);
@@ -165,9 +169,10 @@ class JitCodeCache {
 
   void* MoreCore(const void* mspace, intptr_t increment);
 
-  // Adds to `methods` all profiled methods which are part of any of the given dex locations.
+  // Adds to `methods` all profiled methods which are part of any of the given dex locations,
+  // along with the receiver types seen by their inline caches.
   void GetProfiledMethods(const std::set<std::string>& dex_base_locations,
-                          std::vector<MethodReference>& methods)
+                          std::vector<ProfileMethodInfo>& methods)
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -207,6 +212,7 @@ class JitCodeCache {
                               size_t fp_spill_mask,
                               const uint8_t* code,
                               size_t code_size,
+                              bool baseline,
                               bool osr)
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -36,10 +36,58 @@
 namespace art {
 
 const uint8_t ProfileCompilationInfo::kProfileMagic[] = { 'p', 'r', 'o', '\0' };
-const uint8_t ProfileCompilationInfo::kProfileVersion[] = { '0', '0', '1', '\0' };
+const uint8_t ProfileCompilationInfo::kProfileVersion[] = { '0', '0', '2', '\0' };
 
 static constexpr uint16_t kMaxDexFileKeyLength = PATH_MAX;
 
+// Special values for the number of classes of a serialized inline cache.
+static constexpr uint8_t kIsMissingTypesEncoding = 6;
+static constexpr uint8_t kIsMegamorphicEncoding = 7;
+
+static_assert(InlineCache::kIndividualCacheSize < kIsMissingTypesEncoding,
+              "InlineCache::kIndividualCacheSize does not fit the type encodings");
+static_assert(InlineCache::kIndividualCacheSize < kIsMegamorphicEncoding,
+              "InlineCache::kIndividualCacheSize does not fit the type encodings");
+
+void ProfileCompilationInfo::DexPcData::AddClass(uint16_t type_idx) {
+  if (is_megamorphic || is_missing_types) {
+    return;
+  }
+  classes.insert(type_idx);
+  if (classes.size() >= InlineCache::kIndividualCacheSize) {
+    SetIsMegamorphic();
+  }
+}
+
+void ProfileCompilationInfo::DexPcData::SetIsMegamorphic() {
+  is_megamorphic = true;
+  is_missing_types = false;
+  classes.clear();
+}
+
+void ProfileCompilationInfo::DexPcData::SetIsMissingTypes() {
+  if (is_megamorphic) {
+    return;
+  }
+  is_missing_types = true;
+  classes.clear();
+}
+
+static ProfileCompilationInfo::DexPcData* FindOrAddDexPcData(
+    SafeMap<uint16_t, ProfileCompilationInfo::InlineCacheMap>* inline_caches,
+    uint16_t method_idx,
+    uint16_t dex_pc) {
+  auto method_it = inline_caches->find(method_idx);
+  if (method_it == inline_caches->end()) {
+    method_it = inline_caches->Put(method_idx, ProfileCompilationInfo::InlineCacheMap());
+  }
+  auto dex_pc_it = method_it->second.find(dex_pc);
+  if (dex_pc_it == method_it->second.end()) {
+    dex_pc_it = method_it->second.Put(dex_pc, ProfileCompilationInfo::DexPcData());
+  }
+  return &dex_pc_it->second;
+}
+
 // Transform the actual dex location into relative paths.
 // Note: this is OK because we don't store profiles of different apps into the same file.
 // Apps with split apks don't cause trouble because each split has a different name and will not
@@ -73,6 +121,22 @@ bool ProfileCompilationInfo::AddMethodsAndClasses(
   return true;
 }
 
+bool ProfileCompilationInfo::AddMethodsAndClasses(
+    const std::vector<ProfileMethodInfo>& methods,
+    const std::set<DexCacheResolvedClasses>& resolved_classes) {
+  for (const ProfileMethodInfo& method : methods) {
+    if (!AddMethod(method)) {
+      return false;
+    }
+  }
+  for (const DexCacheResolvedClasses& dex_cache : resolved_classes) {
+    if (!AddResolvedClasses(dex_cache)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool ProfileCompilationInfo::MergeAndSave(const std::string& filename,
                                           uint64_t* bytes_written,
                                           bool force) {
@@ -165,16 +229,55 @@ static void AddUintToBuffer(std::vector<uint8_t>* buffer, T value) {
 
 static constexpr size_t kLineHeaderSize =
     3 * sizeof(uint16_t) +  // method_set.size + class_set.size + dex_location.size
-    sizeof(uint32_t);       // checksum
+    sizeof(uint32_t) +      // checksum
+    sizeof(uint32_t);       // inline_cache_size
+
+// Serializes the inline caches of a dex file. See ProfileCompilationInfo::Save.
+static void AddInlineCachesToBuffer(
+    std::vector<uint8_t>* buffer,
+    const SafeMap<uint16_t, ProfileCompilationInfo::InlineCacheMap>& inline_caches) {
+  DCHECK_LE(inline_caches.size(), std::numeric_limits<uint16_t>::max());
+  AddUintToBuffer(buffer, static_cast<uint16_t>(inline_caches.size()));
+  for (const auto& method_it : inline_caches) {
+    const ProfileCompilationInfo::InlineCacheMap& inline_cache = method_it.second;
+    DCHECK_LE(inline_cache.size(), std::numeric_limits<uint16_t>::max());
+    AddUintToBuffer(buffer, method_it.first);
+    AddUintToBuffer(buffer, static_cast<uint16_t>(inline_cache.size()));
+    for (const auto& dex_pc_it : inline_cache) {
+      const ProfileCompilationInfo::DexPcData& dex_pc_data = dex_pc_it.second;
+      AddUintToBuffer(buffer, dex_pc_it.first);
+      if (dex_pc_data.is_megamorphic) {
+        AddUintToBuffer(buffer, kIsMegamorphicEncoding);
+      } else if (dex_pc_data.is_missing_types) {
+        AddUintToBuffer(buffer, kIsMissingTypesEncoding);
+      } else {
+        DCHECK_LT(dex_pc_data.classes.size(), InlineCache::kIndividualCacheSize);
+        AddUintToBuffer(buffer, static_cast<uint8_t>(dex_pc_data.classes.size()));
+        for (uint16_t type_idx : dex_pc_data.classes) {
+          AddUintToBuffer(buffer, type_idx);
+        }
+      }
+    }
+  }
+}
 
 /**
  * Serialization format:
  *    magic,version,number_of_lines
  *    dex_location1,number_of_methods1,number_of_classes1,dex_location_checksum1, \
- *        method_id11,method_id12...,class_id1,class_id2...
+ *        inline_cache_size1,method_id11,method_id12...,class_id1,class_id2..., \
+ *        inline_caches1
  *    dex_location2,number_of_methods2,number_of_classes2,dex_location_checksum2, \
- *        method_id21,method_id22...,,class_id1,class_id2...
+ *        inline_cache_size2,method_id21,method_id22...,,class_id1,class_id2..., \
+ *        inline_caches2
  *    .....
+ * where inline_caches is:
+ *    number_of_methods_with_inline_caches, \
+ *    method_id1,number_of_dex_pcs1,dex_pc11,number_of_types11,type_id111,type_id112..., \
+ *        dex_pc12,...
+ *    method_id2,...
+ * and number_of_types is either the number of receiver types, or one of the
+ * megamorphic or missing types encodings.
  **/
 bool ProfileCompilationInfo::Save(int fd) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
@@ -206,12 +309,18 @@ bool ProfileCompilationInfo::Save(int fd) {
       return false;
     }
 
+    std::vector<uint8_t> inline_cache_buffer;
+    if (!dex_data.inline_caches.empty()) {
+      AddInlineCachesToBuffer(&inline_cache_buffer, dex_data.inline_caches);
+    }
+
     // Make sure that the buffer has enough capacity to avoid repeated resizings
     // while we add data.
     size_t required_capacity = buffer.size() +
         kLineHeaderSize +
         dex_location.size() +
-        sizeof(uint16_t) * (dex_data.class_set.size() + dex_data.method_set.size());
+        sizeof(uint16_t) * (dex_data.class_set.size() + dex_data.method_set.size()) +
+        inline_cache_buffer.size();
 
     buffer.reserve(required_capacity);
 
@@ -222,6 +331,7 @@ bool ProfileCompilationInfo::Save(int fd) {
     AddUintToBuffer(&buffer, static_cast<uint16_t>(dex_data.method_set.size()));
     AddUintToBuffer(&buffer, static_cast<uint16_t>(dex_data.class_set.size()));
     AddUintToBuffer(&buffer, dex_data.checksum);  // uint32_t
+    AddUintToBuffer(&buffer, static_cast<uint32_t>(inline_cache_buffer.size()));
 
     AddStringToBuffer(&buffer, dex_location);
 
@@ -231,6 +341,7 @@ bool ProfileCompilationInfo::Save(int fd) {
     for (auto class_id : dex_data.class_set) {
       AddUintToBuffer(&buffer, class_id);
     }
+    buffer.insert(buffer.end(), inline_cache_buffer.begin(), inline_cache_buffer.end());
     DCHECK_EQ(required_capacity, buffer.size())
         << "Failed to add the expected number of bytes in the buffer";
   }
@@ -274,6 +385,34 @@ bool ProfileCompilationInfo::AddMethodIndex(const std::string& dex_location,
   return true;
 }
 
+bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& method) {
+  DexFileData* const data = GetOrAddDexFileData(
+      GetProfileDexFileKey(method.dex_file->GetLocation()),
+      method.dex_file->GetLocationChecksum());
+  if (data == nullptr) {
+    return false;
+  }
+  data->method_set.insert(method.dex_method_index);
+  for (const ProfileMethodInfo::ProfileInlineCache& cache : method.inline_caches) {
+    if (cache.dex_pc > std::numeric_limits<uint16_t>::max()) {
+      // The format only stores 16-bit dex pcs, drop the few inline caches past that limit.
+      continue;
+    }
+    DexPcData* dex_pc_data = FindOrAddDexPcData(
+        &data->inline_caches, method.dex_method_index, cache.dex_pc);
+    if (cache.is_megamorphic) {
+      dex_pc_data->SetIsMegamorphic();
+    } else if (cache.is_missing_types) {
+      dex_pc_data->SetIsMissingTypes();
+    } else {
+      for (uint16_t type_idx : cache.classes) {
+        dex_pc_data->AddClass(type_idx);
+      }
+    }
+  }
+  return true;
+}
+
 bool ProfileCompilationInfo::AddClassIndex(const std::string& dex_location,
                                            uint32_t checksum,
                                            uint16_t class_idx) {
@@ -306,6 +445,44 @@ bool ProfileCompilationInfo::ProcessLine(SafeBuffer& line_buffer,
   return true;
 }
 
+bool ProfileCompilationInfo::ProcessInlineCaches(SafeBuffer& buffer, DexFileData* data) {
+  if (buffer.CountUnreadBytes() < sizeof(uint16_t)) {
+    return false;
+  }
+  uint16_t number_of_methods = buffer.ReadUintAndAdvance<uint16_t>();
+  for (uint16_t i = 0; i < number_of_methods; i++) {
+    if (buffer.CountUnreadBytes() < 2 * sizeof(uint16_t)) {
+      return false;
+    }
+    uint16_t method_idx = buffer.ReadUintAndAdvance<uint16_t>();
+    uint16_t number_of_dex_pcs = buffer.ReadUintAndAdvance<uint16_t>();
+    for (uint16_t j = 0; j < number_of_dex_pcs; j++) {
+      if (buffer.CountUnreadBytes() < sizeof(uint16_t) + sizeof(uint8_t)) {
+        return false;
+      }
+      uint16_t dex_pc = buffer.ReadUintAndAdvance<uint16_t>();
+      uint8_t number_of_types = buffer.ReadUintAndAdvance<uint8_t>();
+      DexPcData* dex_pc_data = FindOrAddDexPcData(&data->inline_caches, method_idx, dex_pc);
+      if (number_of_types == kIsMegamorphicEncoding) {
+        dex_pc_data->SetIsMegamorphic();
+      } else if (number_of_types == kIsMissingTypesEncoding) {
+        dex_pc_data->SetIsMissingTypes();
+      } else if (number_of_types >= InlineCache::kIndividualCacheSize) {
+        return false;
+      } else {
+        if (buffer.CountUnreadBytes() < number_of_types * sizeof(uint16_t)) {
+          return false;
+        }
+        for (uint8_t k = 0; k < number_of_types; k++) {
+          dex_pc_data->AddClass(buffer.ReadUintAndAdvance<uint16_t>());
+        }
+      }
+    }
+  }
+  // The inline cache section must be entirely consumed.
+  return buffer.CountUnreadBytes() == 0;
+}
+
 // Tests for EOF by trying to read 1 byte from the descriptor.
 // Returns:
 //   0 if the descriptor is at the EOF,
@@ -404,6 +581,7 @@ ProfileCompilationInfo::ProfileLoadSatus ProfileCompilationInfo::ReadProfileLine
   line_header->method_set_size = header_buffer.ReadUintAndAdvance<uint16_t>();
   line_header->class_set_size = header_buffer.ReadUintAndAdvance<uint16_t>();
   line_header->checksum = header_buffer.ReadUintAndAdvance<uint32_t>();
+  line_header->inline_cache_size = header_buffer.ReadUintAndAdvance<uint32_t>();
 
   if (dex_location_size == 0 || dex_location_size > kMaxDexFileKeyLength) {
     *error = "DexFileKey has an invalid size: " + std::to_string(dex_location_size);
@@ -453,6 +631,28 @@ ProfileCompilationInfo::ProfileLoadSatus ProfileCompilationInfo::ReadProfileLine
     methods_left_to_read -= methods_to_read;
     classes_left_to_read -= classes_to_read;
   }
+
+  if (line_header.inline_cache_size != 0) {
+    // Inline caches are only recorded for profiled methods: bound their size accordingly.
+    static constexpr size_t kMaxInlineCacheBytesPerMethod = 64 * KB;
+    if (line_header.inline_cache_size >
+            std::max<size_t>(line_header.method_set_size, 1u) * kMaxInlineCacheBytesPerMethod) {
+      *error = "Inline cache data has an invalid size: " +
+          std::to_string(line_header.inline_cache_size);
+      return kProfileLoadBadData;
+    }
+    SafeBuffer inline_cache_buffer(line_header.inline_cache_size);
+    ProfileLoadSatus status =
+        inline_cache_buffer.FillFromFd(fd, "ReadProfileLineInlineCaches", error);
+    if (status != kProfileLoadSuccess) {
+      return status;
+    }
+    DexFileData* data = GetOrAddDexFileData(line_header.dex_location, line_header.checksum);
+    if (data == nullptr || !ProcessInlineCaches(inline_cache_buffer, data)) {
+      *error = "Error when reading profile file inline caches";
+      return kProfileLoadBadData;
+    }
+  }
   return kProfileLoadSuccess;
 }
 
@@ -542,10 +742,31 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other) {
                                       other_dex_data.method_set.end());
     info_it->second.class_set.insert(other_dex_data.class_set.begin(),
                                      other_dex_data.class_set.end());
+    MergeInlineCaches(other_dex_data.inline_caches, &info_it->second.inline_caches);
   }
   return true;
 }
 
+void ProfileCompilationInfo::MergeInlineCaches(
+    const SafeMap<uint16_t, InlineCacheMap>& source,
+    SafeMap<uint16_t, InlineCacheMap>* destination) {
+  for (const auto& method_it : source) {
+    for (const auto& dex_pc_it : method_it.second) {
+      const DexPcData& source_data = dex_pc_it.second;
+      DexPcData* data = FindOrAddDexPcData(destination, method_it.first, dex_pc_it.first);
+      if (source_data.is_megamorphic) {
+        data->SetIsMegamorphic();
+      } else if (source_data.is_missing_types) {
+        data->SetIsMissingTypes();
+      } else {
+        for (uint16_t type_idx : source_data.classes) {
+          data->AddClass(type_idx);
+        }
+      }
+    }
+  }
+}
+
 bool ProfileCompilationInfo::ContainsMethod(const MethodReference& method_ref) const {
   auto info_it = info_.find(GetProfileDexFileKey(method_ref.dex_file->GetLocation()));
   if (info_it != info_.end()) {
@@ -570,6 +791,32 @@ bool ProfileCompilationInfo::ContainsClass(const DexFile& dex_file, uint16_t cla
   return false;
 }
 
+const ProfileCompilationInfo::DexPcData* ProfileCompilationInfo::FindInlineCache(
+    const MethodReference& method_ref, uint32_t dex_pc) const {
+  auto info_it = info_.find(GetProfileDexFileKey(method_ref.dex_file->GetLocation()));
+  if (info_it == info_.end() ||
+      method_ref.dex_file->GetLocationChecksum() != info_it->second.checksum) {
+    return nullptr;
+  }
+  const SafeMap<uint16_t, InlineCacheMap>& inline_caches = info_it->second.inline_caches;
+  auto method_it = inline_caches.find(method_ref.dex_method_index);
+  if (method_it == inline_caches.end() || dex_pc > std::numeric_limits<uint16_t>::max()) {
+    return nullptr;
+  }
+  auto dex_pc_it = method_it->second.find(dex_pc);
+  return (dex_pc_it == method_it->second.end()) ? nullptr : &dex_pc_it->second;
+}
+
+uint32_t ProfileCompilationInfo::GetNumberOfInlineCaches() const {
+  uint32_t total = 0;
+  for (const auto& it : info_) {
+    for (const auto& method_it : it.second.inline_caches) {
+      total += method_it.second.size();
+    }
+  }
+  return total;
+}
+
 uint32_t ProfileCompilationInfo::GetNumberOfMethods() const {
   uint32_t total = 0;
   for (const auto& it : info_) {
@@ -631,6 +878,30 @@ std::string ProfileCompilationInfo::DumpInfo(const std::vector<const DexFile*>*
         os << class_it << ",";
       }
     }
+    os << "\n\tinline caches: ";
+    for (const auto& method_it : dex_data.inline_caches) {
+      os << "\n\t\t";
+      if (dex_file != nullptr) {
+        os << PrettyMethod(method_it.first, *dex_file, true);
+      } else {
+        os << method_it.first;
+      }
+      for (const auto& dex_pc_it : method_it.second) {
+        const DexPcData& dex_pc_data = dex_pc_it.second;
+        os << " " << dex_pc_it.first << ":";
+        if (dex_pc_data.is_megamorphic) {
+          os << "megamorphic";
+        } else if (dex_pc_data.is_missing_types) {
+          os << "missing_types";
+        } else {
+          os << "{";
+          for (uint16_t type_idx : dex_pc_data.classes) {
+            os << type_idx << ",";
+          }
+          os << "}";
+        }
+      }
+    }
   }
   return os.str();
 }
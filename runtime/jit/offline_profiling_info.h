@@ -28,22 +28,82 @@
 
 namespace art {
 
+/**
+ * Convenient class to pass around profile information (including inline caches)
+ * without the need to hold GC-able objects.
+ */
+struct ProfileMethodInfo {
+  struct ProfileInlineCache {
+    ProfileInlineCache(uint32_t pc,
+                       bool megamorphic,
+                       bool missing_types,
+                       const std::vector<uint16_t>& types)
+        : dex_pc(pc), is_megamorphic(megamorphic), is_missing_types(missing_types),
+          classes(types) {}
+
+    const uint32_t dex_pc;
+    const bool is_megamorphic;
+    // Whether some of the receiver types could not be encoded as type indices
+    // of the method's dex file.
+    const bool is_missing_types;
+    // Type indices of the receiver classes, in the method's dex file.
+    const std::vector<uint16_t> classes;
+  };
+
+  ProfileMethodInfo(const DexFile* dex, uint32_t method_index)
+      : dex_file(dex), dex_method_index(method_index) {}
+
+  const DexFile* dex_file;
+  const uint32_t dex_method_index;
+  std::vector<ProfileInlineCache> inline_caches;
+};
+
 // TODO: rename file.
 /**
  * Profile information in a format suitable to be queried by the compiler and
  * performing profile guided compilation.
  * It is a serialize-friendly format based on information collected by the
  * interpreter (ProfileInfo).
- * Currently it stores only the hot compiled methods.
+ * It stores the hot methods, the resolved classes, and the receiver types seen by
+ * the inline caches of the hot methods.
  */
 class ProfileCompilationInfo {
  public:
   static const uint8_t kProfileMagic[];
   static const uint8_t kProfileVersion[];
 
+  // Receiver types seen at an invoke. An inline cache which saw more than
+  // ProfilingInfo's individual cache size types is megamorphic.
+  struct DexPcData {
+    DexPcData() : is_megamorphic(false), is_missing_types(false) {}
+
+    // Add the given type index, and turn the data megamorphic when it has
+    // too many types.
+    void AddClass(uint16_t type_idx);
+    void SetIsMegamorphic();
+    void SetIsMissingTypes();
+
+    bool operator==(const DexPcData& other) const {
+      return is_megamorphic == other.is_megamorphic &&
+          is_missing_types == other.is_missing_types &&
+          classes == other.classes;
+    }
+
+    bool is_megamorphic;
+    bool is_missing_types;
+    std::set<uint16_t> classes;
+  };
+
+  // Inline cache data of a method, keyed by dex pc.
+  using InlineCacheMap = SafeMap<uint16_t, DexPcData>;
+
   // Add the given methods and classes to the current profile object.
   bool AddMethodsAndClasses(const std::vector<MethodReference>& methods,
                             const std::set<DexCacheResolvedClasses>& resolved_classes);
+  // Add the given methods, with their inline caches, and classes to the current
+  // profile object.
+  bool AddMethodsAndClasses(const std::vector<ProfileMethodInfo>& methods,
+                            const std::set<DexCacheResolvedClasses>& resolved_classes);
   // Loads profile information from the given file descriptor.
   bool Load(int fd);
   // Merge the data from another ProfileCompilationInfo into the current object.
@@ -68,6 +128,13 @@ class ProfileCompilationInfo {
   // Returns true if the class is present in the profiling info.
   bool ContainsClass(const DexFile& dex_file, uint16_t class_def_idx) const;
 
+  // Returns the inline cache data recorded for the invoke at `dex_pc` in the
+  // referenced method, or null if there is none.
+  const DexPcData* FindInlineCache(const MethodReference& method_ref, uint32_t dex_pc) const;
+
+  // Returns the number of inline caches that were profiled.
+  uint32_t GetNumberOfInlineCaches() const;
+
   // Dumps all the loaded profile info into a string and returns it.
   // If dex_files is not null then the method indices will be resolved to their
   // names.
@@ -100,9 +167,12 @@ class ProfileCompilationInfo {
     uint32_t checksum;
     std::set<uint16_t> method_set;
     std::set<uint16_t> class_set;
+    SafeMap<uint16_t, InlineCacheMap> inline_caches;
 
     bool operator==(const DexFileData& other) const {
-      return checksum == other.checksum && method_set == other.method_set;
+      return checksum == other.checksum &&
+          method_set == other.method_set &&
+          inline_caches.Equals(other.inline_caches);
     }
   };
 
@@ -112,6 +182,10 @@ class ProfileCompilationInfo {
   bool AddMethodIndex(const std::string& dex_location, uint32_t checksum, uint16_t method_idx);
   bool AddClassIndex(const std::string& dex_location, uint32_t checksum, uint16_t class_idx);
   bool AddResolvedClasses(const DexCacheResolvedClasses& classes);
+  bool AddMethod(const ProfileMethodInfo& method);
+  // Merge `source` inline caches into `destination`.
+  static void MergeInlineCaches(const SafeMap<uint16_t, InlineCacheMap>& source,
+                                SafeMap<uint16_t, InlineCacheMap>* destination);
 
   // Parsing functionality.
 
@@ -120,6 +194,8 @@ class ProfileCompilationInfo {
     uint16_t method_set_size;
     uint16_t class_set_size;
     uint32_t checksum;
+    // Size in bytes of the serialized inline caches.
+    uint32_t inline_cache_size;
   };
 
   // A helper structure to make sure we don't read past our buffers in the loops.
@@ -143,6 +219,9 @@ class ProfileCompilationInfo {
     // equal it advances the current pointer by data_size.
     bool CompareAndAdvance(const uint8_t* data, size_t data_size);
 
+    // Returns the number of bytes left to read.
+    size_t CountUnreadBytes() const { return ptr_end_ - ptr_current_; }
+
     // Get the underlying raw buffer.
     uint8_t* Get() { return storage_.get(); }
 
@@ -171,6 +250,9 @@ class ProfileCompilationInfo {
                    uint32_t checksum,
                    const std::string& dex_location);
 
+  // Reads the serialized inline caches of a profile line.
+  bool ProcessInlineCaches(SafeBuffer& buffer, DexFileData* data);
+
   friend class ProfileCompilationInfoTest;
   friend class CompilerDriverProfileTest;
   friend class ProfileAssistantTest;
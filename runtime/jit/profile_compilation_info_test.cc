@@ -292,9 +292,9 @@ TEST_F(ProfileCompilationInfoTest, TooLongDexLocation) {
   uint8_t line_number[] = { 0, 1 };
   ASSERT_TRUE(profile.GetFile()->WriteFully(line_number, sizeof(line_number)));
 
-  // dex_location_size, methods_size, classes_size, checksum.
+  // dex_location_size, methods_size, classes_size, checksum, inline_cache_size.
   // Dex location size is too big and should be rejected.
-  uint8_t line[] = { 255, 255, 0, 1, 0, 1, 0, 0, 0, 0 };
+  uint8_t line[] = { 255, 255, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
   ASSERT_TRUE(profile.GetFile()->WriteFully(line, sizeof(line)));
   ASSERT_EQ(0, profile.GetFile()->Flush());
 
@@ -303,6 +303,102 @@ TEST_F(ProfileCompilationInfoTest, TooLongDexLocation) {
   ASSERT_FALSE(loaded_info.Load(GetFd(profile)));
 }
 
+TEST_F(ProfileCompilationInfoTest, SaveInlineCaches) {
+  ScratchFile profile;
+  std::unique_ptr<const DexFile> dex_file(OpenTestDexFile("ProfileTestMultiDex"));
+
+  ProfileMethodInfo monomorphic(dex_file.get(), /* method_index */ 1);
+  monomorphic.inline_caches.emplace_back(/* dex_pc */ 3,
+                                         /* megamorphic */ false,
+                                         /* missing_types */ false,
+                                         std::vector<uint16_t>({ 2 }));
+  monomorphic.inline_caches.emplace_back(/* dex_pc */ 7,
+                                         /* megamorphic */ true,
+                                         /* missing_types */ false,
+                                         std::vector<uint16_t>());
+  ProfileMethodInfo polymorphic(dex_file.get(), /* method_index */ 2);
+  polymorphic.inline_caches.emplace_back(/* dex_pc */ 5,
+                                         /* megamorphic */ false,
+                                         /* missing_types */ false,
+                                         std::vector<uint16_t>({ 1, 4 }));
+  polymorphic.inline_caches.emplace_back(/* dex_pc */ 9,
+                                         /* megamorphic */ false,
+                                         /* missing_types */ true,
+                                         std::vector<uint16_t>());
+
+  ProfileCompilationInfo saved_info;
+  std::vector<ProfileMethodInfo> methods = { monomorphic, polymorphic };
+  ASSERT_TRUE(saved_info.AddMethodsAndClasses(methods, std::set<DexCacheResolvedClasses>()));
+  ASSERT_EQ(4u, saved_info.GetNumberOfInlineCaches());
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  // Check that we get back what we saved.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(profile.GetFile()->ResetOffset());
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  const ProfileCompilationInfo::DexPcData* data =
+      loaded_info.FindInlineCache(MethodReference(dex_file.get(), 1), 3);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_EQ(std::set<uint16_t>({ 2 }), data->classes);
+  data = loaded_info.FindInlineCache(MethodReference(dex_file.get(), 1), 7);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_TRUE(data->is_megamorphic);
+  data = loaded_info.FindInlineCache(MethodReference(dex_file.get(), 2), 5);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_EQ(std::set<uint16_t>({ 1, 4 }), data->classes);
+  data = loaded_info.FindInlineCache(MethodReference(dex_file.get(), 2), 9);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_TRUE(data->is_missing_types);
+  ASSERT_TRUE(loaded_info.FindInlineCache(MethodReference(dex_file.get(), 2), 11) == nullptr);
+}
+
+TEST_F(ProfileCompilationInfoTest, MergeInlineCaches) {
+  std::unique_ptr<const DexFile> dex_file(OpenTestDexFile("ProfileTestMultiDex"));
+  MethodReference method_ref(dex_file.get(), /* method_index */ 1);
+
+  // Receiver types seen by different processes are merged, and too many of
+  // them make the inline cache megamorphic.
+  ProfileCompilationInfo info1;
+  ProfileMethodInfo method1(dex_file.get(), method_ref.dex_method_index);
+  method1.inline_caches.emplace_back(/* dex_pc */ 3,
+                                     /* megamorphic */ false,
+                                     /* missing_types */ false,
+                                     std::vector<uint16_t>({ 1, 2 }));
+  ASSERT_TRUE(info1.AddMethodsAndClasses(std::vector<ProfileMethodInfo>({ method1 }),
+                                         std::set<DexCacheResolvedClasses>()));
+
+  ProfileCompilationInfo info2;
+  ProfileMethodInfo method2(dex_file.get(), method_ref.dex_method_index);
+  method2.inline_caches.emplace_back(/* dex_pc */ 3,
+                                     /* megamorphic */ false,
+                                     /* missing_types */ false,
+                                     std::vector<uint16_t>({ 2, 3 }));
+  ASSERT_TRUE(info2.AddMethodsAndClasses(std::vector<ProfileMethodInfo>({ method2 }),
+                                         std::set<DexCacheResolvedClasses>()));
+
+  ASSERT_TRUE(info1.MergeWith(info2));
+  const ProfileCompilationInfo::DexPcData* data = info1.FindInlineCache(method_ref, 3);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_EQ(std::set<uint16_t>({ 1, 2, 3 }), data->classes);
+
+  ProfileCompilationInfo info3;
+  ProfileMethodInfo method3(dex_file.get(), method_ref.dex_method_index);
+  method3.inline_caches.emplace_back(/* dex_pc */ 3,
+                                     /* megamorphic */ false,
+                                     /* missing_types */ false,
+                                     std::vector<uint16_t>({ 4, 5 }));
+  ASSERT_TRUE(info3.AddMethodsAndClasses(std::vector<ProfileMethodInfo>({ method3 }),
+                                         std::set<DexCacheResolvedClasses>()));
+  ASSERT_TRUE(info1.MergeWith(info3));
+  data = info1.FindInlineCache(method_ref, 3);
+  ASSERT_TRUE(data != nullptr);
+  ASSERT_TRUE(data->is_megamorphic);
+  ASSERT_TRUE(data->classes.empty());
+}
+
 TEST_F(ProfileCompilationInfoTest, UnexpectedContent) {
   ScratchFile profile;
 
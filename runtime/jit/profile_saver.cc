@@ -40,6 +40,7 @@ static constexpr const size_t kStartupMethodSamples = 1;
 
 static constexpr const uint32_t kMinimumNumberOfMethodsToSave = 10;
 static constexpr const uint32_t kMinimumNumberOfClassesToSave = 10;
+static constexpr const uint32_t kMinimumNumberOfInlineCachesToSave = 10;
 static constexpr const uint32_t kMinimumNumberOfNotificationBeforeWake =
     kMinimumNumberOfMethodsToSave;
 static constexpr const uint32_t kMaximumNumberOfNotificationBeforeWake = 50;
@@ -58,6 +59,7 @@ ProfileSaver::ProfileSaver(const std::string& output_filename,
       shutting_down_(false),
       last_save_number_of_methods_(0),
       last_save_number_of_classes_(0),
+      last_save_number_of_inline_caches_(0),
       last_time_ns_saver_woke_up_(0),
       jit_activity_notifications_(0),
       wait_lock_("ProfileSaver wait lock"),
@@ -286,7 +288,7 @@ bool ProfileSaver::ProcessProfilingInfo(uint16_t* new_methods) {
     }
     const std::string& filename = it.first;
     const std::set<std::string>& locations = it.second;
-    std::vector<MethodReference> methods;
+    std::vector<ProfileMethodInfo> methods;
     {
       ScopedObjectAccess soa(Thread::Current());
       jit_code_cache_->GetProfiledMethods(locations, methods);
@@ -301,12 +303,17 @@ bool ProfileSaver::ProcessProfilingInfo(uint16_t* new_methods) {
     int64_t delta_number_of_classes =
         cached_info->GetNumberOfResolvedClasses() -
         static_cast<int64_t>(last_save_number_of_classes_);
+    int64_t delta_number_of_inline_caches =
+        cached_info->GetNumberOfInlineCaches() -
+        static_cast<int64_t>(last_save_number_of_inline_caches_);
 
     if (delta_number_of_methods < kMinimumNumberOfMethodsToSave &&
-        delta_number_of_classes < kMinimumNumberOfClassesToSave) {
+        delta_number_of_classes < kMinimumNumberOfClassesToSave &&
+        delta_number_of_inline_caches < kMinimumNumberOfInlineCachesToSave) {
       VLOG(profiler) << "Not enough information to save to: " << filename
           << " Nr of methods: " << delta_number_of_methods
-          << " Nr of classes: " << delta_number_of_classes;
+          << " Nr of classes: " << delta_number_of_classes
+          << " Nr of inline caches: " << delta_number_of_inline_caches;
       total_number_of_skipped_writes_++;
       continue;
     }
@@ -317,6 +324,7 @@ bool ProfileSaver::ProcessProfilingInfo(uint16_t* new_methods) {
     if (cached_info->MergeAndSave(filename, &bytes_written, /*force*/ true)) {
       last_save_number_of_methods_ = cached_info->GetNumberOfMethods();
       last_save_number_of_classes_ = cached_info->GetNumberOfResolvedClasses();
+      last_save_number_of_inline_caches_ = cached_info->GetNumberOfInlineCaches();
       // Clear resolved classes. No need to store them around as
       // they don't change after the first write.
       cached_info->ClearResolvedClasses();
@@ -30,6 +30,7 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& ent
         method_(method),
         is_method_being_compiled_(false),
         is_osr_method_being_compiled_(false),
+        is_baseline_compiled_(false),
         current_inline_uses_(0),
         saved_entry_point_(nullptr) {
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
@@ -82,7 +83,22 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, entries, retry_allocation) != nullptr;
+  ProfilingInfo* info = code_cache->AddProfilingInfo(self, method, entries, retry_allocation);
+  if (info == nullptr) {
+    return false;
+  }
+
+  // Seed the inline caches with the receiver types the interpreter has already seen
+  // while the method was not hot.
+  ScopedAssertNoThreadSuspension sants(self, __FUNCTION__);
+  const interpreter::InterpreterCache* interpreter_cache = self->GetInterpreterCache();
+  for (uint32_t entry : entries) {
+    mirror::Class* cls = interpreter_cache->GetClass(Instruction::At(code_item.insns_ + entry));
+    if (cls != nullptr) {
+      info->AddInvokeInfo(entry, cls);
+    }
+  }
+  return true;
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -39,6 +39,19 @@ class Class;
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
 class InlineCache {
  public:
+  InlineCache() : dex_pc_(0) {}
+
+  // Fill the cache with the given receiver types. Used by the AOT compiler to
+  // rebuild an inline cache from offline profile data.
+  void SetTypes(uint32_t dex_pc, const std::vector<mirror::Class*>& types)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    DCHECK_LE(types.size(), kIndividualCacheSize);
+    dex_pc_ = dex_pc;
+    for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+      classes_[i] = GcRoot<mirror::Class>(i < types.size() ? types[i] : nullptr);
+    }
+  }
+
   bool IsMonomorphic() const {
     DCHECK_GE(kIndividualCacheSize, 2);
     return !classes_[0].IsNull() && classes_[1].IsNull();
@@ -73,6 +86,10 @@ class InlineCache {
     return classes_[i].Read();
   }
 
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
   static constexpr uint16_t kIndividualCacheSize = 5;
 
  private:
@@ -120,6 +137,15 @@ class ProfilingInfo {
 
   InlineCache* GetInlineCache(uint32_t dex_pc);
 
+  size_t GetNumberOfInlineCaches() const {
+    return number_of_inline_caches_;
+  }
+
+  const InlineCache& GetInlineCacheAt(size_t i) const {
+    DCHECK_LT(i, number_of_inline_caches_);
+    return cache_[i];
+  }
+
   bool IsMethodBeingCompiled(bool osr) const {
     return osr
         ? is_osr_method_being_compiled_
@@ -142,6 +168,16 @@ class ProfilingInfo {
     return saved_entry_point_;
   }
 
+  // Whether the JIT code of the method was compiled with the baseline compiler. This flag
+  // is implicitly guarded by the JIT code cache lock.
+  bool IsBaselineCompiled() const {
+    return is_baseline_compiled_;
+  }
+
+  void SetBaselineCompiled(bool value) {
+    is_baseline_compiled_ = value;
+  }
+
   void ClearGcRootsInInlineCaches() {
     for (size_t i = 0; i < number_of_inline_caches_; ++i) {
       InlineCache* cache = &cache_[i];
@@ -184,6 +220,9 @@ class ProfilingInfo {
   bool is_method_being_compiled_;
   bool is_osr_method_being_compiled_;
 
+  // Whether the compiled code of the method is baseline code.
+  bool is_baseline_compiled_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
@@ -16,6 +16,9 @@
 
 #include "monitor.h"
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <vector>
 
 #include "art_method-inl.h"
@@ -40,6 +43,25 @@ namespace art {
 
 static constexpr uint64_t kLongWaitMs = 100;
 
+// Bounds and initial value of the per-monitor spin budget on contention.
+static constexpr uint32_t kMinSpinIterations = 16;
+static constexpr uint32_t kInitialSpinIterations = 256;
+static constexpr uint32_t kMaxSpinIterations = 4096;
+
+// Maximum number of distinct sites kept in the contention profile, and number dumped on SIGQUIT.
+static constexpr size_t kMaxContentionSites = 256;
+static constexpr size_t kNumContentionSitesToDump = 10;
+
+static inline void SpinPause() {
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#else
+  __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
 /*
  * Every Object has a monitor associated with it, but not every Object is actually locked.  Even
  * the ones that are locked do not need a full-fledged monitor until a) there is actual contention
@@ -67,10 +89,31 @@ static constexpr uint64_t kLongWaitMs = 100;
  * at any given time.
  */
 
+struct Monitor::ContentionSite {
+  ArtMethod* owners_method;
+  uint32_t owners_dex_pc;
+  ArtMethod* waiters_method;
+  uint32_t waiters_dex_pc;
+  // Formatted when the site is first recorded, so that dumping does not need the mutator lock.
+  std::string owners_location;
+  std::string waiters_location;
+  uint64_t samples;
+  uint64_t wait_ms;
+};
+
 uint32_t Monitor::lock_profiling_threshold_ = 0;
+bool Monitor::spin_on_contention_ = false;
+Mutex* Monitor::contention_sites_lock_ = nullptr;
+std::vector<Monitor::ContentionSite>* Monitor::contention_sites_ = nullptr;
 
 void Monitor::Init(uint32_t lock_profiling_threshold) {
   lock_profiling_threshold_ = lock_profiling_threshold;
+  spin_on_contention_ = sysconf(_SC_NPROCESSORS_CONF) > 1;
+  if (contention_sites_lock_ == nullptr) {
+    contention_sites_lock_ = new Mutex("monitor contention sites lock",
+                                       kMonitorContentionSitesLock);
+    contention_sites_ = new std::vector<ContentionSite>();
+  }
 }
 
 Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_code)
@@ -84,6 +127,7 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       hash_code_(hash_code),
       locking_method_(nullptr),
       locking_dex_pc_(0),
+      spin_iterations_(kInitialSpinIterations),
       monitor_id_(MonitorPool::ComputeMonitorId(this, self)) {
 #ifdef __LP64__
   DCHECK(false) << "Should not be reached in 64b";
@@ -107,6 +151,7 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       hash_code_(hash_code),
       locking_method_(nullptr),
       locking_dex_pc_(0),
+      spin_iterations_(kInitialSpinIterations),
       monitor_id_(id) {
 #ifdef __LP64__
   next_free_ = nullptr;
@@ -337,13 +382,50 @@ bool Monitor::TryLock(Thread* self) {
   return TryLockLocked(self);
 }
 
+bool Monitor::SpinWhileOwnerRunning(Thread* self) {
+  Thread* owner = owner_;
+  // Only spin if the owner is running, otherwise it cannot release the monitor before we block.
+  if (!spin_on_contention_ || owner == nullptr || owner->GetState() != kRunnable) {
+    return false;
+  }
+  const uint32_t spin_iterations = spin_iterations_;
+  bool released = false;
+  // We stay runnable while spinning, so the monitor cannot be deflated.
+  monitor_lock_.Unlock(self);
+  for (uint32_t i = 0; i != spin_iterations; ++i) {
+    if (GetOwner() != owner) {
+      released = true;
+      break;
+    }
+    if (UNLIKELY(self->TestAllFlags())) {
+      // Do not delay suspension or checkpoint requests.
+      break;
+    }
+    SpinPause();
+  }
+  monitor_lock_.Lock(self);
+  if (released) {
+    spin_iterations_ = std::min(spin_iterations_ * 2, kMaxSpinIterations);
+  } else {
+    spin_iterations_ = std::max(spin_iterations_ / 2, kMinSpinIterations);
+  }
+  return released;
+}
+
 void Monitor::Lock(Thread* self) {
   MutexLock mu(self, monitor_lock_);
+  bool spun = false;
   while (true) {
     if (TryLockLocked(self)) {
       return;
     }
-    // Contended.
+    // Contended. Before blocking, spin once in case the owner is about to release the monitor.
+    if (!spun) {
+      spun = true;
+      if (SpinWhileOwnerRunning(self)) {
+        continue;
+      }
+    }
     const bool log_contention = (lock_profiling_threshold_ != 0);
     uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
     ArtMethod* owners_method = locking_method_;
@@ -410,9 +492,10 @@ void Monitor::Lock(Thread* self) {
               sample_percent = 100 * wait_ms / lock_profiling_threshold_;
             }
             if (sample_percent != 0 && (static_cast<uint32_t>(rand() % 100) < sample_percent)) {
+              uint32_t pc;
+              ArtMethod* m = self->GetCurrentMethod(&pc);
+              RecordContentionSite(owners_method, owners_dex_pc, m, pc, wait_ms);
               if (wait_ms > kLongWaitMs && owners_method != nullptr) {
-                uint32_t pc;
-                ArtMethod* m = self->GetCurrentMethod(&pc);
                 // TODO: We should maybe check that original_owner is still a live thread.
                 LOG(WARNING) << "Long "
                     << PrettyContentionInfo(original_owner_name,
@@ -445,6 +528,88 @@ void Monitor::Lock(Thread* self) {
   }
 }
 
+std::string Monitor::PrettyContentionLocation(ArtMethod* method, uint32_t dex_pc) {
+  if (method == nullptr) {
+    return "<unknown>";
+  }
+  const char* filename;
+  int32_t line_number;
+  TranslateLocation(method, dex_pc, &filename, &line_number);
+  std::ostringstream oss;
+  oss << PrettyMethod(method) << "(" << (filename != nullptr ? filename : "null") << ":"
+      << line_number << ")";
+  return oss.str();
+}
+
+void Monitor::RecordContentionSite(ArtMethod* owners_method,
+                                   uint32_t owners_dex_pc,
+                                   ArtMethod* waiters_method,
+                                   uint32_t waiters_dex_pc,
+                                   uint64_t wait_ms) {
+  Thread* self = Thread::Current();
+  auto add_to_existing_site = [&]() REQUIRES(*contention_sites_lock_) {
+    for (ContentionSite& site : *contention_sites_) {
+      if (site.owners_method == owners_method &&
+          site.owners_dex_pc == owners_dex_pc &&
+          site.waiters_method == waiters_method &&
+          site.waiters_dex_pc == waiters_dex_pc) {
+        ++site.samples;
+        site.wait_ms += wait_ms;
+        return true;
+      }
+    }
+    return false;
+  };
+  {
+    MutexLock mu(self, *contention_sites_lock_);
+    if (add_to_existing_site() || contention_sites_->size() >= kMaxContentionSites) {
+      return;
+    }
+  }
+  // New site. Format the locations without holding the lock, as that may take other locks.
+  std::string owners_location = PrettyContentionLocation(owners_method, owners_dex_pc);
+  std::string waiters_location = PrettyContentionLocation(waiters_method, waiters_dex_pc);
+  MutexLock mu(self, *contention_sites_lock_);
+  // Check again, another waiter may have added the same site meanwhile.
+  if (add_to_existing_site() || contention_sites_->size() >= kMaxContentionSites) {
+    return;
+  }
+  contention_sites_->push_back(ContentionSite {owners_method,
+                                               owners_dex_pc,
+                                               waiters_method,
+                                               waiters_dex_pc,
+                                               owners_location,
+                                               waiters_location,
+                                               1u,
+                                               wait_ms});
+}
+
+void Monitor::DumpContentionProfile(std::ostream& os) {
+  if (contention_sites_lock_ == nullptr) {
+    return;
+  }
+  std::vector<ContentionSite> sites;
+  {
+    MutexLock mu(Thread::Current(), *contention_sites_lock_);
+    sites = *contention_sites_;
+  }
+  if (sites.empty()) {
+    return;
+  }
+  std::sort(sites.begin(), sites.end(), [](const ContentionSite& a, const ContentionSite& b) {
+    return a.wait_ms > b.wait_ms;
+  });
+  os << "Monitor contention sites (sampled, top " << kNumContentionSitesToDump
+     << " by wait time):\n";
+  for (size_t i = 0; i < std::min(sites.size(), kNumContentionSitesToDump); ++i) {
+    const ContentionSite& site = sites[i];
+    os << "  " << PrettyDuration(MsToNs(site.wait_ms)) << " in " << site.samples << " samples,"
+       << " held at " << site.owners_location
+       << " blocking from " << site.waiters_location << "\n";
+  }
+  os << "\n";
+}
+
 static void ThrowIllegalMonitorStateExceptionF(const char* fmt, ...)
                                               __attribute__((format(printf, 1, 2)));
 
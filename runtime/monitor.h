@@ -57,6 +57,10 @@ class Monitor {
 
   static void Init(uint32_t lock_profiling_threshold);
 
+  // Dump the monitor contention sites with the longest sampled wait times. Sites are only recorded
+  // when lock profiling is enabled, i.e. -Xlockprofthreshold is non-zero.
+  static void DumpContentionProfile(std::ostream& os) REQUIRES(!*contention_sites_lock_);
+
   // Return the thread id of the lock owner or 0 when there is no owner.
   static uint32_t GetLockOwnerThreadId(mirror::Object* obj)
       NO_THREAD_SAFETY_ANALYSIS;  // TODO: Reading lock owner without holding lock is racy.
@@ -205,6 +209,12 @@ class Monitor {
   void Lock(Thread* self)
       REQUIRES(!monitor_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
+  // Spin with monitor_lock_ released while the current owner is runnable, waiting for it to give
+  // up the monitor. Returns true if the owner changed, in which case acquiring the monitor should
+  // be retried before blocking. Adapts spin_iterations_ to the outcome.
+  bool SpinWhileOwnerRunning(Thread* self)
+      REQUIRES(monitor_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
   bool Unlock(Thread* thread)
       REQUIRES(!monitor_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -257,6 +267,19 @@ class Monitor {
                                 int32_t* line_number)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  static std::string PrettyContentionLocation(ArtMethod* method, uint32_t dex_pc)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Add a sampled contention event to the contention profile, keyed by the location where the
+  // owner acquired the monitor and the location where the waiter blocked.
+  static void RecordContentionSite(ArtMethod* owners_method,
+                                   uint32_t owners_dex_pc,
+                                   ArtMethod* waiters_method,
+                                   uint32_t waiters_dex_pc,
+                                   uint64_t wait_ms)
+      REQUIRES(!*contention_sites_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   uint32_t GetOwnerThreadId() REQUIRES(!monitor_lock_);
 
   // Support for systrace output of monitor operations.
@@ -272,6 +295,15 @@ class Monitor {
 
   static uint32_t lock_profiling_threshold_;
 
+  // Whether contended monitor enters spin before blocking. Disabled on uniprocessors, where the
+  // owner cannot make progress while we spin.
+  static bool spin_on_contention_;
+
+  // Sampled contention events aggregated by site, see RecordContentionSite.
+  struct ContentionSite;
+  static Mutex* contention_sites_lock_;
+  static std::vector<ContentionSite>* contention_sites_ GUARDED_BY(contention_sites_lock_);
+
   Mutex monitor_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
   ConditionVariable monitor_contenders_ GUARDED_BY(monitor_lock_);
@@ -302,6 +334,11 @@ class Monitor {
   ArtMethod* locking_method_ GUARDED_BY(monitor_lock_);
   uint32_t locking_dex_pc_ GUARDED_BY(monitor_lock_);
 
+  // Number of iterations to spin on contention while the owner is running. Grows when spinning
+  // sees the owner release the monitor and shrinks when it does not, so that monitors held for
+  // short periods are spun on and monitors held for long periods quickly go to blocking.
+  uint32_t spin_iterations_ GUARDED_BY(monitor_lock_);
+
   // The denser encoded version of this monitor as stored in the lock word.
   MonitorId monitor_id_;
 
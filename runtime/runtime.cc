@@ -134,9 +134,11 @@
 #include "signal_set.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "transaction.h"
 #include "utils.h"
+#include "verifier/background_verifier.h"
 #include "verifier/method_verifier.h"
 #include "well_known_classes.h"
 
@@ -217,6 +219,10 @@ Runtime::Runtime()
       dump_gc_performance_on_shutdown_(false),
       preinitialization_transaction_(nullptr),
       verify_(verifier::VerifyMode::kNone),
+      background_verification_threads_(0u),
+      image_loading_threads_(0u),
+      image_loading_thread_pool_lock_("Image loading thread pool lock"),
+      image_loading_thread_pool_in_use_(false),
       allow_dex_file_fallback_(true),
       target_sdk_version_(0),
       implicit_null_checks_(false),
@@ -291,6 +297,11 @@ Runtime::~Runtime() {
   // Make sure to let the GC complete if it is running.
   heap_->WaitForGcToComplete(gc::kGcCauseBackground, self);
   heap_->DeleteThreadPool();
+  {
+    MutexLock mu(self, image_loading_thread_pool_lock_);
+    DCHECK(!image_loading_thread_pool_in_use_);
+    image_loading_thread_pool_.reset();
+  }
   if (jit_ != nullptr) {
     ScopedTrace trace2("Delete jit");
     VLOG(jit) << "Deleting jit thread pool";
@@ -300,6 +311,15 @@ Runtime::~Runtime() {
     // Similarly, stop the profile saver thread before deleting the thread list.
     jit_->StopProfileSaver();
   }
+  if (background_verifier_ != nullptr) {
+    std::unique_ptr<verifier::BackgroundVerifier> background_verifier;
+    {
+      ScopedSuspendAll ssa(__FUNCTION__);
+      // Clear the field while the threads are suspended, as class loading checks it.
+      background_verifier = std::move(background_verifier_);
+    }
+    background_verifier->Stop(self);
+  }
 
   // Make sure our internal threads are dead before we start tearing down things they're using.
   Dbg::StopJdwp();
@@ -453,6 +473,44 @@ void Runtime::Abort(const char* msg) {
 
 void Runtime::PreZygoteFork() {
   heap_->PreZygoteFork();
+  // The workers of the image loading thread pool do not survive the fork.
+  Thread* self = Thread::Current();
+  std::unique_ptr<ThreadPool> image_loading_thread_pool;
+  {
+    MutexLock mu(self, image_loading_thread_pool_lock_);
+    image_loading_thread_pool = std::move(image_loading_thread_pool_);
+  }
+  if (image_loading_thread_pool != nullptr) {
+    // The workers detach from the runtime when joined, do not hold the mutator lock meanwhile.
+    ScopedThreadStateChange tsc(self, kNative);
+    image_loading_thread_pool.reset();
+  }
+}
+
+std::unique_ptr<ThreadPool> Runtime::AcquireImageLoadingThreadPool(Thread* self) {
+  if (image_loading_threads_ == 0u) {
+    return nullptr;
+  }
+  {
+    MutexLock mu(self, image_loading_thread_pool_lock_);
+    if (image_loading_thread_pool_in_use_) {
+      return nullptr;
+    }
+    image_loading_thread_pool_in_use_ = true;
+    if (image_loading_thread_pool_ != nullptr) {
+      return std::move(image_loading_thread_pool_);
+    }
+  }
+  return std::unique_ptr<ThreadPool>(
+      new ThreadPool("Image loading thread pool", image_loading_threads_));
+}
+
+void Runtime::ReleaseImageLoadingThreadPool(Thread* self, std::unique_ptr<ThreadPool> thread_pool) {
+  MutexLock mu(self, image_loading_thread_pool_lock_);
+  DCHECK(image_loading_thread_pool_in_use_);
+  DCHECK(image_loading_thread_pool_ == nullptr);
+  image_loading_thread_pool_ = std::move(thread_pool);
+  image_loading_thread_pool_in_use_ = false;
 }
 
 void Runtime::CallExitHook(jint status) {
@@ -759,6 +817,10 @@ void Runtime::InitNonZygoteOrPostFork(
     CreateJit();
   }
 
+  if (background_verifier_ == nullptr) {
+    CreateBackgroundVerifier();
+  }
+
   StartSignalCatcher();
 
   // Start the JDWP thread. If the command-line debugger flags specified "suspend=y",
@@ -984,6 +1046,9 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   intern_table_ = new InternTable;
 
   verify_ = runtime_options.GetOrDefault(Opt::Verify);
+  background_verification_threads_ =
+      runtime_options.GetOrDefault(Opt::BackgroundVerificationThreads);
+  image_loading_threads_ = runtime_options.GetOrDefault(Opt::ImageLoadingThreads);
   allow_dex_file_fallback_ = !runtime_options.Exists(Opt::NoDexFileFallback);
 
   no_sig_chain_ = runtime_options.Exists(Opt::NoSigChain);
@@ -1033,6 +1098,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
                        runtime_options.Exists(Opt::IgnoreMaxFootprint),
                        runtime_options.GetOrDefault(Opt::UseTLAB),
+                       runtime_options.GetOrDefault(Opt::UseGenerationalCC),
+                       runtime_options.GetOrDefault(Opt::EvacuateLivePercentThreshold),
                        xgc_option.verify_pre_gc_heap_,
                        xgc_option.verify_pre_sweeping_heap_,
                        xgc_option.verify_post_gc_heap_,
@@ -1431,6 +1498,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   }
   TrackedAllocators::Dump(os);
   os << "\n";
+  Monitor::DumpContentionProfile(os);
 
   thread_list_->DumpForSigQuit(os);
   BaseMutex::DumpAll(os);
@@ -1951,6 +2019,13 @@ void Runtime::AddCurrentRuntimeFeaturesAsDex2OatArguments(std::vector<std::strin
   argv->push_back(feature_string);
 }
 
+void Runtime::CreateBackgroundVerifier() {
+  DCHECK(background_verifier_ == nullptr);
+  if (background_verification_threads_ != 0 && IsVerificationEnabled()) {
+    background_verifier_.reset(new verifier::BackgroundVerifier(background_verification_threads_));
+  }
+}
+
 void Runtime::CreateJit() {
   CHECK(!IsAotCompiler());
   if (kIsDebugBuild && GetInstrumentation()->IsForcedInterpretOnly()) {
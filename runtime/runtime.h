@@ -69,6 +69,7 @@ namespace mirror {
   class Throwable;
 }  // namespace mirror
 namespace verifier {
+  class BackgroundVerifier;
   class MethodVerifier;
   enum class VerifyMode : int8_t;
 }  // namespace verifier
@@ -90,6 +91,7 @@ class SignalCatcher;
 class StackOverflowHandler;
 class SuspensionHandler;
 class ThreadList;
+class ThreadPool;
 class Trace;
 struct TraceConfig;
 class Transaction;
@@ -531,6 +533,21 @@ class Runtime {
   bool IsVerificationEnabled() const;
   bool IsVerificationSoftFail() const;
 
+  // Returns the verifier of the classes of freshly loaded dex files, or null if classes
+  // are only verified at first use.
+  verifier::BackgroundVerifier* GetBackgroundVerifier() const {
+    return background_verifier_.get();
+  }
+
+  // Returns the thread pool that decompresses and relocates app images, creating it if needed.
+  // Returns null if -XX:ImageLoadingThreads is 0, or if another thread is loading an image with
+  // the pool. Must not be called with the mutator lock held, as creating the pool waits for the
+  // workers to attach. The pool must be given back with ReleaseImageLoadingThreadPool.
+  std::unique_ptr<ThreadPool> AcquireImageLoadingThreadPool(Thread* self)
+      REQUIRES(!image_loading_thread_pool_lock_);
+  void ReleaseImageLoadingThreadPool(Thread* self, std::unique_ptr<ThreadPool> thread_pool)
+      REQUIRES(!image_loading_thread_pool_lock_);
+
   bool IsDexFileFallbackEnabled() const {
     return allow_dex_file_fallback_;
   }
@@ -566,6 +583,9 @@ class Runtime {
   // Create the JIT and instrumentation and code cache.
   void CreateJit();
 
+  // Create the background verifier if enabled by -XX:BackgroundVerificationThreads.
+  void CreateBackgroundVerifier();
+
   ArenaPool* GetArenaPool() {
     return arena_pool_.get();
   }
@@ -810,6 +830,19 @@ class Runtime {
   // If kNone, verification is disabled. kEnable by default.
   verifier::VerifyMode verify_;
 
+  // Number of threads verifying dex files without verified oat code ahead of first use.
+  // 0 if classes are only verified at first use.
+  unsigned int background_verification_threads_;
+  std::unique_ptr<verifier::BackgroundVerifier> background_verifier_;
+
+  // Number of threads decompressing and relocating app images with the loading thread. The pool
+  // is kept between loads, with its workers stopped.
+  unsigned int image_loading_threads_;
+  Mutex image_loading_thread_pool_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::unique_ptr<ThreadPool> image_loading_thread_pool_
+      GUARDED_BY(image_loading_thread_pool_lock_);
+  bool image_loading_thread_pool_in_use_ GUARDED_BY(image_loading_thread_pool_lock_);
+
   // If true, the runtime may use dex files directly with the interpreter if an oat file is not
   // available/usable.
   bool allow_dex_file_fallback_;
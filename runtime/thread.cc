@@ -2569,6 +2569,7 @@ void Thread::DumpThreadOffset(std::ostream& os, uint32_t offset) {
   QUICK_ENTRY_POINT_INFO(pReadBarrierMark)
   QUICK_ENTRY_POINT_INFO(pReadBarrierSlow)
   QUICK_ENTRY_POINT_INFO(pReadBarrierForRootSlow)
+  QUICK_ENTRY_POINT_INFO(pCompileOptimized)
 #undef QUICK_ENTRY_POINT_INFO
 
   os << offset;
@@ -2879,6 +2880,13 @@ void Thread::VisitRoots(RootVisitor* visitor) {
   for (instrumentation::InstrumentationStackFrame& frame : *GetInstrumentationStack()) {
     visitor->VisitRootIfNonNull(&frame.this_object_, RootInfo(kRootVMInternal, thread_id));
   }
+  // The interpreter, class lookup and verifier caches hold classes which are not roots, and
+  // which the GC may move or unload once it has visited the roots.
+  interpreter_cache_.Clear();
+  class_lookup_cache_.Clear();
+  if (verifier_class_cache_ != nullptr) {
+    verifier_class_cache_->Clear();
+  }
 }
 
 class VerifyRootVisitor : public SingleRootVisitor {
@@ -30,17 +30,20 @@
 #include "atomic.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "class_lookup_cache.h"
 #include "entrypoints/jni/jni_entrypoints.h"
 #include "entrypoints/quick/quick_entrypoints.h"
 #include "globals.h"
 #include "handle_scope.h"
 #include "instrumentation.h"
+#include "interpreter/interpreter_cache.h"
 #include "jvalue.h"
 #include "object_callbacks.h"
 #include "offsets.h"
 #include "runtime_stats.h"
 #include "stack.h"
 #include "thread_state.h"
+#include "verifier/resolved_class_cache.h"
 
 class BacktraceMap;
 
@@ -1061,6 +1064,31 @@ class Thread {
     return tlsPtr_.mterp_alt_ibase;
   }
 
+  interpreter::InterpreterCache* GetInterpreterCache() {
+    return &interpreter_cache_;
+  }
+
+  ClassLookupCache* GetClassLookupCache() {
+    return &class_lookup_cache_;
+  }
+
+  // Return the cache of classes resolved by the verifier on this thread, or null if
+  // `create_if_needed` is false and the thread has not verified any method yet.
+  verifier::ResolvedClassCache* GetVerifierClassCache(bool create_if_needed) {
+    if (verifier_class_cache_ == nullptr && create_if_needed) {
+      verifier_class_cache_.reset(new verifier::ResolvedClassCache());
+    }
+    return verifier_class_cache_.get();
+  }
+
+  int64_t GetAllocRecordSampleBytesLeft() const {
+    return alloc_record_sample_bytes_left_;
+  }
+
+  void SetAllocRecordSampleBytesLeft(int64_t bytes) {
+    alloc_record_sample_bytes_left_ = bytes;
+  }
+
   void NoteSignalBeingHandled() {
     if (tls32_.handling_signal_) {
       LOG(FATAL) << "Detected signal while processing a signal";
@@ -1518,6 +1546,20 @@ class Thread {
   // Debug disable read barrier count, only is checked for debug builds and only in the runtime.
   uint8_t debug_disallow_read_barrier_ = 0;
 
+  // Inline caches for the invokes executed by the interpreter on this thread.
+  interpreter::InterpreterCache interpreter_cache_;
+
+  // Classes recently found by ClassLinker::LookupClass on this thread.
+  ClassLookupCache class_lookup_cache_;
+
+  // Classes resolved by the verifier on this thread. Only allocated for threads that
+  // verify methods.
+  std::unique_ptr<verifier::ResolvedClassCache> verifier_class_cache_;
+
+  // Bytes left to allocate before the allocation tracker samples an allocation of this thread,
+  // or 0 if the distance to the next sample has not been drawn yet.
+  int64_t alloc_record_sample_bytes_left_ = 0;
+
   friend class Dbg;  // For SetStateUnsafe.
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
@@ -105,6 +105,18 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
   tasks_.clear();
 }
 
+void ThreadPool::RemoveAndFinalizeAllTasks(Thread* self) {
+  std::deque<Task*> tasks;
+  {
+    MutexLock mu(self, task_queue_lock_);
+    tasks.swap(tasks_);
+  }
+  // Finalize outside of the lock, tasks may take other locks when releasing their resources.
+  for (Task* task : tasks) {
+    task->Finalize();
+  }
+}
+
 ThreadPool::ThreadPool(const char* name, size_t num_threads)
   : name_(name),
     task_queue_lock_("task queue lock"),
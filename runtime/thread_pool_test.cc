@@ -98,6 +98,44 @@ TEST_F(ThreadPoolTest, StopStart) {
   thread_pool.Wait(self, false, false);
 }
 
+class FinalizeCountTask : public Task {
+ public:
+  FinalizeCountTask(AtomicInteger* run_count, AtomicInteger* finalize_count)
+      : run_count_(run_count), finalize_count_(finalize_count) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) {
+    ++*run_count_;
+  }
+
+  void Finalize() {
+    ++*finalize_count_;
+    delete this;
+  }
+
+ private:
+  AtomicInteger* const run_count_;
+  AtomicInteger* const finalize_count_;
+};
+
+// Check that removed tasks are finalized without being run.
+TEST_F(ThreadPoolTest, RemoveAndFinalizeAllTasks) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool", num_threads);
+  AtomicInteger run_count(0);
+  AtomicInteger finalize_count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new FinalizeCountTask(&run_count, &finalize_count));
+  }
+  thread_pool.RemoveAndFinalizeAllTasks(self);
+  EXPECT_EQ(0u, thread_pool.GetTaskCount(self));
+  EXPECT_EQ(num_tasks, finalize_count.LoadSequentiallyConsistent());
+  // Nothing is left for the workers to run.
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ(0, run_count.LoadSequentiallyConsistent());
+}
+
 class TreeTask : public Task {
  public:
   TreeTask(ThreadPool* const thread_pool, AtomicInteger* count, int depth)
@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -54,7 +55,7 @@ class BuildStackTraceVisitor : public StackVisitor {
  public:
   explicit BuildStackTraceVisitor(Thread* thread)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-        method_trace_(Trace::AllocStackTrace()) {}
+        method_trace_(new std::vector<ArtMethod*>()) {}
 
   bool VisitFrame() SHARED_REQUIRES(Locks::mutator_lock_) {
     ArtMethod* m = GetMethod();
@@ -88,7 +89,6 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -124,16 +124,6 @@ uint32_t Trace::EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action
   return tmid;
 }
 
-std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
-}
-
-void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
-  stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
-}
-
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
 #if defined(__linux__)
   default_clock_source_ = clock_source;
@@ -219,13 +209,28 @@ static void Append8LE(uint8_t* buf, uint64_t val) {
   *buf++ = static_cast<uint8_t>(val >> 56);
 }
 
-static void GetSample(Thread* thread, void* arg) SHARED_REQUIRES(Locks::mutator_lock_) {
-  BuildStackTraceVisitor build_trace_visitor(thread);
-  build_trace_visitor.WalkStack();
-  std::vector<ArtMethod*>* stack_trace = build_trace_visitor.GetStackTrace();
-  Trace* the_trace = reinterpret_cast<Trace*>(arg);
-  the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
-}
+// Checkpoint taking a stack trace sample of a thread. Runnable threads sample themselves at
+// their next suspend point, while the sampling thread samples the suspended ones, so that
+// sampling does not need to suspend all threads.
+class SampleCheckpoint FINAL : public Closure {
+ public:
+  SampleCheckpoint(Trace* trace, Barrier* barrier) : trace_(trace), barrier_(barrier) {}
+
+  void Run(Thread* thread) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    // Note thread and self may differ if thread was already suspended.
+    Thread* self = Thread::Current();
+    BuildStackTraceVisitor build_trace_visitor(thread);
+    build_trace_visitor.WalkStack();
+    trace_->CompareAndUpdateStackTrace(thread, build_trace_visitor.GetStackTrace());
+    barrier_->Pass(self);
+  }
+
+ private:
+  Trace* const trace_;
+  Barrier* const barrier_;
+
+  DISALLOW_COPY_AND_ASSIGN(SampleCheckpoint);
+};
 
 static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
   thread->SetTraceClockBase(0);
@@ -236,7 +241,8 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUT
 
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  // Only called by the thread itself, or by the sampling thread while the thread is suspended,
+  // so the thread's previous sample and clock base are never accessed concurrently.
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -271,7 +277,7 @@ void Trace::CompareAndUpdateStackTrace(Thread* thread,
       LogMethodTraceEvent(thread, *rit, instrumentation::Instrumentation::kMethodEntered,
                           thread_clock_diff, wall_clock_diff);
     }
-    FreeStackTrace(old_stack_trace);
+    delete old_stack_trace;
   }
 }
 
@@ -295,9 +301,15 @@ void* Trace::RunSamplingThread(void* arg) {
       }
     }
     {
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      ScopedObjectAccess soa(self);
+      Barrier barrier(0);
+      SampleCheckpoint checkpoint(the_trace, &barrier);
+      size_t barrier_count = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+      if (barrier_count != 0) {
+        // Wait for all threads to take their sample: the trace must outlive the checkpoints.
+        ScopedThreadStateChange tsc(self, kWaitingForCheckPointsToRun);
+        barrier.Increment(self, barrier_count);
+      }
     }
   }
 
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "background_verifier.h"
+
+#include "compiler_filter.h"
+#include "dex_file.h"
+#include "java_vm_ext.h"
+#include "method_verifier.h"
+#include "mirror/class-inl.h"
+#include "oat_file.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "thread.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace verifier {
+
+// Maximum number of classes waiting for verification. Each one holds a global reference, and
+// an app defining classes faster than the pool verifies them gains nothing from queuing more.
+// Classes not scheduled are verified at their first use.
+static constexpr size_t kMaxPendingClasses = 1024;
+
+// Maximum number of verified classes waiting for their first use. Classes that are defined but
+// never initialized, like most interfaces, would otherwise hold global references forever.
+static constexpr size_t kMaxVerifiedClasses = 4096;
+
+class BackgroundVerificationTask FINAL : public Task {
+ public:
+  BackgroundVerificationTask(BackgroundVerifier* background_verifier, jobject klass)
+      : background_verifier_(background_verifier), klass_(klass) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    mirror::Class* klass = soa.Decode<mirror::Class*>(klass_);
+    if (klass->IsVerified() || klass->IsErroneous()) {
+      // Already verified or initialized by its first use.
+      return;
+    }
+    // Verify without loading classes, so that the app does not see classes loaded early.
+    // Types not loaded yet are unresolved and cause soft failures, and failures are left to
+    // the first use of the class to report.
+    std::string error_msg;
+    MethodVerifier::FailureKind failure =
+        MethodVerifier::VerifyClass(self,
+                                    klass,
+                                    /* callbacks */ nullptr,
+                                    /* can_load_classes */ false,
+                                    /* allow_soft_failures */ false,
+                                    LogSeverity::NONE,
+                                    &error_msg);
+    self->ClearException();
+    if (failure == MethodVerifier::kNoFailure) {
+      background_verifier_->AddVerifiedClass(self, klass, klass_);
+      klass_ = nullptr;
+    }
+  }
+
+  // Also called for tasks removed from the queue without running.
+  void Finalize() OVERRIDE {
+    if (klass_ != nullptr) {
+      Runtime::Current()->GetJavaVM()->DeleteGlobalRef(Thread::Current(), klass_);
+    }
+    delete this;
+  }
+
+ private:
+  BackgroundVerifier* const background_verifier_;
+  jobject klass_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationTask);
+};
+
+BackgroundVerifier::BackgroundVerifier(size_t num_threads)
+    : thread_pool_(new ThreadPool("Background verification thread pool", num_threads)),
+      lock_("background verifier lock") {
+  thread_pool_->StartWorkers(Thread::Current());
+}
+
+BackgroundVerifier::~BackgroundVerifier() {
+  Stop(Thread::Current());
+}
+
+bool BackgroundVerifier::NeedsVerification(const DexFile& dex_file) {
+  const OatFile::OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  return oat_dex_file == nullptr ||
+      oat_dex_file->GetOatFile() == nullptr ||
+      !CompilerFilter::IsVerificationEnabled(oat_dex_file->GetOatFile()->GetCompilerFilter());
+}
+
+void BackgroundVerifier::VerifyClass(Thread* self, mirror::Class* klass) {
+  DCHECK(klass->IsResolved());
+  if (thread_pool_->GetTaskCount(self) >= kMaxPendingClasses) {
+    return;
+  }
+  // The global reference keeps the class, and with it its class loader and dex file, alive
+  // until the task is finalized.
+  jobject global_ref = Runtime::Current()->GetJavaVM()->AddGlobalRef(self, klass);
+  thread_pool_->AddTask(self, new BackgroundVerificationTask(this, global_ref));
+}
+
+void BackgroundVerifier::AddVerifiedClass(Thread* self, mirror::Class* klass, jobject global_ref) {
+  {
+    MutexLock mu(self, lock_);
+    if (verified_classes_.size() < kMaxVerifiedClasses &&
+        verified_classes_.emplace(klass->GetClassDef(), global_ref).second) {
+      return;
+    }
+  }
+  Runtime::Current()->GetJavaVM()->DeleteGlobalRef(self, global_ref);
+}
+
+bool BackgroundVerifier::TakeVerifiedClass(Thread* self, mirror::Class* klass) {
+  jobject global_ref;
+  {
+    MutexLock mu(self, lock_);
+    auto it = verified_classes_.find(klass->GetClassDef());
+    if (it == verified_classes_.end()) {
+      return false;
+    }
+    global_ref = it->second;
+    if (self->DecodeJObject(global_ref) != klass) {
+      // The same class def defined by another class loader.
+      return false;
+    }
+    verified_classes_.erase(it);
+  }
+  Runtime::Current()->GetJavaVM()->DeleteGlobalRef(self, global_ref);
+  return true;
+}
+
+void BackgroundVerifier::Wait(Thread* self) {
+  thread_pool_->Wait(self, /* do_work */ false, /* may_hold_locks */ false);
+}
+
+void BackgroundVerifier::Stop(Thread* self) {
+  if (thread_pool_ != nullptr) {
+    thread_pool_->StopWorkers(self);
+    // Finalizing the pending tasks releases their class references.
+    thread_pool_->RemoveAndFinalizeAllTasks(self);
+    thread_pool_->Wait(self, false, false);
+    thread_pool_.reset();
+  }
+  std::unordered_map<const DexFile::ClassDef*, jobject> verified_classes;
+  {
+    MutexLock mu(self, lock_);
+    verified_classes.swap(verified_classes_);
+  }
+  for (const auto& entry : verified_classes) {
+    Runtime::Current()->GetJavaVM()->DeleteGlobalRef(self, entry.second);
+  }
+}
+
+}  // namespace verifier
+}  // namespace art
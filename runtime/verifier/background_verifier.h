@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_VERIFIER_BACKGROUND_VERIFIER_H_
+#define ART_RUNTIME_VERIFIER_BACKGROUND_VERIFIER_H_
+
+#include <memory>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex_file.h"
+#include "jni.h"
+
+namespace art {
+
+class Thread;
+class ThreadPool;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+namespace verifier {
+
+// Verifies classes loaded from dex files without verified oat code on a thread pool, ahead
+// of their first use. Otherwise, each class gets verified by the first thread that initializes
+// it, which serializes verification of the whole app on the main thread during startup.
+//
+// Only classes already defined by their class loader are verified, and without loading the
+// types they refer to, as loading a class early is visible to the app. The class status is left
+// alone: like the class status in an oat file, a successful verification is recorded and
+// consumed by the class linker when the class is first used.
+class BackgroundVerifier {
+ public:
+  explicit BackgroundVerifier(size_t num_threads);
+  ~BackgroundVerifier();
+
+  // Returns whether the classes of `dex_file` would otherwise be verified at first use.
+  static bool NeedsVerification(const DexFile& dex_file);
+
+  // Schedule verification of `klass`, which has just been defined and linked.
+  void VerifyClass(Thread* self, mirror::Class* klass) SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Returns whether `klass` was verified without failures, and forgets about it.
+  bool TakeVerifiedClass(Thread* self, mirror::Class* klass)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Wait until the scheduled classes have been verified.
+  void Wait(Thread* self) REQUIRES(!Locks::mutator_lock_);
+
+  // Drop pending tasks without running them, and wait for running ones to finish.
+  void Stop(Thread* self) REQUIRES(!lock_);
+
+ private:
+  // Record that `klass`, held by the global reference, was verified without failures. Takes
+  // ownership of the reference.
+  void AddVerifiedClass(Thread* self, mirror::Class* klass, jobject global_ref)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  std::unique_ptr<ThreadPool> thread_pool_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  // Classes verified without failures, by class def. The global reference keeps the class, and
+  // with it its dex file, alive, so that the class def is not reused for another class.
+  std::unordered_map<const DexFile::ClassDef*, jobject> verified_classes_ GUARDED_BY(lock_);
+
+  friend class BackgroundVerificationTask;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundVerifier);
+};
+
+}  // namespace verifier
+}  // namespace art
+
+#endif  // ART_RUNTIME_VERIFIER_BACKGROUND_VERIFIER_H_
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "background_verifier.h"
+
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "scoped_thread_state_change.h"
+#include "utf.h"
+
+namespace art {
+namespace verifier {
+
+class BackgroundVerifierTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:BackgroundVerificationThreads=2", nullptr));
+  }
+
+  bool IsDefined(const char* descriptor, mirror::ClassLoader* class_loader)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    return class_linker_->LookupClass(Thread::Current(),
+                                      descriptor,
+                                      ComputeModifiedUtf8Hash(descriptor),
+                                      class_loader) != nullptr;
+  }
+};
+
+TEST_F(BackgroundVerifierTest, VerifiesDefinedClassesOnly) {
+  // The runtime creates the background verifier when it starts, which gtests do not do.
+  runtime_->CreateBackgroundVerifier();
+  BackgroundVerifier* background_verifier = runtime_->GetBackgroundVerifier();
+  ASSERT_TRUE(background_verifier != nullptr);
+
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<4> hs(self);
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader*>(LoadDex("Interfaces"))));
+  {
+    ScopedThreadSuspension sts(self, kNative);
+    background_verifier->Wait(self);
+  }
+  // Registering the dex file does not define any of its classes.
+  EXPECT_FALSE(IsDefined("LInterfaces;", class_loader.Get()));
+  EXPECT_FALSE(IsDefined("LInterfaces$I;", class_loader.Get()));
+  EXPECT_FALSE(IsDefined("LInterfaces$A;", class_loader.Get()));
+
+  // Defining A defines its interfaces I and J, and schedules the three for verification.
+  Handle<mirror::Class> a(
+      hs.NewHandle(class_linker_->FindClass(self, "LInterfaces$A;", class_loader)));
+  ASSERT_TRUE(a.Get() != nullptr);
+  ASSERT_TRUE(BackgroundVerifier::NeedsVerification(a->GetDexFile()));
+  Handle<mirror::Class> i(
+      hs.NewHandle(class_linker_->FindClass(self, "LInterfaces$I;", class_loader)));
+  ASSERT_TRUE(i.Get() != nullptr);
+  Handle<mirror::Class> j(
+      hs.NewHandle(class_linker_->FindClass(self, "LInterfaces$J;", class_loader)));
+  ASSERT_TRUE(j.Get() != nullptr);
+  {
+    ScopedThreadSuspension sts(self, kNative);
+    background_verifier->Wait(self);
+  }
+  // The status is left to the first use.
+  EXPECT_FALSE(a->IsVerified());
+  EXPECT_FALSE(i->IsVerified());
+
+  // The interfaces were verified in the background, and the result is only handed out once.
+  EXPECT_TRUE(background_verifier->TakeVerifiedClass(self, i.Get()));
+  EXPECT_FALSE(background_verifier->TakeVerifiedClass(self, i.Get()));
+  EXPECT_TRUE(background_verifier->TakeVerifiedClass(self, j.Get()));
+
+  // The class linker uses the result for A, instead of verifying it again with class loading.
+  class_linker_->VerifyClass(self, a);
+  EXPECT_FALSE(self->IsExceptionPending());
+  EXPECT_TRUE(a->IsVerified());
+  EXPECT_FALSE(a->IsInitialized());
+  EXPECT_FALSE(background_verifier->TakeVerifiedClass(self, a.Get()));
+
+  // Neither the background verification of A nor its verification by the class linker defined
+  // the types A refers to, or the other classes of the dex file.
+  EXPECT_FALSE(IsDefined("LInterfaces;", class_loader.Get()));
+  EXPECT_FALSE(IsDefined("LInterfaces$B;", class_loader.Get()));
+  EXPECT_FALSE(IsDefined("LInterfaces$K;", class_loader.Get()));
+}
+
+}  // namespace verifier
+}  // namespace art
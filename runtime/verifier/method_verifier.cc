@@ -121,6 +121,7 @@ static void SafelyMarkAllRegistersAsConflicts(MethodVerifier* verifier, Register
 MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                                                         mirror::Class* klass,
                                                         CompilerCallbacks* callbacks,
+                                                        bool can_load_classes,
                                                         bool allow_soft_failures,
                                                         LogSeverity log_level,
                                                         std::string* error) {
@@ -160,6 +161,7 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                      class_loader,
                      class_def,
                      callbacks,
+                     can_load_classes,
                      allow_soft_failures,
                      log_level,
                      error);
@@ -194,6 +196,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethods(Thread* self,
                                                           Handle<mirror::DexCache> dex_cache,
                                                           Handle<mirror::ClassLoader> class_loader,
                                                           CompilerCallbacks* callbacks,
+                                                          bool can_load_classes,
                                                           bool allow_soft_failures,
                                                           LogSeverity log_level,
                                                           bool need_precise_constants,
@@ -235,6 +238,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethods(Thread* self,
                                                       method,
                                                       it->GetMethodAccessFlags(),
                                                       callbacks,
+                                                      can_load_classes,
                                                       allow_soft_failures,
                                                       log_level,
                                                       need_precise_constants,
@@ -265,6 +269,7 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                                                         Handle<mirror::ClassLoader> class_loader,
                                                         const DexFile::ClassDef* class_def,
                                                         CompilerCallbacks* callbacks,
+                                                        bool can_load_classes,
                                                         bool allow_soft_failures,
                                                         LogSeverity log_level,
                                                         std::string* error) {
@@ -298,6 +303,7 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                                                           dex_cache,
                                                           class_loader,
                                                           callbacks,
+                                                          can_load_classes,
                                                           allow_soft_failures,
                                                           log_level,
                                                           false /* need precise constants */,
@@ -311,6 +317,7 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                                                            dex_cache,
                                                            class_loader,
                                                            callbacks,
+                                                           can_load_classes,
                                                            allow_soft_failures,
                                                            log_level,
                                                            false /* need precise constants */,
@@ -359,6 +366,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethod(Thread* self,
                                                          ArtMethod* method,
                                                          uint32_t method_access_flags,
                                                          CompilerCallbacks* callbacks,
+                                                         bool can_load_classes,
                                                          bool allow_soft_failures,
                                                          LogSeverity log_level,
                                                          bool need_precise_constants,
@@ -375,7 +383,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethod(Thread* self,
                           method_idx,
                           method,
                           method_access_flags,
-                          true /* can_load_classes */,
+                          can_load_classes,
                           allow_soft_failures,
                           need_precise_constants,
                           false /* verify to dump */,
@@ -1044,8 +1052,9 @@ bool MethodVerifier::ScanTryCatchBlocks() {
       }
       GetInstructionFlags(dex_pc).SetBranchTarget();
       // Ensure exception types are resolved so that they don't need resolution to be delivered,
-      // unresolved exception types will be ignored by exception delivery
-      if (iterator.GetHandlerTypeIndex() != DexFile::kDexNoIndex16) {
+      // unresolved exception types will be ignored by exception delivery. Without loading
+      // classes, the class linker resolves them when it marks the class verified.
+      if (can_load_classes_ && iterator.GetHandlerTypeIndex() != DexFile::kDexNoIndex16) {
         mirror::Class* exception_type = linker->ResolveType(*dex_file_,
                                                             iterator.GetHandlerTypeIndex(),
                                                             dex_cache_, class_loader_);
@@ -3525,16 +3534,24 @@ bool MethodVerifier::CodeFlowVerifyInstruction(uint32_t* start_guess) {
         has_catch_all_handler = true;
       } else {
         // It is also a catch-all if it is java.lang.Throwable.
-        mirror::Class* klass = linker->ResolveType(*dex_file_, handler_type_idx, dex_cache_,
-                                                   class_loader_);
-        if (klass != nullptr) {
-          if (klass == mirror::Throwable::GetJavaLangThrowable()) {
+        if (!can_load_classes_) {
+          // Without loading the type, compare descriptors. Only the boot class path can define
+          // java.lang classes.
+          if (strcmp(dex_file_->StringByTypeIdx(handler_type_idx), "Ljava/lang/Throwable;") == 0) {
             has_catch_all_handler = true;
           }
         } else {
-          // Clear exception.
-          DCHECK(self_->IsExceptionPending());
-          self_->ClearException();
+          mirror::Class* klass = linker->ResolveType(*dex_file_, handler_type_idx, dex_cache_,
+                                                     class_loader_);
+          if (klass != nullptr) {
+            if (klass == mirror::Throwable::GetJavaLangThrowable()) {
+              has_catch_all_handler = true;
+            }
+          } else {
+            // Clear exception.
+            DCHECK(self_->IsExceptionPending());
+            self_->ClearException();
+          }
         }
       }
       /*
@@ -150,10 +150,12 @@ class MethodVerifier {
     return (encountered_failure_types & (~unresolved_mask)) == 0;
   }
 
-  // Verify a class. Returns "kNoFailure" on success.
+  // Verify a class. Returns "kNoFailure" on success. Without `can_load_classes`, types that are
+  // not loaded yet are treated as unresolved instead of being loaded.
   static FailureKind VerifyClass(Thread* self,
                                  mirror::Class* klass,
                                  CompilerCallbacks* callbacks,
+                                 bool can_load_classes,
                                  bool allow_soft_failures,
                                  LogSeverity log_level,
                                  std::string* error)
@@ -164,6 +166,7 @@ class MethodVerifier {
                                  Handle<mirror::ClassLoader> class_loader,
                                  const DexFile::ClassDef* class_def,
                                  CompilerCallbacks* callbacks,
+                                 bool can_load_classes,
                                  bool allow_soft_failures,
                                  LogSeverity log_level,
                                  std::string* error)
@@ -338,6 +341,7 @@ class MethodVerifier {
                                    Handle<mirror::DexCache> dex_cache,
                                    Handle<mirror::ClassLoader> class_loader,
                                    CompilerCallbacks* callbacks,
+                                   bool can_load_classes,
                                    bool allow_soft_failures,
                                    LogSeverity log_level,
                                    bool need_precise_constants,
@@ -364,6 +368,7 @@ class MethodVerifier {
                                   ArtMethod* method,
                                   uint32_t method_access_flags,
                                   CompilerCallbacks* callbacks,
+                                  bool can_load_classes,
                                   bool allow_soft_failures,
                                   LogSeverity log_level,
                                   bool need_precise_constants,
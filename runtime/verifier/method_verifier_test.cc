@@ -41,6 +41,7 @@ class MethodVerifierTest : public CommonRuntimeTest {
                                                                       klass,
                                                                       nullptr,
                                                                       true,
+                                                                      true,
                                                                       LogSeverity::WARNING,
                                                                       &error_msg);
     ASSERT_TRUE(failure == MethodVerifier::kNoFailure) << error_msg;
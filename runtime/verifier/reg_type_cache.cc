@@ -26,6 +26,7 @@
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "reg_type-inl.h"
+#include "resolved_class_cache.h"
 
 namespace art {
 namespace verifier {
@@ -148,19 +149,30 @@ mirror::Class* RegTypeCache::ResolveClass(const char* descriptor, mirror::ClassL
   // Try resolving class
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   Thread* self = Thread::Current();
+  // Methods verified by the same thread tend to refer to the same classes, so check the
+  // classes this thread resolved for previous methods before going to the class linker.
+  ResolvedClassCache* class_cache = self->GetVerifierClassCache(/* create_if_needed */ true);
+  const uint32_t hash = ComputeModifiedUtf8Hash(descriptor);
+  mirror::Class* klass = class_cache->Get(hash, loader, can_load_classes_);
+  if (klass != nullptr && klass->DescriptorEquals(descriptor) && !klass->IsErroneous()) {
+    class_cache->RecordHit();
+    return klass;
+  }
+  class_cache->RecordMiss();
   StackHandleScope<1> hs(self);
   Handle<mirror::ClassLoader> class_loader(hs.NewHandle(loader));
-  mirror::Class* klass = nullptr;
   if (can_load_classes_) {
     klass = class_linker->FindClass(self, descriptor, class_loader);
   } else {
-    klass = class_linker->LookupClass(self, descriptor, ComputeModifiedUtf8Hash(descriptor),
-                                      loader);
+    klass = class_linker->LookupClass(self, descriptor, hash, loader);
     if (klass != nullptr && !klass->IsResolved()) {
       // We found the class but without it being loaded its not safe for use.
       klass = nullptr;
     }
   }
+  if (klass != nullptr) {
+    class_cache->Set(hash, class_loader.Get(), can_load_classes_, klass);
+  }
   return klass;
 }
 
@@ -24,6 +24,7 @@
 #include "common_runtime_test.h"
 #include "reg_type_cache-inl.h"
 #include "reg_type-inl.h"
+#include "resolved_class_cache.h"
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 
@@ -463,6 +464,61 @@ TEST_F(RegTypeReferenceTest, JavalangString) {
   EXPECT_FALSE(ref_type_unintialized.IsUnresolvedAndUninitializedReference());
 }
 
+class NoopRootVisitor : public SingleRootVisitor {
+ public:
+  void VisitRoot(mirror::Object* root ATTRIBUTE_UNUSED,
+                 const RootInfo& info ATTRIBUTE_UNUSED) OVERRIDE {}
+};
+
+TEST_F(RegTypeReferenceTest, ResolvedClassesReusedAcrossMethods) {
+  // Each method is verified with its own RegTypeCache, the classes resolved for one method are
+  // found by the next method verified on the same thread through the thread's class cache.
+  Thread* self = Thread::Current();
+  ArenaStack stack(Runtime::Current()->GetArenaPool());
+  ScopedObjectAccess soa(self);
+  ResolvedClassCache* class_cache = self->GetVerifierClassCache(/* create_if_needed */ true);
+  ASSERT_TRUE(class_cache != nullptr);
+  class_cache->Clear();
+  const uint64_t hits = class_cache->GetHits();
+  const uint64_t misses = class_cache->GetMisses();
+  const char* const descriptor = "Ljava/util/ArrayList;";
+
+  mirror::Class* klass;
+  {
+    ScopedArenaAllocator allocator(&stack);
+    RegTypeCache first_method_cache(true, allocator);
+    const RegType& type = first_method_cache.FromDescriptor(nullptr, descriptor, false);
+    ASSERT_TRUE(type.HasClass());
+    klass = type.GetClass();
+  }
+  EXPECT_EQ(hits, class_cache->GetHits());
+  EXPECT_EQ(misses + 1u, class_cache->GetMisses());
+
+  {
+    ScopedArenaAllocator allocator(&stack);
+    RegTypeCache second_method_cache(true, allocator);
+    const RegType& type = second_method_cache.FromDescriptor(nullptr, descriptor, false);
+    ASSERT_TRUE(type.HasClass());
+    EXPECT_EQ(klass, type.GetClass());
+  }
+  EXPECT_EQ(hits + 1u, class_cache->GetHits());
+  EXPECT_EQ(misses + 1u, class_cache->GetMisses());
+
+  // Visiting the roots of the thread drops the cached classes, which the GC may move, so the
+  // next method resolves the class again.
+  NoopRootVisitor visitor;
+  self->VisitRoots(&visitor);
+  {
+    ScopedArenaAllocator allocator(&stack);
+    RegTypeCache third_method_cache(true, allocator);
+    const RegType& type = third_method_cache.FromDescriptor(nullptr, descriptor, false);
+    ASSERT_TRUE(type.HasClass());
+    EXPECT_EQ(klass, type.GetClass());
+  }
+  EXPECT_EQ(hits + 1u, class_cache->GetHits());
+  EXPECT_EQ(misses + 2u, class_cache->GetMisses());
+}
+
 TEST_F(RegTypeReferenceTest, JavalangObject) {
   // Add a class to the cache then look for the same class and make sure it is  a
   // Hit the second time. Then I am checking for the same effect when using
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_VERIFIER_RESOLVED_CLASS_CACHE_H_
+#define ART_RUNTIME_VERIFIER_RESOLVED_CLASS_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/direct_mapped_cache.h"
+#include "base/macros.h"
+
+namespace art {
+
+namespace mirror {
+class Class;
+class ClassLoader;
+}  // namespace mirror
+
+namespace verifier {
+
+// Classes the verifier resolved by descriptor on one thread. A RegTypeCache only lives as long
+// as the verification of one method, so without this cache every method verified by a thread
+// resolves the same common descriptors through the class linker again. Entries are keyed by the
+// descriptor hash, the class loader, and whether the lookup was allowed to load classes, as a
+// lookup that cannot load classes must not see classes it could not have found itself.
+//
+// The verifier reports the classes of its RegTypeCache as roots, but not the ones kept here:
+// they are dropped by Thread::VisitRoots instead, and resolved again by the next method.
+class ResolvedClassCache {
+ public:
+  ResolvedClassCache() : hits_(0u), misses_(0u) {}
+
+  // Return the cached class for `descriptor`, or null if not cached. The caller checks
+  // that the class matches the descriptor, as different descriptors may share a hash.
+  mirror::Class* Get(uint32_t hash, mirror::ClassLoader* loader, bool can_load_classes) {
+    const Entry& entry = cache_.GetEntry(hash);
+    if (entry.hash == hash &&
+        entry.loader == loader &&
+        entry.can_load_classes == can_load_classes &&
+        entry.klass != nullptr) {
+      return entry.klass;
+    }
+    return nullptr;
+  }
+
+  void Set(uint32_t hash,
+           mirror::ClassLoader* loader,
+           bool can_load_classes,
+           mirror::Class* klass) {
+    Entry& entry = cache_.GetEntry(hash);
+    entry.klass = klass;
+    entry.loader = loader;
+    entry.hash = hash;
+    entry.can_load_classes = can_load_classes;
+  }
+
+  void Clear() {
+    cache_.Clear();
+  }
+
+  void RecordHit() {
+    ++hits_;
+  }
+
+  void RecordMiss() {
+    ++misses_;
+  }
+
+  uint64_t GetHits() const {
+    return hits_;
+  }
+
+  uint64_t GetMisses() const {
+    return misses_;
+  }
+
+  static constexpr size_t kSize = 512;
+
+ private:
+  struct Entry {
+    mirror::Class* klass;
+    mirror::ClassLoader* loader;
+    uint32_t hash;
+    bool can_load_classes;
+  };
+
+  DirectMappedCache<Entry, kSize> cache_;
+
+  // Statistics, reported by the compiler driver once verification is done.
+  uint64_t hits_;
+  uint64_t misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResolvedClassCache);
+};
+
+}  // namespace verifier
+}  // namespace art
+
+#endif  // ART_RUNTIME_VERIFIER_RESOLVED_CLASS_CACHE_H_
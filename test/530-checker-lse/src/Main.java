@@ -78,7 +78,7 @@ public class Main {
   /// CHECK: InstanceFieldGet
 
   /// CHECK-START: double Main.calcCircleArea(double) load_store_elimination (after)
-  /// CHECK: NewInstance
+  /// CHECK-NOT: NewInstance
   /// CHECK-NOT: InstanceFieldSet
   /// CHECK-NOT: InstanceFieldGet
 
@@ -137,7 +137,7 @@ public class Main {
   /// CHECK: InstanceFieldGet
 
   /// CHECK-START: int Main.test3(TestClass) load_store_elimination (after)
-  /// CHECK: NewInstance
+  /// CHECK-NOT: NewInstance
   /// CHECK: StaticFieldGet
   /// CHECK: NewInstance
   /// CHECK: InstanceFieldSet
@@ -150,7 +150,7 @@ public class Main {
   // A new allocation (even non-singleton) shouldn't alias with pre-existing values.
   static int test3(TestClass obj) {
     // Do an allocation here to avoid the HLoadClass and HClinitCheck
-    // at the second allocation.
+    // at the second allocation. The allocation itself is eliminated since it is unused.
     new TestClass();
     TestClass obj1 = TestClass.sTestClassObj;
     TestClass obj2 = new TestClass();  // Cannot alias with obj or obj1 which pre-exist.
@@ -256,7 +256,7 @@ public class Main {
   /// CHECK: InstanceFieldGet
 
   /// CHECK-START: int Main.test8() load_store_elimination (after)
-  /// CHECK: NewInstance
+  /// CHECK-NOT: NewInstance
   /// CHECK-NOT: InstanceFieldSet
   /// CHECK: InvokeVirtual
   /// CHECK-NOT: NullCheck
@@ -414,7 +414,7 @@ public class Main {
   /// CHECK: InstanceFieldGet
 
   /// CHECK-START: int Main.test16() load_store_elimination (after)
-  /// CHECK: NewInstance
+  /// CHECK-NOT: NewInstance
   /// CHECK-NOT: InstanceFieldSet
   /// CHECK-NOT: InstanceFieldGet
 
@@ -431,7 +431,7 @@ public class Main {
 
   /// CHECK-START: int Main.test17() load_store_elimination (after)
   /// CHECK: <<Const0:i\d+>> IntConstant 0
-  /// CHECK: NewInstance
+  /// CHECK-NOT: NewInstance
   /// CHECK-NOT: InstanceFieldSet
   /// CHECK-NOT: InstanceFieldGet
   /// CHECK: Return [<<Const0>>]
@@ -527,14 +527,8 @@ public class Main {
   /// CHECK: InstanceFieldGet
 
   /// CHECK-START: int Main.test22() load_store_elimination (after)
-  /// CHECK: NewInstance
+  /// CHECK-NOT: NewInstance
   /// CHECK-NOT: InstanceFieldSet
-  /// CHECK: NewInstance
-  /// CHECK-NOT: InstanceFieldSet
-  /// CHECK-NOT: InstanceFieldGet
-  /// CHECK: NewInstance
-  /// CHECK-NOT: InstanceFieldSet
-  /// CHECK-NOT: InstanceFieldGet
   /// CHECK-NOT: InstanceFieldGet
 
   // For a singleton, loop side effects can kill its field values only if:
@@ -566,23 +560,22 @@ public class Main {
   /// CHECK: InstanceFieldSet
 
   /// CHECK-START: int Main.test23(boolean) load_store_elimination (after)
-  /// CHECK: NewInstance
+  /// CHECK:     <<Phi:i\d+>> Phi
+  /// CHECK:                  Return [<<Phi>>]
+
+  /// CHECK-START: int Main.test23(boolean) load_store_elimination (after)
+  /// CHECK-NOT: NewInstance
   /// CHECK-NOT: InstanceFieldSet
   /// CHECK-NOT: InstanceFieldGet
-  /// CHECK: InstanceFieldSet
-  /// CHECK: InstanceFieldGet
-  /// CHECK: Return
-  /// CHECK-NOT: InstanceFieldGet
-  /// CHECK: InstanceFieldSet
 
   // Test store elimination on merging.
   static int test23(boolean b) {
     TestClass obj = new TestClass();
     obj.i = 3;      // This store can be eliminated since the value flows into each branch.
     if (b) {
-      obj.i += 1;   // This store cannot be eliminated due to the merge later.
+      obj.i += 1;   // This store can be eliminated since the merged value becomes a phi.
     } else {
-      obj.i += 2;   // This store cannot be eliminated due to the merge later.
+      obj.i += 2;   // This store can be eliminated since the merged value becomes a phi.
     }
     return obj.i;
   }
@@ -615,6 +608,50 @@ public class Main {
     return a;
   }
 
+  /// CHECK-START: int Main.test25(int) load_store_elimination (before)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test25(int) load_store_elimination (after)
+  /// CHECK-NOT: NewInstance
+  /// CHECK-NOT: InstanceFieldSet
+  /// CHECK-NOT: InstanceFieldGet
+
+  // A temporary allocated in a loop is replaced by the values of its fields.
+  static int test25(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      TestClass obj = new TestClass(i, i + 1);
+      sum += obj.i * obj.j;
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.test26(boolean) load_store_elimination (after)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  // The merged value of a field is killed by loop side effects, so the stores that
+  // provide it must be kept, and so must the allocation.
+  static int test26(boolean b) {
+    TestClass obj = new TestClass();
+    if (b) {
+      obj.i = 1;
+    } else {
+      obj.i = 2;
+    }
+    for (int i = 0; i < 3; i++) {
+      obj.i += obj.j;
+      obj.j = i;
+    }
+    return obj.i;
+  }
+
   /// CHECK-START: void Main.testFinalizable() load_store_elimination (before)
   /// CHECK: NewInstance
   /// CHECK: InstanceFieldSet
@@ -744,6 +781,9 @@ public class Main {
     assertIntEquals(test23(true), 4);
     assertIntEquals(test23(false), 5);
     assertFloatEquals(test24(), 8.0f);
+    assertIntEquals(test25(3), 8);
+    assertIntEquals(test26(true), 2);
+    assertIntEquals(test26(false), 3);
     testFinalizableByForcingGc();
     assertIntEquals($noinline$testHSelect(true), 0xdead);
   }
@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Tests for the vectorization of loops by the loop optimization pass. Vector
+// loops process 128 bits per iteration, that is 4 ints, 8 chars or shorts, or
+// 16 bytes, and leave the remaining iterations to the original loop.
+//
+public class Main {
+
+  //
+  // Loops over the whole array, which bounds check elimination removes all
+  // checks from, and which are thus vectorized.
+  //
+
+  /// CHECK-START-X86_64: void Main.addInt(int[], int) loop_optimization (before)
+  /// CHECK-NOT: VecLoad
+
+  /// CHECK-START-X86_64: void Main.addInt(int[], int) loop_optimization (after)
+  /// CHECK-DAG: VecReplicateScalar
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecAdd
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+
+  /// CHECK-START-ARM64: void Main.addInt(int[], int) loop_optimization (after)
+  /// CHECK-DAG: VecReplicateScalar
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecAdd
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+  private static void addInt(int[] a, int x) {
+    int n = a.length;
+    for (int i = 0; i < n; i++) {
+      a[i] += x;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.subByte(byte[], int) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecSub
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+
+  /// CHECK-START-ARM64: void Main.subByte(byte[], int) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecSub
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+  private static void subByte(byte[] b, int x) {
+    int n = b.length;
+    for (int i = 0; i < n; i++) {
+      b[i] -= x;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.xorChar(char[], int) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecXor
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+
+  /// CHECK-START-ARM64: void Main.xorChar(char[], int) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecXor
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+  private static void xorChar(char[] c, int x) {
+    int n = c.length;
+    for (int i = 0; i < n; i++) {
+      c[i] ^= x;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.mulShort(short[], int) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecMul
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+
+  /// CHECK-START-ARM64: void Main.mulShort(short[], int) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecMul
+  /// CHECK-DAG: VecStore
+  /// CHECK-DAG: ArrayGet
+  /// CHECK-DAG: ArraySet
+  private static void mulShort(short[] s, int x) {
+    int n = s.length;
+    for (int i = 0; i < n; i++) {
+      s[i] *= x;
+    }
+  }
+
+  //
+  // Reductions.
+  //
+
+  /// CHECK-START-X86_64: int Main.sum(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecReduce
+  /// CHECK-DAG: ArrayGet
+
+  /// CHECK-START-ARM64: int Main.sum(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecReduce
+  /// CHECK-DAG: ArrayGet
+  private static int sum(int[] a) {
+    int n = a.length;
+    int result = 0;
+    for (int i = 0; i < n; i++) {
+      result += a[i];
+    }
+    return result;
+  }
+
+  // Packed int min and max need SSE4.1 on x86-64, which is not always available.
+
+  /// CHECK-START-ARM64: int Main.min(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecReduce
+  /// CHECK-DAG: ArrayGet
+  private static int min(int[] a) {
+    int n = a.length;
+    int result = Integer.MAX_VALUE;
+    for (int i = 0; i < n; i++) {
+      result = Math.min(result, a[i]);
+    }
+    return result;
+  }
+
+  /// CHECK-START-ARM64: int Main.max(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecReduce
+  /// CHECK-DAG: ArrayGet
+  private static int max(int[] a) {
+    int n = a.length;
+    int result = Integer.MIN_VALUE;
+    for (int i = 0; i < n; i++) {
+      result = Math.max(result, a[i]);
+    }
+    return result;
+  }
+
+  //
+  // Loops the vectorizer must reject.
+  //
+
+  // Each iteration reads the element written by the previous one.
+
+  /// CHECK-START: void Main.prefixSum(int[]) loop_optimization (after)
+  /// CHECK-NOT: VecLoad
+  /// CHECK-NOT: VecStore
+  private static void prefixSum(int[] a) {
+    int n = a.length - 1;
+    for (int i = 0; i < n; i++) {
+      a[i + 1] += a[i];
+    }
+  }
+
+  // Each iteration reads an element written by a later one.
+
+  /// CHECK-START: void Main.shiftLeft(int[]) loop_optimization (after)
+  /// CHECK-NOT: VecLoad
+  /// CHECK-NOT: VecStore
+  private static void shiftLeft(int[] a) {
+    int n = a.length - 1;
+    for (int i = 0; i < n; i++) {
+      a[i] = a[i + 1];
+    }
+  }
+
+  // Sums of bytes would overflow the packed lanes.
+
+  /// CHECK-START: int Main.sumBytes(byte[]) loop_optimization (after)
+  /// CHECK-NOT: VecLoad
+  private static int sumBytes(byte[] b) {
+    int n = b.length;
+    int result = 0;
+    for (int i = 0; i < n; i++) {
+      result += b[i];
+    }
+    return result;
+  }
+
+  //
+  // Loops with arbitrary bounds, for the trip counts the vector loop and its
+  // epilogue must agree on with the scalar loop.
+  //
+
+  private static void addRange(int[] a, int lo, int hi, int x) {
+    for (int i = lo; i < hi; i++) {
+      a[i] += x;
+    }
+  }
+
+  private static void addRangeByte(byte[] b, int lo, int hi, int x) {
+    for (int i = lo; i < hi; i++) {
+      b[i] += x;
+    }
+  }
+
+  // Writes `from` into the elements of `to` at the same indices, to call with aliased arrays.
+  private static void copyPlusOne(int[] to, int[] from) {
+    int n = to.length;
+    for (int i = 0; i < n; i++) {
+      to[i] = from[i] + 1;
+    }
+  }
+
+  //
+  // Test drivers.
+  //
+
+  private static int[] iota(int length) {
+    int[] a = new int[length];
+    for (int i = 0; i < length; i++) {
+      a[i] = i;
+    }
+    return a;
+  }
+
+  private static void testTripCounts() {
+    // Every length up to a few vectors, including 0, lengths below one vector, and
+    // lengths which are not a multiple of the vector length.
+    for (int length = 0; length <= 70; length++) {
+      int[] a = iota(length);
+      addInt(a, 3);
+      for (int i = 0; i < length; i++) {
+        expectEquals(i + 3, a[i]);
+      }
+      byte[] b = new byte[length];
+      for (int i = 0; i < length; i++) {
+        b[i] = (byte) (i * 7);
+      }
+      subByte(b, 100);
+      for (int i = 0; i < length; i++) {
+        expectEquals((byte) (i * 7 - 100), b[i]);
+      }
+      char[] c = new char[length];
+      for (int i = 0; i < length; i++) {
+        c[i] = (char) (i * 1000);
+      }
+      xorChar(c, 0x8421);
+      for (int i = 0; i < length; i++) {
+        expectEquals((char) ((i * 1000) ^ 0x8421), c[i]);
+      }
+      short[] s = new short[length];
+      for (int i = 0; i < length; i++) {
+        s[i] = (short) (i - 35);
+      }
+      mulShort(s, 1001);
+      for (int i = 0; i < length; i++) {
+        expectEquals((short) ((i - 35) * 1001), s[i]);
+      }
+    }
+  }
+
+  private static void testRanges() {
+    // Empty, shorter than a vector, not a multiple of the vector length, and lo > hi.
+    int[][] bounds = { {5, 5}, {2, 5}, {0, 1}, {3, 40}, {1, 64}, {0, 64}, {7, 2}, {64, 0} };
+    for (int[] bound : bounds) {
+      int lo = bound[0];
+      int hi = bound[1];
+      int[] a = iota(64);
+      addRange(a, lo, hi, 10);
+      byte[] b = new byte[64];
+      addRangeByte(b, lo, hi, 10);
+      for (int i = 0; i < 64; i++) {
+        boolean inRange = lo <= i && i < hi;
+        expectEquals(inRange ? i + 10 : i, a[i]);
+        expectEquals(inRange ? (byte) 10 : (byte) 0, b[i]);
+      }
+    }
+  }
+
+  private static void testNearOverflowBounds() {
+    // The trip count hi - lo overflows an int, the loop must still write every element
+    // of the array up to the first out of bounds index, and then throw.
+    int[] a = iota(37);
+    try {
+      addRange(a, 0, Integer.MAX_VALUE, 1);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i + 1, a[i]);
+    }
+    // A loop starting at a negative index throws before writing anything.
+    a = iota(37);
+    try {
+      addRange(a, Integer.MIN_VALUE, Integer.MAX_VALUE, 1);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i, a[i]);
+    }
+    // Bounds close to the largest int, where computing the vector bound must not wrap.
+    byte[] b = new byte[16];
+    try {
+      addRangeByte(b, Integer.MAX_VALUE - 3, Integer.MAX_VALUE, 1);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    addRangeByte(b, Integer.MAX_VALUE, Integer.MAX_VALUE, 1);
+    addRangeByte(b, Integer.MAX_VALUE, Integer.MIN_VALUE, 1);
+    for (int i = 0; i < b.length; i++) {
+      expectEquals((byte) 0, b[i]);
+    }
+  }
+
+  private static void testReductions() {
+    for (int length = 0; length <= 70; length++) {
+      int[] a = new int[length];
+      int expectedSum = 0;
+      int expectedMin = Integer.MAX_VALUE;
+      int expectedMax = Integer.MIN_VALUE;
+      for (int i = 0; i < length; i++) {
+        // Mix signs and put the extremes anywhere, including in the epilogue.
+        a[i] = ((i * 37) % 23 - 11) * 1000003;
+        expectedSum += a[i];
+        expectedMin = Math.min(expectedMin, a[i]);
+        expectedMax = Math.max(expectedMax, a[i]);
+      }
+      expectEquals(expectedSum, sum(a));
+      expectEquals(expectedMin, min(a));
+      expectEquals(expectedMax, max(a));
+    }
+    byte[] b = new byte[100];
+    for (int i = 0; i < b.length; i++) {
+      b[i] = (byte) 100;
+    }
+    expectEquals(10000, sumBytes(b));
+  }
+
+  private static void testAliasing() {
+    for (int length = 0; length <= 70; length++) {
+      int[] a = iota(length);
+      prefixSum(a);
+      for (int i = 0; i < length; i++) {
+        expectEquals(i * (i + 1) / 2, a[i]);
+      }
+      a = iota(length);
+      shiftLeft(a);
+      for (int i = 0; i < length - 1; i++) {
+        expectEquals(i + 1, a[i]);
+      }
+      if (length > 0) {
+        expectEquals(length - 1, a[length - 1]);
+      }
+      a = iota(length);
+      copyPlusOne(a, a);
+      for (int i = 0; i < length; i++) {
+        expectEquals(i + 1, a[i]);
+      }
+    }
+  }
+
+  public static void main(String[] args) {
+    testTripCounts();
+    testRanges();
+    testNearOverflowBounds();
+    testReductions();
+    testAliasing();
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
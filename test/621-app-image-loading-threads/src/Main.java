@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (!checkAppImageLoaded()) {
+      System.out.println("App image is not loaded!");
+    } else if (!checkAppImageContains(Gen0.class) ||
+               !checkAppImageContains(Class.forName("Gen" + (GenAll.COUNT - 1)))) {
+      System.out.println("App image does not contain the generated classes!");
+    }
+
+    // Use the relocated methods, fields and interface tables of each class.
+    Shape[] shapes = GenAll.create();
+    if (shapes.length != GenAll.COUNT) {
+      System.out.println("Expected " + GenAll.COUNT + " shapes, got " + shapes.length);
+    }
+    for (int i = 0; i < shapes.length; i++) {
+      Shape shape = shapes[i];
+      if (shape.id() != i) {
+        System.out.println("Wrong id " + shape.id() + " for shape " + i);
+      }
+      if (shape.area() != 2 * i) {
+        System.out.println("Wrong area " + shape.area() + " for shape " + i);
+      }
+      if (!shape.name().equals("Gen" + i)) {
+        System.out.println("Wrong name " + shape.name() + " for shape " + i);
+      }
+      if (shape.getClass().getDeclaredField("instances").getInt(null) != 1) {
+        System.out.println("Wrong instance count for shape " + i);
+      }
+    }
+    System.out.println("Done");
+  }
+
+  public static native boolean checkAppImageLoaded();
+  public static native boolean checkAppImageContains(Class<?> klass);
+}
@@ -564,7 +564,9 @@ endif
 TEST_ART_BROKEN_OPTIMIZING_READ_BARRIER_RUN_TESTS :=
 TEST_ART_BROKEN_JIT_READ_BARRIER_RUN_TESTS :=
 
-TEST_ART_BROKEN_NPIC_RUN_TESTS := 596-app-images
+TEST_ART_BROKEN_NPIC_RUN_TESTS := \
+  596-app-images \
+  621-app-image-loading-threads
 ifneq (,$(filter npictest,$(PICTEST_TYPES)))
   ART_TEST_KNOWN_BROKEN += $(call all-run-test-names,$(TARGET_TYPES),$(RUN_TYPES),$(PREBUILD_TYPES), \
       ${COMPILER_TYPES},$(RELOCATE_TYPES),$(TRACE_TYPES),$(GC_TYPES),$(JNI_TYPES), \
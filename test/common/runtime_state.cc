@@ -149,7 +149,7 @@ extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
       // Sleep to yield to the compiler thread.
       usleep(1000);
       // Will either ensure it's compiled or do the compilation itself.
-      jit->CompileMethod(method, soa.Self(), /* osr */ false);
+      jit->CompileMethod(method, soa.Self(), /* baseline */ false, /* osr */ false);
     }
   }
 }